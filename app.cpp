@@ -1,14 +1,65 @@
 #include "app.h"
+#include "timestamp.h"
 #include <iostream>
 #include <sstream>
+#include <fstream>
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <iomanip>
+#include <numeric>
 #include <print>
 
-App::App() : _running(false) {}
+App::App(AppOptions options) : _running(false), _options(std::move(options)) {}
 
 void App::config() {
     initializeCommands();
+    _task_manager.setWorkerCount(_options.workers);
+    if (!_options.script_path.empty()) {
+        _options.batch = true;
+    }
+    if (!_options.journal_path.empty()) {
+        beginCommand();
+        openJournal();
+        const std::string_view journal_arg = _options.journal_path;
+        endCommand("journal-open", std::span(&journal_arg, 1));
+    }
+    if (!_options.autosave.path.empty()) {
+        _autosave.emplace(_options.autosave);
+    }
+    _shards.setWorkerCount(_options.workers);
+    if (!_options.shard_paths.empty()) {
+        beginCommand();
+        loadShards(_options.shard_paths);
+        std::vector<std::string_view> shard_args(_options.shard_paths.begin(), _options.shard_paths.end());
+        endCommand("shards-load", shard_args);
+    }
+}
+
+void App::openJournal() {
+    const std::string& snapshot_path = _options.journal_path;
+    
+    auto loaded = _task_manager.loadFromBinary(snapshot_path);
+    if (!loaded && loaded.error() != JsonError::FileNotFound) {
+        handleJsonError(loaded.error());
+        _out.print("⚠️ Journal mode disabled: snapshot '{}' could not be loaded\n", snapshot_path);
+        return;
+    }
+    
+    auto journal = TaskJournal::open(snapshot_path + ".wal", _options.journal);
+    if (!journal) {
+        handleJsonError(journal.error());
+        _out.print("⚠️ Journal mode disabled: '{}.wal' could not be opened\n", snapshot_path);
+        return;
+    }
+    
+    auto records = journal->takeRecoveredRecords();
+    size_t applied = _task_manager.replayJournal(records);
+    _journal = std::move(*journal);
+    _task_manager.attachJournal(&*_journal);
+    
+    _out.print("📓 Journal mode: {} task(s) restored, {} journal record(s) replayed\n",
+               _task_manager.getTaskCount(), applied);
 }
 
 void App::initializeCommands() {
@@ -23,10 +74,10 @@ void App::initializeCommands() {
     
     _commands["list"] = Command{
         .name = "list",
-        .description = "List all tasks or by status (list [status])",
+        .description = "List all tasks or by status, optionally created since a date or age (list [status] [--since <date|age>])",
         .handler = [this](const auto& args) { handleList(args); },
         .min_args = 0,
-        .max_args = 1
+        .max_args = 3
     };
     
     _commands["complete"] = Command{
@@ -79,20 +130,44 @@ void App::initializeCommands() {
     
     _commands["find"] = Command{
         .name = "find",
-        .description = "Find tasks by title keyword (find <keyword>)",
+        .description = "Find tasks by words in title or description (find <word> [word...])",
         .handler = [this](const auto& args) { handleFind(args); },
         .min_args = 1,
-        .max_args = 1
+        .max_args = MAX_COMMAND_ARGS
     };
     
     _commands["sort"] = Command{
         .name = "sort",
-        .description = "Sort tasks by criteria (sort <priority|created|title>)",
+        .description = "Sort tasks by criteria (sort <priority|created|title|priority,created> [--limit N] [--offset N])",
         .handler = [this](const auto& args) { handleSort(args); },
         .min_args = 1,
+        .max_args = 5
+    };
+    
+    _commands["stale"] = Command{
+        .name = "stale",
+        .description = "List open tasks not updated for a while (stale <age, e.g. 72h or 3d> [--limit N])",
+        .handler = [this](const auto& args) { handleStale(args); },
+        .min_args = 1,
+        .max_args = 3
+    };
+    
+    _commands["throughput"] = Command{
+        .name = "throughput",
+        .description = "Show completed tasks per day (throughput [days])",
+        .handler = [this](const auto& args) { handleThroughput(args); },
+        .min_args = 0,
         .max_args = 1
     };
     
+    _commands["query"] = Command{
+        .name = "query",
+        .description = "Filter tasks on several fields (query [id=N] [status=S] [priority>=N] [category=C] [text~word] [sort=K] [limit=N] [offset=N])",
+        .handler = [this](const auto& args) { handleQuery(args); },
+        .min_args = 1,
+        .max_args = 16
+    };
+    
     _commands["help"] = Command{
         .name = "help",
         .description = "Show this help message",
@@ -111,26 +186,26 @@ void App::initializeCommands() {
     
     _commands["save"] = Command{
         .name = "save",
-        .description = "Save tasks to JSON file (save [filename])",
+        .description = "Save tasks to JSON, binary snapshot or segment directory (save [--binary | --segments] [filename])",
         .handler = [this](const auto& args) { handleSave(args); },
         .min_args = 0,
-        .max_args = 1
+        .max_args = 2
     };
     
     _commands["load"] = Command{
         .name = "load", 
-        .description = "Load tasks from JSON file (load [filename])",
+        .description = "Load tasks from JSON, binary snapshot or segment directory (load [--binary | --segments] [filename])",
         .handler = [this](const auto& args) { handleLoad(args); },
         .min_args = 0,
-        .max_args = 1
+        .max_args = 2
     };
     
     _commands["view"] = Command{
         .name = "view",
-        .description = "View/print JSON file content (view [filename])",
+        .description = "Stream a JSON file as a table (view [filename] [--limit N] [--offset N] [--columns a,b,...])",
         .handler = [this](const auto& args) { handleView(args); },
         .min_args = 0,
-        .max_args = 1
+        .max_args = 7
     };
     
     _commands["matrix"] = Command{
@@ -156,67 +231,260 @@ void App::initializeCommands() {
         .min_args = 0,
         .max_args = 0
     };
+    
+    _commands["journal"] = Command{
+        .name = "journal",
+        .description = "Show write-ahead journal status (journal)",
+        .handler = [this](const auto& args) { handleJournal(args); },
+        .min_args = 0,
+        .max_args = 0
+    };
+    
+    _commands["compact"] = Command{
+        .name = "compact",
+        .description = "Fold the journal into a new snapshot (compact)",
+        .handler = [this](const auto& args) { handleCompact(args); },
+        .min_args = 0,
+        .max_args = 0
+    };
+    
+    _commands["batch"] = Command{
+        .name = "batch",
+        .description = "Apply updates from a file, or stdin until 'end' (batch [filename])",
+        .handler = [this](const auto& args) { handleBatch(args); },
+        .min_args = 0,
+        .max_args = 1
+    };
+    
+    _commands["perf"] = Command{
+        .name = "perf",
+        .description = "Show hot-path timings, dump them as JSON lines, or reset them (perf [jsonl [filename] | reset])",
+        .handler = [this](const auto& args) { handlePerf(args); },
+        .min_args = 0,
+        .max_args = 2
+    };
+    
+    _commands["autosave"] = Command{
+        .name = "autosave",
+        .description = "Show background autosave status, or save pending changes now (autosave [now])",
+        .handler = [this](const auto& args) { handleAutosave(args); },
+        .min_args = 0,
+        .max_args = 1
+    };
+    
+    _commands["shards"] = Command{
+        .name = "shards",
+        .description = "Work across team files (shards [load <file>... | save | stats | matrix | show <shard:id> | query <terms> | sort <key> [--limit N] [--offset N] | find <keyword>])",
+        .handler = [this](const auto& args) { handleShards(args); },
+        .min_args = 0,
+        .max_args = 16
+    };
 }
 
-void App::run() {
+bool App::run() {
     _running = true;
-    displayWelcome();
+    
+    std::ifstream script;
+    _input = &std::cin;
+    if (!_options.script_path.empty()) {
+        script.open(_options.script_path);
+        if (!script.is_open()) {
+            std::print(stderr, "❌ Cannot open script '{}'\n", _options.script_path);
+            return false;
+        }
+        _input = &script;
+    }
+    
+    // JSON lines output is read by a program: no banner or prompt, but still one
+    // flush per command unless in batch mode
+    const bool prompt = !_options.batch && !jsonLines();
+    if (prompt) {
+        displayWelcome();
+    }
     
     std::string input;
     while (_running) {
-        std::cout << "\n🚀 TaskTracker> ";
-        if (!std::getline(std::cin, input)) {
+        if (!_options.batch) {
+            if (prompt) {
+                _out.write("\n🚀 TaskTracker> ");
+            }
+            _out.flush();  // Everything so far reaches the terminal before blocking on input
+        }
+        if (!std::getline(*_input, input)) {
             // EOF or input error, exit gracefully
             break;
         }
-        
-        if (input.empty()) continue;
-        
-        auto tokens = parseInput(input);
-        if (tokens.empty()) continue;
-        
-        const std::string& command = tokens[0];
-        std::vector<std::string> args(tokens.begin() + 1, tokens.end());
-        
-        // C++23: Validate command using .contains()
-        if (!validateCommand(command)) {
-            std::cout << "❌ Unknown command: " << command << "\n";
-            std::cout << "💡 Type 'help' to see available commands.\n";
-            continue;
-        }
-        
-        const Command& cmd = _commands[command];
-        if (args.size() < cmd.min_args || args.size() > cmd.max_args) {
-            std::print("❌ Invalid number of arguments for '{}'\n", command);
-            std::print("📋 Usage: {}\n", cmd.description);
-            continue;
+        if (!input.empty() && input.back() == '\r') {
+            input.pop_back();  // Scripts written on Windows
         }
-        
-        // C++23: Track recent commands with auto(x) decay copy
-        if (_recent_commands.size() >= MAX_RECENT_COMMANDS) {
-            _recent_commands.erase(_recent_commands.begin());
+        executeLine(input);
+    }
+    if (_autosave) {
+        // Changes made since the last handoff are saved before exiting
+        _autosave->saveNow(_task_manager);
+        _autosave->wait();
+        if (_autosave->status().failures > _autosave_failures) {
+            std::print(stderr, "❌ Final autosave to '{}' failed\n", _autosave->path());
         }
-        _recent_commands.push_back(auto(command));  // Clean copy
-        
-        // C++23: std::expected pattern - commands handle their own errors
+    }
+    _out.flush();
+    _input = &std::cin;
+    return true;
+}
+
+void App::pollAutosave() {
+    _autosave->poll(_task_manager);
+    
+    // A failure is reported once, with the first command that finishes after it
+    auto status = _autosave->status();
+    if (status.failures > _autosave_failures && status.last_error) {
+        _autosave_failures = status.failures;
+        _out.print("⚠️ Autosave to '{}' failed: {}\n", _autosave->path(), jsonErrorToString(*status.last_error));
+        _out.write("💡 It is retried with the next scheduled save; 'save' writes the file directly.\n");
+        addResult("autosave_error", jsonErrorToString(*status.last_error));
+    }
+}
+
+void App::executeLine(std::string_view input) {
+    if (input.empty()) return;
+    
+    auto tokens = _tokenizer.tokenize(input);
+    if (tokens.empty()) return;
+    if (_options.batch && tokens[0].starts_with('#')) return;  // Script comment
+    
+    std::string_view command = tokens[0];
+    auto args = tokens.subspan(1);
+    
+    beginCommand();
+    
+    // C++23: Validate command using .contains()
+    if (!validateCommand(command)) {
+        fail("Unknown command: {}", command);
+        _out.write("💡 Type 'help' to see available commands.\n");
+        endCommand(command, args);
+        return;
+    }
+    
+    const Command& cmd = _commands.find(command)->second;
+    if (args.size() < cmd.min_args || args.size() > cmd.max_args) {
+        fail("Invalid number of arguments for '{}'", command);
+        _out.print("📋 Usage: {}\n", cmd.description);
+        endCommand(command, args);
+        return;
+    }
+    
+    // Overwrite the oldest slot; assign() reuses its capacity
+    _recent_commands[_recent_next].assign(command);
+    _recent_next = (_recent_next + 1) % MAX_RECENT_COMMANDS;
+    _recent_count = std::min(_recent_count + 1, MAX_RECENT_COMMANDS);
+    
+    // C++23: std::expected pattern - commands handle their own errors
+    {
+        PerfScope perf(PerfProbe::Command);
         cmd.handler(args);
     }
+    
+    if (_journal) {
+        if (auto error = _journal->takeError()) {
+            _out.print("⚠️ Journal write failed: {}\n", jsonErrorToString(*error));
+            _out.print("💡 Changes are kept in memory; run 'compact' or 'save' to persist them.\n");
+            addResult("journal_error", jsonErrorToString(*error));
+        }
+    }
+    if (_autosave) {
+        pollAutosave();
+    }
+    
+    endCommand(command, args);
+}
+
+void App::beginCommand() {
+    _error.clear();
+    _result.clear();
+    if (jsonLines()) {
+        _out.beginCapture();
+    }
+}
+
+void App::endCommand(std::string_view command, std::span<const std::string_view> args) {
+    if (!jsonLines()) {
+        return;
+    }
+    const std::string& output = _out.endCapture();
+    
+    std::string record = "{\"command\":\"";
+    appendJsonEscaped(record, command);
+    record += "\",\"args\":[";
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (i > 0) record += ',';
+        record += '"';
+        appendJsonEscaped(record, args[i]);
+        record += '"';
+    }
+    record += "],\"ok\":";
+    record += _error.empty() ? "true" : "false";
+    if (!_error.empty()) {
+        record += ",\"error\":\"";
+        appendJsonEscaped(record, _error);
+        record += '"';
+    }
+    record += ",\"result\":{";
+    record += _result;
+    record += "},\"output\":\"";
+    appendJsonEscaped(record, output);
+    record += "\"}";
+    _out.writeLine(record);
+}
+
+void App::beginResultMember(std::string_view key) const {
+    if (!_result.empty()) {
+        _result += ',';
+    }
+    _result += '"';
+    appendJsonEscaped(_result, key);
+    _result += "\":";
+}
+
+void App::appendTaskJson(const Task& task) const {
+    const auto& metadata = task.getMetadata();
+    std::format_to(std::back_inserter(_result), "{{\"id\":{},\"title\":\"", task.getId());
+    appendJsonEscaped(_result, task.getTitle());
+    _result += "\",\"description\":\"";
+    appendJsonEscaped(_result, task.getDescription());
+    std::format_to(std::back_inserter(_result), "\",\"status\":\"{}\",\"category\":\"", taskStatusToString(task.getStatus()));
+    appendJsonEscaped(_result, metadata.category.view());
+    std::format_to(std::back_inserter(_result), "\",\"priority\":{}}}", metadata.priority);
+}
+
+void App::addResultShardedTasks(std::string_view key, std::span<const ShardedTask> tasks) const {
+    if (!jsonLines()) return;
+    beginResultMember(key);
+    _result += '[';
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (i > 0) _result += ',';
+        _result += "{\"shard\":\"";
+        appendJsonEscaped(_result, _shards.shardName(tasks[i].shard));
+        _result += "\",\"task\":";
+        appendTaskJson(*tasks[i].task);
+        _result += '}';
+    }
+    _result += ']';
 }
 
 void App::displayWelcome() const {
-    std::cout << R"(
+    _out.write(R"(
 ╔══════════════════════════════════════════╗
 ║           🎯 Task Tracker CLI            ║
 ╚══════════════════════════════════════════╝
 
 Welcome to your personal task management system!
 Type 'help' to see available commands.
-)";
+)");
 }
 
 void App::displayHelp() const {
-    std::cout << "\n📋 Available Commands:\n";
-    std::cout << "═══════════════════════\n";
+    _out.write("\n📋 Available Commands:\n");
+    _out.write("═══════════════════════\n");
     
     // Sort commands by name for better presentation
     std::vector<std::pair<std::string, Command>> sorted_commands;
@@ -229,597 +497,1337 @@ void App::displayHelp() const {
     });
     
     for (const auto& [name, cmd] : sorted_commands) {
-        std::print("  📌 {:<15} - {}\n", cmd.name, cmd.description);
+        _out.print("  📌 {:<15} - {}\n", cmd.name, cmd.description);
     }
     
-    std::print("\n💡 Examples:\n");
-    std::print("  add \"Buy groceries\" \"Get milk, bread, and eggs\"\n");
-    std::print("  list pending\n");
-    std::print("  complete 1\n");
-    std::print("  priority 2 5\n");
-    std::print("  category 1 Shopping\n");
-    std::print("  save tasks.json\n");
-    std::print("  load tasks.json\n");
+    _out.print("\n💡 Examples:\n");
+    _out.print("  add \"Buy groceries\" \"Get milk, bread, and eggs\"\n");
+    _out.print("  list pending\n");
+    _out.print("  complete 1\n");
+    _out.print("  priority 2 5\n");
+    _out.print("  category 1 Shopping\n");
+    _out.print("  save tasks.json\n");
+    _out.print("  load tasks.json\n");
 }
 
-void App::handleAdd(const std::vector<std::string>& args) {
-    const std::string& title = args[0];
-    std::string description = args.size() > 1 ? args[1] : "";
+void App::handleAdd(std::span<const std::string_view> args) {
+    std::string_view title = args[0];
+    std::string_view description = args.size() > 1 ? args[1] : "";
     
-    auto result = _task_manager.addTask(title, description);
+    auto result = _task_manager.addTask(std::string(title), std::string(description));
     if (result) {
-        std::print("✅ Task '{}' added successfully with ID = {}\n", title, *result);
+        _out.print("✅ Task '{}' added successfully with ID = {}\n", title, *result);
+        addResult("id", *result);
     } else {
         handleError(result.error());
     }
 }
 
-void App::handleList(const std::vector<std::string>& args) {
-    if (args.empty()) {
-        _task_manager.listTasks();
-    } else {
-        auto status = stringToTaskStatus(args[0]);
-        if (status) {
-            _task_manager.listTasksByStatus(*status);
+void App::handleList(std::span<const std::string_view> args) {
+    std::optional<TaskStatus> status;
+    std::optional<std::chrono::system_clock::time_point> since;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (args[i] == "--since") {
+            if (i + 1 >= args.size() || since) {
+                fail("Usage: list [status] [--since <date|age>]");
+                return;
+            }
+            since = parseSince(args[++i]);
+            if (!since) {
+                fail("Invalid --since value: {}", args[i]);
+                _out.write("📋 Use a date (2026-10-01), a timestamp (2026-10-01T08:00:00Z) or an age (72h, 7d)\n");
+                return;
+            }
+        } else if (!status) {
+            status = stringToTaskStatus(args[i]);
+            if (!status) {
+                fail("Invalid status: {}", args[i]);
+                _out.print("📋 Valid statuses: pending, progress, completed, cancelled\n");
+                return;
+            }
+        } else {
+            fail("Usage: list [status] [--since <date|age>]");
+            return;
+        }
+    }
+    
+    if (!since) {
+        if (!status) {
+            _out.append([this](std::string& out) { _task_manager.listTasks(out); });
+            addResultTasks("tasks", _task_manager.getAllTasks());
         } else {
-            std::print("❌ Invalid status: {}\n", args[0]);
-            std::print("📋 Valid statuses: pending, progress, completed, cancelled\n");
+            _out.append([&](std::string& out) { _task_manager.listTasksByStatus(*status, out); });
+            addResultTasks("tasks", _task_manager.getTasksByStatus(*status));
         }
+        return;
+    }
+    
+    // The time index hands over only the tasks created since then
+    auto tasks = _task_manager.getTasksInTimeRange(TaskTime::Created, since);
+    if (status) {
+        std::erase_if(tasks, [&](const Task* task) { return task->getStatus() != *status; });
+    }
+    addResultTasks("tasks", tasks);
+    
+    const std::string from = timePointToIsoString(*since);
+    if (tasks.empty()) {
+        _out.print("No {}tasks created since {}\n", status ? std::format("{} ", taskStatusToString(*status)) : "", from);
+        return;
+    }
+    _out.print("=== {}Tasks created since {} ({} tasks) ===\n",
+               status ? std::format("{} ", taskStatusToString(*status)) : "", from, tasks.size());
+    for (const Task* task : tasks) {
+        _out.print("[{}] {} - {} (Priority: {}, Created: {})\n",
+                   task->getId(), task->getTitle(), taskStatusToString(task->getStatus()),
+                   task->getMetadata().priority, timePointToIsoString(task->getMetadata().created_at));
     }
 }
 
-void App::handleComplete(const std::vector<std::string>& args) {
+void App::handleComplete(std::span<const std::string_view> args) {
     auto id_result = parseInteger(args[0]);
     if (!id_result) {
-        std::print("❌ {}\n", parseErrorToString(id_result.error()));
+        fail("{}", parseErrorToString(id_result.error()));
         return;
     }
     
     int id = *id_result;
     auto result = _task_manager.updateTaskStatus(id, TaskStatus::Completed);
     if (result) {
-        std::print("✅ Task {} marked as completed!\n", id);
+        _out.print("✅ Task {} marked as completed!\n", id);
+        addResult("id", id);
     } else {
         handleError(result.error());
     }
 }
 
-void App::handleRemove(const std::vector<std::string>& args) {
+void App::handleRemove(std::span<const std::string_view> args) {
     auto id_result = parseInteger(args[0]);
     if (!id_result) {
-        std::print("❌ {}\n", parseErrorToString(id_result.error()));
+        fail("{}", parseErrorToString(id_result.error()));
         return;
     }
     
     int id = *id_result;
     auto result = _task_manager.removeTask(id);
     if (result) {
-        std::cout << std::format("🗑️ Task {} removed successfully!\n", id);
+        _out.print("🗑️ Task {} removed successfully!\n", id);
+        addResult("id", id);
     } else {
         handleError(result.error());
     }
 }
 
-void App::handleStatus(const std::vector<std::string>& args) {
+void App::handleStatus(std::span<const std::string_view> args) {
     auto id_result = parseInteger(args[0]);
     if (!id_result) {
-        std::cout << std::format("❌ {}\n", parseErrorToString(id_result.error()));
+        fail("{}", parseErrorToString(id_result.error()));
         return;
     }
     
     int id = *id_result;
     auto status = stringToTaskStatus(args[1]);
     if (!status) {
-        std::cout << std::format("❌ Invalid status: {}\n", args[1]);
+        fail("Invalid status: {}", args[1]);
         return;
     }
     
     auto result = _task_manager.updateTaskStatus(id, *status);
     if (result) {
-        std::cout << std::format("📝 Task {} status updated to {}\n", id, taskStatusToString(*status));
+        _out.print("📝 Task {} status updated to {}\n", id, taskStatusToString(*status));
+        addResult("id", id);
+        addResult("status", taskStatusToString(*status));
     } else {
         handleError(result.error());
     }
 }
 
-void App::handlePriority(const std::vector<std::string>& args) {
+void App::handlePriority(std::span<const std::string_view> args) {
     auto id_result = parseInteger(args[0]);
     if (!id_result) {
-        std::cout << std::format("❌ {}\n", parseErrorToString(id_result.error()));
+        fail("{}", parseErrorToString(id_result.error()));
         return;
     }
     
     auto priority_result = parseInteger(args[1]);
     if (!priority_result) {
-        std::cout << std::format("❌ {}\n", parseErrorToString(priority_result.error()));
+        fail("{}", parseErrorToString(priority_result.error()));
         return;
     }
     
     int id = *id_result;
     int priority = *priority_result;
     
-    auto task_result = _task_manager.getTask(id);
-    if (!task_result) {
-        handleError(task_result.error());
-        return;
-    }
-    
-    // Get mutable reference to task in manager - no const_cast needed with deducing this
-    auto& tasks = _task_manager.getAllTasks();
-    auto it = std::ranges::find_if(tasks, [id](Task& task) {
-        return task.getId() == id;
-    });
-    
-    if (it != tasks.end()) {
-        auto result = it->setPriority(priority);
-        if (result) {
-            std::cout << std::format("🎯 Task {} priority set to {}\n", id, priority);
-        } else {
-            handleError(result.error());
-        }
+    auto result = _task_manager.updateTaskPriority(id, priority);
+    if (result) {
+        _out.print("🎯 Task {} priority set to {}\n", id, priority);
+        addResult("id", id);
+        addResult("priority", priority);
+    } else {
+        handleError(result.error());
     }
 }
 
-void App::handleCategory(const std::vector<std::string>& args) {
+void App::handleCategory(std::span<const std::string_view> args) {
     auto id_result = parseInteger(args[0]);
     if (!id_result) {
-        std::cout << std::format("❌ {}\n", parseErrorToString(id_result.error()));
+        fail("{}", parseErrorToString(id_result.error()));
         return;
     }
     
     int id = *id_result;
-    const std::string& category = args[1];
-    
-    auto task_result = _task_manager.getTask(id);
-    if (!task_result) {
-        handleError(task_result.error());
-        return;
-    }
-    
-    // Get mutable reference to task in manager - no const_cast needed with deducing this
-    auto& tasks = _task_manager.getAllTasks();
-    auto it = std::ranges::find_if(tasks, [id](Task& task) {
-        return task.getId() == id;
-    });
+    std::string_view category = args[1];
     
-    if (it != tasks.end()) {
-        auto result = it->setCategory(category);
-        if (result) {
-            std::cout << std::format("🏷️ Task {} category set to '{}'\n", id, category);
-        } else {
-            handleError(result.error());
-        }
+    auto result = _task_manager.updateTaskCategory(id, std::string(category));
+    if (result) {
+        _out.print("🏷️ Task {} category set to '{}'\n", id, category);
+        addResult("id", id);
+        addResult("category", category);
+    } else {
+        handleError(result.error());
     }
 }
 
-void App::handleStats(const std::vector<std::string>& args) {
+void App::handleStats(std::span<const std::string_view> args) {
+    // All O(1): TaskManager keeps running per-status counters
     size_t total = _task_manager.getTaskCount();
     size_t completed = _task_manager.getCompletedTasksCount();
     size_t pending = _task_manager.getPendingTasksCount();
-    size_t in_progress = total - completed - pending - std::ranges::count_if(_task_manager.getAllTasks(), 
-                [](const Task& t) { return t.getStatus() == TaskStatus::Cancelled; });
+    size_t in_progress = _task_manager.getTaskCountByStatus(TaskStatus::InProgress);
     double completion_rate = _task_manager.getCompletionRate();
     
-    std::cout << "\n📊 Task Statistics\n";
-    std::cout << "══════════════════\n";
-    std::print("📋 Total Tasks:     {}\n", total);
-    std::print("✅ Completed:       {}\n", completed);
-    std::print("⏳ Pending:         {}\n", pending);
-    std::print("🚧 In Progress:     {}\n", in_progress);
-    std::print("📈 Completion Rate: {:.1f}%\n", completion_rate);
+    _out.write("\n📊 Task Statistics\n");
+    _out.write("══════════════════\n");
+    _out.print("📋 Total Tasks:     {}\n", total);
+    _out.print("✅ Completed:       {}\n", completed);
+    _out.print("⏳ Pending:         {}\n", pending);
+    _out.print("🚧 In Progress:     {}\n", in_progress);
+    _out.print("📈 Completion Rate: {:.1f}%\n", completion_rate);
+    
+    addResult("total", total);
+    addResult("completed", completed);
+    addResult("pending", pending);
+    addResult("in_progress", in_progress);
+    addResult("completion_rate", completion_rate);
 }
 
-void App::handleFind(const std::vector<std::string>& args) {
-    const std::string& keyword = args[0];
+void App::handleFind(std::span<const std::string_view> args) {
+    PerfScope perf(PerfProbe::Find);
+    
+    // Every argument is a term; terms are ANDed by the inverted index
+    std::string keyword(args[0]);
+    for (size_t i = 1; i < args.size(); ++i) {
+        keyword += ' ';
+        keyword += args[i];
+    }
     
-    // C++23: auto(x) decay copy for safer lambda captures
-    auto filterTasks = [keyword = auto(keyword)](const Task& task) {
-        const std::string& title = task.getTitle();
-        const std::string& desc = task.getDescription();
-        
-        // Case-insensitive search
-        auto to_lower = [](std::string str) {
-            std::ranges::transform(str, str.begin(), ::tolower);
-            return str;
-        };
-        
-        std::string lower_keyword = to_lower(keyword);
-        std::string lower_title = to_lower(title);
-        std::string lower_desc = to_lower(desc);
-        
-        return lower_title.contains(lower_keyword) || lower_desc.contains(lower_keyword);
-    };
+    auto matching_ids = _task_manager.findTasks(keyword);
+    addResultTasks("tasks", matching_ids | std::views::transform([this](int id) { return _task_manager.findTask(id); }));
+    
+    if (matching_ids.empty()) {
+        _out.print("🔍 No tasks found containing: '{}'\n", keyword);
+    } else {
+        _out.print("🔍 Found {} task(s) containing '{}'\n", matching_ids.size(), keyword);
+        for (int id : matching_ids) {
+            const Task* task = _task_manager.findTask(id);
+            _out.print("  [{}] {} - {}\n", 
+                        task->getId(), task->getTitle(), taskStatusToString(task->getStatus()));
+        }
+    }
+}
+
+void App::handleQuery(std::span<const std::string_view> args) {
+    auto query = parseTaskQuery(args);
+    if (!query) {
+        fail("{}", query.error());
+        _out.write("📋 Terms: id=N status=S priority=N|>=N|<=N|>N|<N category=C text~word sort=priority|created|title|priority,created limit=N offset=N\n");
+        return;
+    }
+    
+    auto result = runTaskQuery(_task_manager, *query);
+    addResult("offset", result.offset);
+    addResult("total", result.total);
+    addResult("source", querySourceName(result.source));
+    addResult("candidates", result.candidates);
+    addResultTasks("tasks", result.tasks);
+    
+    if (result.total == 0) {
+        _out.print("🔍 No matching tasks (via {}, {} checked)\n", querySourceName(result.source), result.candidates);
+        return;
+    }
+    if (result.tasks.size() == result.total) {
+        _out.print("🔍 {} matching task(s) (via {}, {} checked):\n",
+                    result.total, querySourceName(result.source), result.candidates);
+    } else if (result.tasks.empty()) {
+        _out.print("🔍 No matches at offset {} ({} total)\n", result.offset, result.total);
+        return;
+    } else {
+        _out.print("🔍 Matches [{}-{} of {}] (via {}, {} checked):\n",
+                    result.offset + 1, result.offset + result.tasks.size(), result.total,
+                    querySourceName(result.source), result.candidates);
+    }
+    for (const Task* task : result.tasks) {
+        _out.print("  [{}] {} - {} (Priority: {}, Category: {})\n",
+                    task->getId(), task->getTitle(), taskStatusToString(task->getStatus()),
+                    task->getMetadata().priority, task->getMetadata().category);
+    }
+}
+
+void App::handleSort(std::span<const std::string_view> args) {
+    std::string_view criteria = args[0];
     
-    auto matching_tasks = _task_manager.filterTasks(filterTasks);
+    auto sort_key = stringToTaskSortKey(criteria);
+    if (!sort_key) {
+        fail("Invalid sort criteria: {}", criteria);
+        _out.write("📋 Valid options: priority, created, title, priority,created\n");
+        return;
+    }
     
-    auto task_vector = std::vector<Task>(matching_tasks.begin(), matching_tasks.end());
+    const TaskSortKey key = *sort_key;
+    std::string_view heading;
+    switch (key) {
+        case TaskSortKey::Priority:
+            heading = "📊 Tasks sorted by priority (highest first)";
+            break;
+        case TaskSortKey::Created:
+            heading = "📊 Tasks sorted by creation date (newest first)";
+            break;
+        case TaskSortKey::Title:
+            heading = "📊 Tasks sorted alphabetically";
+            break;
+        case TaskSortKey::PriorityCreated:
+            heading = "📊 Tasks sorted by priority, newest first within a priority";
+            break;
+    }
     
-    if (task_vector.empty()) {
-        std::cout << std::format("🔍 No tasks found containing: '{}'\n", keyword);
+    size_t offset = 0;
+    size_t limit = std::numeric_limits<size_t>::max();
+    for (size_t i = 1; i < args.size(); i += 2) {
+        if ((args[i] != "--limit" && args[i] != "--offset") || i + 1 >= args.size()) {
+            fail("Usage: sort <priority|created|title|priority,created> [--limit N] [--offset N]");
+            return;
+        }
+        auto value = parseInteger(args[i + 1]);
+        if (!value || *value < 0) {
+            fail("Invalid {} value: {}", args[i], args[i + 1]);
+            return;
+        }
+        (args[i] == "--limit" ? limit : offset) = static_cast<size_t>(*value);
+    }
+    
+    auto page = _task_manager.getSortedPage(key, offset, limit);
+    addResult("offset", page.offset);
+    addResult("total", page.total);
+    addResultTasks("tasks", page.tasks);
+    if (page.tasks.size() == page.total) {
+        _out.print("{}:\n", heading);
+    } else if (page.tasks.empty()) {
+        _out.print("{}: no tasks at offset {} ({} total)\n", heading, page.offset, page.total);
+        return;
     } else {
-        std::cout << std::format("🔍 Found {} task(s) containing '{}'\n", task_vector.size(), keyword);
-        for (const auto& task : task_vector) {
-            std::cout << std::format("  [{}] {} - {}\n", 
-                        task.getId(), task.getTitle(), taskStatusToString(task.getStatus()));
+        _out.print("{} [{}-{} of {}]:\n", heading,
+                                 page.offset + 1, page.offset + page.tasks.size(), page.total);
+    }
+    
+    for (const Task* task : page.tasks) {
+        switch (key) {
+            case TaskSortKey::Priority:
+                _out.print("  [{}] {} - Priority: {}\n",
+                            task->getId(), task->getTitle(), task->getMetadata().priority);
+                break;
+            case TaskSortKey::Created:
+                _out.print("  [{}] {} - Age: {:.1f} hours\n",
+                            task->getId(), task->getTitle(), task->getAge().count() / 3600.0);
+                break;
+            case TaskSortKey::Title:
+                _out.print("  [{}] {}\n", task->getId(), task->getTitle());
+                break;
+            case TaskSortKey::PriorityCreated:
+                _out.print("  [{}] {} - Priority: {}, Age: {:.1f} hours\n",
+                            task->getId(), task->getTitle(), task->getMetadata().priority,
+                            task->getAge().count() / 3600.0);
+                break;
         }
     }
 }
 
-void App::handleSort(const std::vector<std::string>& args) {
-    const std::string& criteria = args[0];
-    
-    if (criteria == "priority") {
-        auto sorted = _task_manager.getSortedTasks([](const Task& a, const Task& b) {
-            return a.getMetadata().priority > b.getMetadata().priority; // High priority first
-        });
-        
-        std::cout << "📊 Tasks sorted by priority (highest first):\n";
-        for (const auto& task : sorted) {
-            std::cout << std::format("  [{}] {} - Priority: {}\n", 
-                        task.getId(), task.getTitle(), task.getMetadata().priority);
+void App::handleStale(std::span<const std::string_view> args) {
+    auto age = parseDuration(args[0]);
+    if (!age) {
+        fail("Invalid age: {}", args[0]);
+        _out.write("📋 Use a number and a unit: s, m, h, d or w (e.g. 72h, 3d)\n");
+        return;
+    }
+    size_t limit = std::numeric_limits<size_t>::max();
+    if (args.size() > 1) {
+        if (args.size() != 3 || args[1] != "--limit") {
+            fail("Usage: stale <age> [--limit N]");
+            return;
+        }
+        auto value = parseInteger(args[2]);
+        if (!value || *value < 0) {
+            fail("Invalid --limit value: {}", args[2]);
+            return;
         }
+        limit = static_cast<size_t>(*value);
     }
-    else if (criteria == "created") {
-        auto sorted = _task_manager.getSortedTasks([](const Task& a, const Task& b) {
-            return a.getMetadata().created_at > b.getMetadata().created_at; // Newest first
-        });
-        
-        std::cout << "📊 Tasks sorted by creation date (newest first):\n";
-        for (const auto& task : sorted) {
-            std::cout << std::format("  [{}] {} - Age: {:.1f} hours\n", 
-                        task.getId(), task.getTitle(), task.getAge().count() / 3600.0);
+    
+    // Open tasks are indexed by updated_at on their own, so done ones are never visited
+    const auto now = std::chrono::system_clock::now();
+    const auto cutoff = now - *age;
+    auto tasks = _task_manager.getTasksInTimeRange(TaskTime::OpenUpdated, std::nullopt, cutoff, limit);
+    const size_t total = tasks.size() < limit ? tasks.size()
+                                              : _task_manager.countTasksInTimeRange(TaskTime::OpenUpdated, std::nullopt, cutoff);
+    addResult("total", total);
+    addResultTasks("tasks", tasks);
+    
+    if (total == 0) {
+        _out.print("✨ No open tasks idle for {} or longer\n", args[0]);
+        return;
+    }
+    if (tasks.size() == total) {
+        _out.print("🕸️ Open tasks idle for {} or longer ({} tasks):\n", args[0], total);
+    } else {
+        _out.print("🕸️ Open tasks idle for {} or longer [1-{} of {}]:\n", args[0], tasks.size(), total);
+    }
+    for (const Task* task : tasks) {
+        const std::chrono::duration<double, std::ratio<3600>> idle = now - task->getMetadata().updated_at;
+        _out.print("  [{}] {} - {}, idle {:.1f} hours\n",
+                   task->getId(), task->getTitle(), taskStatusToString(task->getStatus()), idle.count());
+    }
+}
+
+void App::handleThroughput(std::span<const std::string_view> args) {
+    constexpr int MAX_DAYS = 3660;
+    int days = 7;
+    if (!args.empty()) {
+        auto value = parseInteger(args[0]);
+        if (!value || *value < 1 || *value > MAX_DAYS) {
+            fail("Invalid number of days: {} (1-{})", args[0], MAX_DAYS);
+            return;
         }
+        days = *value;
     }
-    else if (criteria == "title") {
-        auto sorted = _task_manager.getSortedTasks([](const Task& a, const Task& b) {
-            return a.getTitle() < b.getTitle(); // Alphabetical
-        });
-        
-        std::cout << "📊 Tasks sorted alphabetically:\n";
-        for (const auto& task : sorted) {
-            std::cout << std::format("  [{}] {}\n", task.getId(), task.getTitle());
+    
+    // UTC days, the last one being today
+    const auto today = std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now());
+    const auto first_day = today - std::chrono::days(days - 1);
+    auto counts = _task_manager.countTasksPerDay(TaskTime::Completed, first_day, static_cast<size_t>(days));
+    
+    const size_t total = std::accumulate(counts.begin(), counts.end(), 0uz);
+    const size_t busiest = *std::ranges::max_element(counts);
+    addResult("days", days);
+    addResult("completed", total);
+    if (jsonLines()) {
+        beginResultMember("per_day");
+        _result += '[';
+        for (size_t i = 0; i < counts.size(); ++i) {
+            if (i > 0) _result += ',';
+            std::format_to(std::back_inserter(_result), "{}", counts[i]);
         }
+        _result += ']';
     }
-    else {
-        std::cout << std::format("❌ Invalid sort criteria: {}\n", criteria);
-        std::cout << "📋 Valid options: priority, created, title\n";
+    
+    _out.print("\n📈 Completed Tasks per Day (last {} day(s), UTC)\n", days);
+    _out.write("════════════════════════════════════════════\n");
+    constexpr size_t BAR_WIDTH = 30;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        const std::chrono::year_month_day date{first_day + std::chrono::days(i)};
+        const size_t bar = busiest == 0 ? 0 : (counts[i] * BAR_WIDTH + busiest - 1) / busiest;
+        std::string bars;
+        for (size_t b = 0; b < bar; ++b) bars += "█";
+        _out.print("{:%Y-%m-%d} {:>6} {}\n", date, counts[i], bars);
     }
+    _out.print("📊 Total: {} completed, {:.1f} per day\n", total, static_cast<double>(total) / days);
 }
 
-void App::handleExit(const std::vector<std::string>& args) {
-    std::cout << "\n👋 Thank you for using Task Tracker! Have a productive day!\n";
+void App::handleExit(std::span<const std::string_view> args) {
+    _out.write("\n👋 Thank you for using Task Tracker! Have a productive day!\n");
     _running = false;
 }
 
 void App::handleJsonError(JsonError error) const {
-    std::cout << std::format("❌ JSON Error: {}\n", jsonErrorToString(error));
+    fail("JSON Error: {}", jsonErrorToString(error));
 }
 
-void App::handleSave(const std::vector<std::string>& args) {
-    std::string filename = args.empty() ? "tasks.json" : args[0];
-    
-    std::cout << std::format("💾 Saving tasks to {}...\n", filename);
+void App::handleSave(std::span<const std::string_view> args) {
+    bool binary = !args.empty() && args[0] == "--binary";
+    bool segments = !args.empty() && args[0] == "--segments";
+    size_t file_arg = binary || segments ? 1 : 0;
+    std::string filename(args.size() > file_arg ? args[file_arg]
+                         : (binary ? "tasks.bin" : segments ? "tasks.segments" : "tasks.json"));
+    
+    _out.print("💾 Saving tasks to {}...\n", filename);
+    
+    if (segments) {
+        auto stats = _task_manager.saveToSegments(filename);
+        if (!stats) {
+            handleJsonError(stats.error());
+            _out.write("💡 Make sure the directory can be created and you have write permissions.\n");
+            return;
+        }
+        _out.print("✅ Tasks saved successfully to {}\n", filename);
+        _out.print("📊 Total tasks saved: {} ({} of {} segment(s) rewritten, {} removed)\n",
+                    _task_manager.getTaskCount(), stats->written, stats->segments, stats->removed);
+        addResult("file", filename);
+        addResult("count", _task_manager.getTaskCount());
+        addResult("segments_written", stats->written);
+        addResult("segments_removed", stats->removed);
+        addResult("segments", stats->segments);
+        return;
+    }
     
-    auto result = _task_manager.saveToJson(filename);
+    auto result = binary ? _task_manager.saveToBinary(filename) : _task_manager.saveToJson(filename);
     if (result) {
-        std::cout << std::format("✅ Tasks saved successfully to {}\n", filename);
-        std::cout << std::format("📊 Total tasks saved: {}\n", _task_manager.getTaskCount());
+        _out.print("✅ Tasks saved successfully to {}\n", filename);
+        _out.print("📊 Total tasks saved: {}\n", _task_manager.getTaskCount());
+        addResult("file", filename);
+        addResult("count", _task_manager.getTaskCount());
     } else {
         handleJsonError(result.error());
-        std::cout << "💡 Make sure the directory exists and you have write permissions.\n";
+        _out.write("💡 Make sure the directory exists and you have write permissions.\n");
     }
 }
 
-void App::handleLoad(const std::vector<std::string>& args) {
-    std::string filename = args.empty() ? "tasks.json" : args[0];
-    
-    std::cout << std::format("📂 Loading tasks from {}...\n", filename);
-    
-    auto result = _task_manager.loadFromJson(filename);
+void App::handleLoad(std::span<const std::string_view> args) {
+    bool binary = !args.empty() && args[0] == "--binary";
+    bool segments = !args.empty() && args[0] == "--segments";
+    size_t file_arg = binary || segments ? 1 : 0;
+    std::string filename(args.size() > file_arg ? args[file_arg]
+                         : (binary ? "tasks.bin" : segments ? "tasks.segments" : "tasks.json"));
+    
+    _out.print("📂 Loading tasks from {}...\n", filename);
+    
+    auto result = binary     ? _task_manager.loadFromBinary(filename)
+                : segments   ? _task_manager.loadFromSegments(filename)
+                             : _task_manager.loadFromJson(filename);
     if (result) {
-        std::cout << std::format("✅ Tasks loaded successfully from {}\n", filename);
-        std::cout << std::format("📊 Total tasks loaded: {}\n", _task_manager.getTaskCount());
+        _out.print("✅ Tasks loaded successfully from {}\n", filename);
+        _out.print("📊 Total tasks loaded: {}\n", _task_manager.getTaskCount());
+        addResult("file", filename);
+        addResult("count", _task_manager.getTaskCount());
+        
+        // The journal no longer describes the loaded tasks; start a fresh one
+        if (_journal) {
+            if (auto compacted = _task_manager.compactJournal(_options.journal_path); compacted) {
+                _out.print("📓 Journal restarted from a new snapshot in {}\n", _options.journal_path);
+            } else {
+                handleJsonError(compacted.error());
+            }
+        }
         
         // Suggest using stats command for more details
         if (_task_manager.getTaskCount() > 0) {
-            std::cout << "� Use 'stats' command to view detailed task statistics\n";
+            _out.write("� Use 'stats' command to view detailed task statistics\n");
         }
     } else {
         handleJsonError(result.error());
+        if (auto offset = _task_manager.getLastJsonErrorOffset()) {
+            _out.print("📍 Parsing stopped at byte {}\n", *offset);
+            addResult("error_offset", *offset);
+        }
         if (result.error() == JsonError::FileNotFound) {
-            std::cout << std::format("💡 File '{}' not found. Use 'save' command to create it.\n", filename);
+            _out.print("💡 File '{}' not found. Use 'save' command to create it.\n", filename);
         } else {
-            std::cout << "💡 Make sure the file exists and contains valid JSON.\n";
+            _out.write(binary   ? "💡 Make sure the file is a snapshot written by 'save --binary'.\n"
+                     : segments ? "💡 Make sure the directory was written by 'save --segments'.\n"
+                                : "💡 Make sure the file exists and contains valid JSON.\n");
         }
     }
 }
 
-std::expected<std::string, JsonError> App::readFileContent(const std::string& filename) const {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return std::unexpected(JsonError::FileNotFound);
+void App::handleJournal(std::span<const std::string_view> args) {
+    if (!_journal) {
+        _out.write("📓 Journal mode is off.\n");
+        _out.write("💡 Start with 'TaskTracker --journal <snapshot>' to enable it.\n");
+        return;
     }
     
-    std::ostringstream buffer;
-    buffer << file.rdbuf();
-    
-    if (file.fail() && !file.eof()) {
-        return std::unexpected(JsonError::ParseError);
+    _out.write("\n📓 Journal Status\n");
+    _out.write("═════════════════\n");
+    _out.print("🗂️ Snapshot:        {}\n", _options.journal_path);
+    _out.print("📝 Journal file:    {}\n", _journal->path());
+    _out.print("🔒 Fsync policy:    {}\n", fsyncPolicyToString(_journal->options().fsync));
+    _out.print("🧾 Records:         {}\n", _journal->recordCount());
+    _out.print("📏 Size:            {} bytes\n", _journal->sizeBytes());
+    addResult("records", _journal->recordCount());
+    addResult("size_bytes", _journal->sizeBytes());
+}
+
+void App::handleCompact(std::span<const std::string_view> args) {
+    if (!_journal) {
+        fail("Journal mode is off; nothing to compact.");
+        _out.write("💡 Start with 'TaskTracker --journal <snapshot>' to enable it.\n");
+        return;
     }
     
-    return buffer.str();
+    size_t records = _journal->recordCount();
+    auto result = _task_manager.compactJournal(_options.journal_path);
+    if (result) {
+        _out.print("✅ Folded {} journal record(s) into {}\n", records, _options.journal_path);
+        _out.print("📊 Total tasks in snapshot: {}\n", _task_manager.getTaskCount());
+        addResult("records", records);
+        addResult("count", _task_manager.getTaskCount());
+    } else {
+        handleJsonError(result.error());
+        _out.write("💡 The journal was kept; no changes were lost.\n");
+    }
 }
 
-void App::handleView(const std::vector<std::string>& args) {
-    std::string filename = args.empty() ? "tasks.json" : args[0];
+namespace {
+
+/**
+ * @brief Latency with a unit that keeps three significant digits
+ */
+std::string formatNanoseconds(uint64_t ns) {
+    if (ns < 1'000) return std::format("{} ns", ns);
+    if (ns < 1'000'000) return std::format("{:.1f} µs", ns / 1e3);
+    if (ns < 1'000'000'000) return std::format("{:.1f} ms", ns / 1e6);
+    return std::format("{:.2f} s", ns / 1e9);
+}
+
+} // namespace
+
+void App::handlePerf(std::span<const std::string_view> args) {
+    if constexpr (!PERF_ENABLED) {
+        fail("Instrumentation is not compiled in.");
+        _out.write("💡 Rebuild with 'cmake -DTASKTRACKER_PERF=ON' to enable the perf command.\n");
+        return;
+    }
     
-    std::cout << std::format("👁️ Viewing JSON file: {}...\n", filename);
+    if (!args.empty() && args[0] == "reset") {
+        if (args.size() > 1) {
+            fail("Usage: perf [jsonl [filename] | reset]");
+            return;
+        }
+        resetPerf();
+        _out.write("🧹 Performance counters reset\n");
+        return;
+    }
+    if (!args.empty() && args[0] != "jsonl") {
+        fail("Invalid perf option: {}", args[0]);
+        _out.write("📋 Valid options: jsonl [filename], reset\n");
+        return;
+    }
     
-    // Use std::expected for file reading
-    auto content_result = readFileContent(filename);
-    if (!content_result) {
-        handleJsonError(content_result.error());
-        std::cout << "💡 Make sure the file exists and is readable.\n";
+    // The running 'perf' command itself is not in the snapshot yet
+    auto summaries = perfSnapshot();
+    addResult("probes", summaries.size());
+    if (jsonLines()) {
+        beginResultMember("counters");
+        _result += '[';
+        for (size_t i = 0; i < summaries.size(); ++i) {
+            if (i > 0) _result += ',';
+            appendPerfJson(_result, summaries[i]);
+        }
+        _result += ']';
+    }
+    
+    if (!args.empty()) {
+        // One object per line for a metrics pipeline; a file is appended to
+        std::string lines;
+        for (const auto& summary : summaries) {
+            appendPerfJson(lines, summary);
+            lines += '\n';
+        }
+        if (args.size() < 2) {
+            _out.write(lines);
+            return;
+        }
+        std::ofstream file(std::string(args[1]), std::ios::binary | std::ios::app);
+        if (!file.write(lines.data(), static_cast<std::streamsize>(lines.size()))) {
+            handleJsonError(JsonError::WriteError);
+            return;
+        }
+        _out.print("✅ Appended {} probe record(s) to {}\n", summaries.size(), args[1]);
+        addResult("file", args[1]);
         return;
     }
     
-    std::string json_content = *content_result;
+    if (summaries.empty()) {
+        _out.write("📝 No instrumented code has run yet.\n");
+        return;
+    }
     
-    if (json_content.empty()) {
-        std::cout << "⚠️ Note: File is empty\n";
+    _out.write("\n⏱️ Performance Counters\n");
+    _out.write("═══════════════════════\n");
+    _out.print("{:<16}{:>8}{:>11}{:>11}{:>11}{:>11}{:>13}{:>10}\n",
+               "Probe", "Calls", "p50", "p99", "Max", "Total", "Bytes", "Allocs");
+    for (const auto& summary : summaries) {
+        _out.print("{:<16}{:>8}{:>11}{:>11}{:>11}{:>11}{:>13}{:>10}\n",
+                   perfProbeName(summary.probe), summary.calls,
+                   formatNanoseconds(summary.p50_ns), formatNanoseconds(summary.p99_ns),
+                   formatNanoseconds(summary.max_ns), formatNanoseconds(summary.total_ns),
+                   summary.bytes, summary.allocs);
+    }
+    _out.write("💡 Percentiles are histogram estimates (±6%); allocations count the calling thread only.\n");
+}
+
+void App::handleAutosave(std::span<const std::string_view> args) {
+    if (!_autosave) {
+        fail("Autosave is off.");
+        _out.write("💡 Start with 'TaskTracker --autosave <file>' to enable it.\n");
+        return;
+    }
+    if (!args.empty() && args[0] != "now") {
+        fail("Invalid autosave option: {}", args[0]);
+        _out.write("📋 Valid options: now\n");
         return;
     }
     
-    // Parse and display in table format
-    displayJsonAsTable(json_content);
+    if (!args.empty()) {
+        bool handed_off = _autosave->saveNow(_task_manager);
+        _autosave->wait();
+        auto status = _autosave->status();
+        if (handed_off && status.last_error) {
+            _autosave_failures = status.failures;
+            handleJsonError(*status.last_error);
+            return;
+        }
+        _out.print(handed_off ? "✅ Autosaved to {}\n" : "✅ {} is already up to date\n", _autosave->path());
+        addResult("saved", handed_off);
+        addResult("file", _autosave->path());
+        return;
+    }
+    
+    auto status = _autosave->status();
+    const std::uint64_t unsaved = _task_manager.getChangeEpoch() - status.saved_epoch;
+    _out.write("\n💾 Autosave Status\n");
+    _out.write("══════════════════\n");
+    _out.print("🗂️ File:            {}\n", _autosave->path());
+    _out.print("⏲️ Schedule:        every {} change(s) or {} s\n", _options.autosave.changes,
+               _options.autosave.interval.count());
+    _out.print("✅ Saves:           {}\n", status.saves);
+    _out.print("❌ Failures:        {}\n", status.failures);
+    _out.print("📝 Unsaved changes: {}{}\n", unsaved, status.writing ? " (saving...)" : "");
+    _out.print("📏 Last file size:  {} bytes\n", status.last_bytes);
+    _out.print("⏱️ Last snapshot:   {} (interactive thread)\n",
+               formatNanoseconds(static_cast<uint64_t>(status.last_handoff.count())));
+    _out.print("⏱️ Last write:      {} (background)\n",
+               formatNanoseconds(static_cast<uint64_t>(status.last_write.count())));
+    if (status.last_error) {
+        _out.print("⚠️ Last error:      {}\n", jsonErrorToString(*status.last_error));
+        addResult("last_error", jsonErrorToString(*status.last_error));
+    }
+    addResult("saves", status.saves);
+    addResult("failures", status.failures);
+    addResult("unsaved_changes", unsaved);
+    addResult("last_bytes", status.last_bytes);
 }
 
-void App::displayJsonAsTable(const std::string& json_content) {
-    // Simple parsing to extract basic info
-    auto findValue = [&json_content](const std::string& key) -> std::string {
-        std::string search_key = "\"" + key + "\":";
-        size_t pos = json_content.find(search_key);
-        if (pos == std::string::npos) return "";
-        
-        pos += search_key.length();
-        while (pos < json_content.length() && std::isspace(json_content[pos])) ++pos;
+void App::loadShards(std::span<const std::string> paths) {
+    auto results = _shards.loadFiles(paths);
+    size_t loaded = 0;
+    for (const ShardLoadResult& result : results) {
+        if (!result.result) {
+            handleJsonError(result.result.error());
+            _out.print("⚠️ '{}' not loaded as shard '{}' (unreadable, or the name is taken within this load)\n",
+                       result.path, result.name);
+            continue;
+        }
+        ++loaded;
+        _out.print("📂 Shard '{}': {} task(s) from {}\n", result.name, result.tasks, result.path);
+    }
+    addResult("loaded", loaded);
+    addResult("shards", _shards.shardCount());
+    addResult("total", _shards.getTaskCount());
+}
+
+void App::handleShards(std::span<const std::string_view> args) {
+    const std::string_view action = args.empty() ? std::string_view("list") : args[0];
+    const auto rest = args.empty() ? args : args.subspan(1);
+    
+    auto printTasks = [this](std::span<const ShardedTask> tasks) {
+        for (const ShardedTask& entry : tasks) {
+            const Task& task = *entry.task;
+            _out.print("  [{}:{}] {} - {} (Priority: {}, Category: {})\n",
+                       _shards.shardName(entry.shard), task.getId(), task.getTitle(),
+                       taskStatusToString(task.getStatus()), task.getMetadata().priority,
+                       task.getMetadata().category);
+        }
+    };
+    
+    if (action == "load") {
+        if (rest.empty()) {
+            fail("Usage: shards load <file>...");
+            return;
+        }
+        std::vector<std::string> paths(rest.begin(), rest.end());
+        loadShards(paths);
+        return;
+    }
+    
+    if (_shards.shardCount() == 0) {
+        if (action == "list") {
+            _out.write("📭 No shards loaded\n");
+            _out.write("💡 Use 'shards load <file>...' or start with 'TaskTracker --shard <file>'.\n");
+            addResult("shards", 0uz);
+            return;
+        }
+        fail("No shards loaded.");
+        _out.write("💡 Use 'shards load <file>...' first.\n");
+        return;
+    }
+    
+    if (action == "list") {
+        _out.print("🗂️ Shards ({}, {} tasks):\n", _shards.shardCount(), _shards.getTaskCount());
+        for (size_t i = 0; i < _shards.shardCount(); ++i) {
+            _out.print("  {:<16} {:>8} task(s)  {}\n", _shards.shardName(i), _shards.shard(i).getTaskCount(),
+                       _shards.shardPath(i));
+        }
+        if (jsonLines()) {
+            beginResultMember("shards");
+            _result += '[';
+            for (size_t i = 0; i < _shards.shardCount(); ++i) {
+                if (i > 0) _result += ',';
+                _result += "{\"name\":\"";
+                appendJsonEscaped(_result, _shards.shardName(i));
+                _result += "\",\"path\":\"";
+                appendJsonEscaped(_result, _shards.shardPath(i));
+                std::format_to(std::back_inserter(_result), "\",\"tasks\":{}}}", _shards.shard(i).getTaskCount());
+            }
+            _result += ']';
+        }
+    } else if (action == "save") {
+        auto results = _shards.saveAll();
+        size_t saved = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (!results[i]) {
+                handleJsonError(results[i].error());
+                _out.print("⚠️ Shard '{}' not saved to {}\n", _shards.shardName(i), _shards.shardPath(i));
+                continue;
+            }
+            ++saved;
+        }
+        _out.print("💾 Saved {} of {} shard(s)\n", saved, results.size());
+        addResult("saved", saved);
+    } else if (action == "stats") {
+        // O(shards): every shard's counters are maintained live
+        const StatusCounters counters = _shards.getCounters();
+        const size_t total = _shards.getTaskCount();
+        auto count = [&](TaskStatus status) { return counters.by_status[static_cast<size_t>(status)]; };
+        const double completion_rate = total == 0 ? 0.0
+                                                  : static_cast<double>(count(TaskStatus::Completed)) / total * 100.0;
         
-        if (pos >= json_content.length()) return "";
+        _out.print("\n📊 Task Statistics ({} shards)\n", _shards.shardCount());
+        _out.write("══════════════════\n");
+        _out.print("📋 Total Tasks:     {}\n", total);
+        _out.print("✅ Completed:       {}\n", count(TaskStatus::Completed));
+        _out.print("⏳ Pending:         {}\n", count(TaskStatus::Pending));
+        _out.print("🚧 In Progress:     {}\n", count(TaskStatus::InProgress));
+        _out.print("📈 Completion Rate: {:.1f}%\n", completion_rate);
+        for (size_t i = 0; i < _shards.shardCount(); ++i) {
+            const TaskManager& shard = _shards.shard(i);
+            _out.print("  {:<16} {:>8} task(s), {:.1f}% completed\n",
+                       _shards.shardName(i), shard.getTaskCount(), shard.getCompletionRate());
+        }
         
-        if (json_content[pos] == '"') {
-            ++pos;
-            size_t end_pos = pos;
-            while (end_pos < json_content.length() && json_content[end_pos] != '"') {
-                if (json_content[end_pos] == '\\') ++end_pos;
-                ++end_pos;
+        addResult("total", total);
+        addResult("completed", count(TaskStatus::Completed));
+        addResult("pending", count(TaskStatus::Pending));
+        addResult("in_progress", count(TaskStatus::InProgress));
+        addResult("completion_rate", completion_rate);
+    } else if (action == "matrix") {
+        // Counts, not ids: ids only mean something within their own shard
+        auto categories = _shards.getCategoryCounts();
+        if (categories.empty()) {
+            _out.print("📭 No tasks to display in matrix\n");
+            return;
+        }
+        _out.print("\n📊 Category x Priority ({} shards)\n", _shards.shardCount());
+        _out.print("{:<16}", "Category");
+        for (size_t p = 0; p < StatusCounters::PRIORITY_LEVELS; ++p) {
+            _out.print(" {:>5}", p);
+        }
+        _out.print(" {:>7}\n", "Total");
+        size_t total = 0;
+        for (const CategoryCounts& counts : categories) {
+            _out.print("{:<16}", counts.category);
+            for (size_t count : counts.by_priority) {
+                _out.print(" {:>5}", count);
             }
-            return unescapeJsonString(json_content.substr(pos, end_pos - pos));
+            _out.print(" {:>7}\n", counts.total);
+            total += counts.total;
+        }
+        _out.print("\n📈 Matrix Statistics:\n");
+        _out.print("  📊 Total tasks: {}\n", total);
+        _out.print("  📂 Categories: {}\n", categories.size());
+        addResult("total", total);
+        addResult("categories", categories.size());
+    } else if (action == "show") {
+        auto id = rest.size() == 1 ? parseShardedTaskId(rest[0]) : std::nullopt;
+        if (!id) {
+            fail("Usage: shards show <shard:id>");
+            return;
+        }
+        auto found = _shards.findTask(*id);
+        if (!found) {
+            fail("Task {} not found", rest[0]);
+            return;
+        }
+        const ShardedTask entry = *found;
+        addResultShardedTasks("tasks", std::span(&entry, 1));
+        printTasks(std::span(&entry, 1));
+        if (!entry.task->getDescription().empty()) {
+            _out.print("    {}\n", entry.task->getDescription());
+        }
+    } else if (action == "query" || action == "sort") {
+        std::expected<TaskQuery, std::string> query;
+        if (action == "query") {
+            query = parseTaskQuery(rest);
         } else {
-            size_t end_pos = pos;
-            while (end_pos < json_content.length() && 
-                   json_content[end_pos] != ',' && 
-                   json_content[end_pos] != '}' && 
-                   json_content[end_pos] != '\n' &&
-                   json_content[end_pos] != '\r') {
-                ++end_pos;
+            // 'sort <key> [--limit N] [--offset N]' is a query that matches everything
+            query = TaskQuery{};
+            if (rest.empty() || !(query->sort = stringToTaskSortKey(rest[0]))) {
+                fail("Usage: shards sort <priority|created|title|priority,created> [--limit N] [--offset N]");
+                return;
+            }
+            for (size_t i = 1; i < rest.size(); i += 2) {
+                if ((rest[i] != "--limit" && rest[i] != "--offset") || i + 1 >= rest.size()) {
+                    fail("Usage: shards sort <priority|created|title|priority,created> [--limit N] [--offset N]");
+                    return;
+                }
+                auto value = parseInteger(rest[i + 1]);
+                if (!value || *value < 0) {
+                    fail("Invalid {} value: {}", rest[i], rest[i + 1]);
+                    return;
+                }
+                (rest[i] == "--limit" ? query->limit : query->offset) = static_cast<size_t>(*value);
             }
-            std::string value = json_content.substr(pos, end_pos - pos);
-            value.erase(0, value.find_first_not_of(" \t\n\r"));
-            value.erase(value.find_last_not_of(" \t\n\r") + 1);
-            return value;
         }
-    };
+        if (!query) {
+            fail("{}", query.error());
+            _out.write("📋 Terms: id=N status=S priority=N|>=N|<=N|>N|<N category=C text~word sort=priority|created|title|priority,created limit=N offset=N\n");
+            return;
+        }
+        
+        // Unfiltered sorts are served from each shard's sort cache
+        const bool plain_sort = action == "sort";
+        ShardedPage page = plain_sort ? _shards.getSortedPage(*query->sort, query->offset, query->limit)
+                                      : _shards.runQuery(*query);
+        addResult("offset", page.offset);
+        addResult("total", page.total);
+        if (!plain_sort) {
+            addResult("candidates", page.candidates);
+        }
+        addResultShardedTasks("tasks", page.tasks);
+        
+        if (page.total == 0) {
+            _out.print("🔍 No matching tasks in {} shard(s)\n", _shards.shardCount());
+            return;
+        }
+        if (page.tasks.size() == page.total) {
+            _out.print("🔍 {} task(s) across {} shard(s):\n", page.total, _shards.shardCount());
+        } else if (page.tasks.empty()) {
+            _out.print("🔍 No tasks at offset {} ({} total)\n", page.offset, page.total);
+            return;
+        } else {
+            _out.print("🔍 Tasks [{}-{} of {}] across {} shard(s):\n",
+                       page.offset + 1, page.offset + page.tasks.size(), page.total, _shards.shardCount());
+        }
+        printTasks(page.tasks);
+    } else if (action == "find") {
+        if (rest.empty()) {
+            fail("Usage: shards find <keyword>");
+            return;
+        }
+        std::string keyword(rest[0]);
+        for (size_t i = 1; i < rest.size(); ++i) {
+            keyword += ' ';
+            keyword += rest[i];
+        }
+        auto matches = _shards.findTasks(keyword);
+        addResultShardedTasks("tasks", matches);
+        if (matches.empty()) {
+            _out.print("🔍 No tasks found containing: '{}'\n", keyword);
+            return;
+        }
+        _out.print("🔍 Found {} task(s) containing '{}' across {} shard(s)\n",
+                   matches.size(), keyword, _shards.shardCount());
+        printTasks(matches);
+    } else {
+        fail("Invalid shards option: {}", action);
+        _out.write("📋 Valid options: list, load, save, stats, matrix, show, query, sort, find\n");
+    }
+}
+
+std::expected<TaskUpdate, std::string> App::parseBatchLine(std::span<const std::string_view> tokens) const {
+    std::string_view command = tokens[0];
+    if (tokens.size() < 2) {
+        return std::unexpected(std::format("'{}' needs a task id", command));
+    }
+    auto id = parseInteger(tokens[1]);
+    if (!id) {
+        return std::unexpected(parseErrorToString(id.error()));
+    }
     
-    std::string version = findValue("version");
-    std::string next_id = findValue("next_id");
+    if (command == "complete") {
+        return TaskUpdate::status(*id, TaskStatus::Completed);
+    }
+    if (tokens.size() < 3) {
+        return std::unexpected(std::format("'{}' needs a value", command));
+    }
     
-    // Display file metadata
-    std::cout << "\n📊 File Information:\n";
-    std::cout << "┌─────────────┬────────────────────────────┐\n";
-    std::cout << "│ Property    │ Value                      │\n";
-    std::cout << "├─────────────┼────────────────────────────┤\n";
-    std::cout << std::format("│ Version     │ {:<26} │\n", version.empty() ? "N/A" : version);
-    std::cout << std::format("│ Next ID     │ {:<26} │\n", next_id.empty() ? "N/A" : next_id);
-    std::cout << std::format("│ File Size   │ {:<26} │\n", std::to_string(json_content.length()) + " bytes");
-    std::cout << "└─────────────┴────────────────────────────┘\n";
-    
-    // Parse tasks and display in table format
-    std::vector<TaskInfo> tasks = parseTasksFromJson(json_content);
+    // Text values may be quoted or span the rest of the line
+    std::string rest(tokens[2]);
+    for (size_t i = 3; i < tokens.size(); ++i) {
+        rest += ' ';
+        rest += tokens[i];
+    }
     
-    if (tasks.empty()) {
-        std::cout << "\n📝 No tasks found in the file.\n";
-        return;
+    if (command == "status") {
+        auto status = stringToTaskStatus(tokens[2]);
+        if (!status) {
+            return std::unexpected(std::format("Invalid status: {}", tokens[2]));
+        }
+        return TaskUpdate::status(*id, *status);
+    }
+    if (command == "priority") {
+        auto priority = parseInteger(tokens[2]);
+        if (!priority) {
+            return std::unexpected(parseErrorToString(priority.error()));
+        }
+        return TaskUpdate::priority(*id, *priority);
+    }
+    if (command == "category") return TaskUpdate::category(*id, std::move(rest));
+    if (command == "title") return TaskUpdate::title(*id, std::move(rest));
+    if (command == "description") return TaskUpdate::description(*id, std::move(rest));
+    return std::unexpected(std::format("Unknown batch command: {}", command));
+}
+
+void App::handleBatch(std::span<const std::string_view> args) {
+    std::ifstream file;
+    if (!args.empty()) {
+        file.open(std::string(args[0]));
+        if (!file.is_open()) {
+            handleJsonError(JsonError::FileNotFound);
+            return;
+        }
+    } else {
+        _out.write("📋 Enter updates, one per line (e.g. 'status 3 completed', 'priority 4 8'); finish with 'end':\n");
+        if (!_options.batch) {
+            _out.flush();
+        }
+    }
+    std::istream& in = args.empty() ? *_input : file;
+    
+    std::vector<TaskUpdate> updates;
+    std::vector<size_t> line_of_update;
+    size_t line_number = 0;
+    size_t invalid = 0;
+    // Own tokenizer: `args` still points into _tokenizer's buffers
+    CommandTokenizer tokenizer;
+    std::string line;
+    while (std::getline(in, line)) {
+        ++line_number;
+        auto tokens = tokenizer.tokenize(line);
+        if (tokens.empty() || tokens[0].starts_with('#')) continue;
+        if (tokens[0] == "end" && args.empty()) break;
+        
+        auto update = parseBatchLine(tokens);
+        if (!update) {
+            _out.print("❌ Line {}: {}\n", line_number, update.error());
+            ++invalid;
+            continue;
+        }
+        updates.push_back(std::move(*update));
+        line_of_update.push_back(line_number);
     }
     
-    std::cout << std::format("\n📋 Tasks ({} total):\n", tasks.size());
+    auto result = _task_manager.applyBatch(updates);
+    for (const auto& [index, error] : result.failures) {
+        _out.print("❌ Line {}: {}\n", line_of_update[index], taskErrorToString(error));
+    }
+    _out.print("📦 Batch applied: {} update(s), {} rejected, {} invalid line(s)\n",
+               result.applied, result.failures.size(), invalid);
+    addResult("applied", result.applied);
+    addResult("rejected", result.failures.size());
+    addResult("invalid", invalid);
+}
+
+std::expected<MappedFile, JsonError> App::readFileContent(const std::string& filename) const {
+    return MappedFile::open(filename);
+}
+
+namespace {
+
+/**
+ * @struct ViewColumnSpec
+ * @brief Name, header and width of one 'view' table column
+ */
+struct ViewColumnSpec {
+    std::string_view name;      ///< Name accepted by --columns
+    std::string_view header;    ///< Header text
+    size_t width;               ///< Cell width in characters
+    bool right_align;           ///< Numbers are right-aligned
+};
+
+constexpr std::array<ViewColumnSpec, 8> VIEW_COLUMNS{{
+    {"id", "ID", 4, true},
+    {"title", "Title", 19, false},
+    {"status", "Status", 11, false},
+    {"category", "Category", 11, false},
+    {"priority", "Priority", 8, true},
+    {"created", "Created At", 19, false},
+    {"updated", "Updated At", 19, false},
+    {"description", "Description", 30, false},
+}};
+
+const ViewColumnSpec& columnSpec(auto column) {
+    return VIEW_COLUMNS[static_cast<size_t>(column)];
+}
+
+/**
+ * @brief Byte length of the first max_chars UTF-8 characters of text
+ */
+size_t utf8Prefix(std::string_view text, size_t max_chars) {
+    size_t pos = 0;
+    for (size_t chars = 0; pos < text.size() && chars < max_chars; ++chars) {
+        ++pos;
+        while (pos < text.size() && (static_cast<unsigned char>(text[pos]) & 0xC0) == 0x80) {
+            ++pos; // Continuation byte
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief Border line of the table, e.g. "┌────┬───┐"
+ */
+template<typename Columns>
+std::string tableBorder(const Columns& columns, std::string_view left, std::string_view middle,
+                        std::string_view right) {
+    std::string line(left);
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) line += middle;
+        for (size_t n = 0; n < columnSpec(columns[i]).width + 2; ++n) line += "─";
+    }
+    line += right;
+    line += '\n';
+    return line;
+}
+
+} // namespace
+
+void App::handleView(std::span<const std::string_view> args) {
+    std::string filename;
+    ViewOptions view;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (!args[i].starts_with("--")) {
+            if (!filename.empty()) {
+                fail("Usage: view [filename] [--limit N] [--offset N] [--columns a,b,...]");
+                return;
+            }
+            filename = args[i];
+            continue;
+        }
+        if ((args[i] != "--limit" && args[i] != "--offset" && args[i] != "--columns") ||
+            i + 1 >= args.size()) {
+            fail("Usage: view [filename] [--limit N] [--offset N] [--columns a,b,...]");
+            return;
+        }
+        std::string_view value = args[++i];
+        if (args[i - 1] == "--columns") {
+            for (auto part : value | std::views::split(',')) {
+                std::string_view name(part.begin(), part.end());
+                auto spec = std::ranges::find(VIEW_COLUMNS, name, &ViewColumnSpec::name);
+                if (spec == VIEW_COLUMNS.end()) {
+                    fail("Invalid column: {}", name);
+                    _out.write("📋 Valid columns: id, title, status, category, priority, created, updated, description\n");
+                    return;
+                }
+                view.columns.push_back(static_cast<ViewColumn>(spec - VIEW_COLUMNS.begin()));
+            }
+            continue;
+        }
+        auto number = parseInteger(value);
+        if (!number || *number < 0) {
+            fail("Invalid {} value: {}", args[i - 1], value);
+            return;
+        }
+        (args[i - 1] == "--limit" ? view.limit : view.offset) = static_cast<size_t>(*number);
+    }
+    if (filename.empty()) {
+        filename = "tasks.json";
+    }
+    if (view.columns.empty()) {
+        view.columns = {ViewColumn::Id, ViewColumn::Title, ViewColumn::Status,
+                        ViewColumn::Category, ViewColumn::Priority, ViewColumn::Created};
+    }
     
-    // Table header
-    std::cout << "┌────┬─────────────────────┬─────────────┬─────────────┬──────────┬─────────────────────┐\n";
-    std::cout << "│ ID │ Title               │ Status      │ Category    │ Priority │ Created At          │\n";
-    std::cout << "├────┼─────────────────────┼─────────────┼─────────────┼──────────┼─────────────────────┤\n";
+    _out.print("👁️ Viewing JSON file: {}...\n", filename);
     
-    // Table rows
-    for (const auto& task : tasks) {
-        std::string truncated_title = task.title.length() > 19 ? 
-            task.title.substr(0, 16) + "..." : task.title;
-        std::string truncated_category = task.category.length() > 11 ? 
-            task.category.substr(0, 8) + "..." : task.category;
-        
-        std::cout << std::format("│{:>3} │ {:<19} │ {:<11} │ {:<11} │{:>9} │ {:<19} │\n",
-            task.id,
-            truncated_title,
-            task.status,
-            truncated_category,
-            task.priority,
-            task.created_at.substr(0, 19) // Show date with seconds (19 chars for YYYY-MM-DDTHH:MM:SS)
-        );
+    // Use std::expected for file reading
+    auto content_result = readFileContent(filename);
+    if (!content_result) {
+        handleJsonError(content_result.error());
+        _out.write("💡 Make sure the file exists and is readable.\n");
+        return;
     }
     
-    std::cout << "└────┴─────────────────────┴─────────────┴─────────────┴──────────┴─────────────────────┘\n";
+    std::string_view json_content = content_result->view();
     
-    // Suggest using stats command for more details
-    std::cout << "\n� Use 'stats' command to view detailed task statistics\n";
+    if (json_content.empty()) {
+        _out.write("⚠️ Note: File is empty\n");
+        return;
+    }
+    
+    addResult("file", filename);
+    // Parse and display in table format
+    displayJsonAsTable(json_content, view);
 }
 
-std::vector<App::TaskInfo> App::parseTasksFromJson(const std::string& json_content) {
-    std::vector<TaskInfo> tasks;
+void App::displayJsonAsTable(std::string_view json_content, const ViewOptions& view) {
+    TaskJsonReader reader(json_content);
+    auto report = [this](const JsonParseFailure& failure) {
+        handleJsonError(failure.error);
+        _out.print("📍 Parsing stopped at byte {}\n", failure.offset);
+        addResult("error_offset", failure.offset);
+    };
     
-    // Find tasks array
-    size_t tasks_pos = json_content.find("\"tasks\":");
-    if (tasks_pos == std::string::npos) {
-        return tasks; // No tasks array found
+    // Everything before the tasks array; the writer puts version and next_id there
+    if (auto begun = reader.begin(); !begun) {
+        report(begun.error());
+        return;
     }
+    const TaskDocumentInfo& info = reader.info();
+    std::string next_id = info.next_id ? std::to_string(*info.next_id) : "N/A";
     
-    // Find opening bracket of tasks array
-    size_t array_start = json_content.find('[', tasks_pos);
-    if (array_start == std::string::npos) {
-        return tasks;
+    // Display file metadata
+    _out.write("\n📊 File Information:\n");
+    _out.write("┌─────────────┬────────────────────────────┐\n");
+    _out.write("│ Property    │ Value                      │\n");
+    _out.write("├─────────────┼────────────────────────────┤\n");
+    _out.print("│ Version     │ {:<26} │\n", info.version.empty() ? "N/A" : info.version);
+    _out.print("│ Next ID     │ {:<26} │\n", next_id);
+    _out.print("│ File Size   │ {:<26} │\n", std::to_string(json_content.length()) + " bytes");
+    _out.write("└─────────────┴────────────────────────────┘\n");
+    if (!info.version.empty()) addResult("version", info.version);
+    if (info.next_id) addResult("next_id", *info.next_id);
+    
+    // Skipped objects are only scanned for their closing brace, not decoded
+    size_t total = 0;
+    size_t object_begin = 0;
+    JsonParseResult step = true;
+    while (total < view.offset && (step = reader.skipNext(object_begin)) && *step) {
+        ++total;
     }
     
-    // Simple parser to extract task objects
-    size_t pos = array_start + 1;
-    while (pos < json_content.length()) {
-        // Skip whitespace
-        while (pos < json_content.length() && std::isspace(json_content[pos])) {
-            pos++;
-        }
-        
-        if (pos >= json_content.length() || json_content[pos] == ']') {
-            break; // End of array
+    TaskRecord record;
+    std::string cell;
+    size_t shown = 0;
+    while (step && *step && shown < view.limit && (step = reader.next(record)) && *step) {
+        if (shown == 0) {
+            _out.write("\n📋 Tasks:\n");
+            _out.write(tableBorder(view.columns, "┌", "┬", "┐"));
+            for (ViewColumn column : view.columns) {
+                const ViewColumnSpec& spec = columnSpec(column);
+                _out.print("│ {:<{}} ", spec.header, spec.width);
+            }
+            _out.write("│\n");
+            _out.write(tableBorder(view.columns, "├", "┼", "┤"));
         }
         
-        if (json_content[pos] == '{') {
-            // Parse task object
-            TaskInfo task;
-            task.id = 0;
-            task.priority = 0;
-            
-            size_t obj_end = pos;
-            int brace_count = 1;
-            obj_end++;
-            
-            // Find end of object
-            while (obj_end < json_content.length() && brace_count > 0) {
-                if (json_content[obj_end] == '{') brace_count++;
-                else if (json_content[obj_end] == '}') brace_count--;
-                obj_end++;
-            }
-            
-            std::string task_obj = json_content.substr(pos, obj_end - pos);
-            
-            // Extract task properties
-            auto extractValue = [&task_obj](const std::string& key) -> std::string {
-                std::string search_key = "\"" + key + "\":";
-                size_t key_pos = task_obj.find(search_key);
-                if (key_pos == std::string::npos) return "";
-                
-                key_pos += search_key.length();
-                while (key_pos < task_obj.length() && std::isspace(task_obj[key_pos])) {
-                    key_pos++;
+        _out.append([&](std::string& out) {
+            for (ViewColumn column : view.columns) {
+                const ViewColumnSpec& spec = columnSpec(column);
+                cell.clear();
+                switch (column) {
+                    case ViewColumn::Id:
+                        if (record.id) std::format_to(std::back_inserter(cell), "{}", *record.id);
+                        break;
+                    case ViewColumn::Title:       cell = record.title; break;
+                    case ViewColumn::Status:      cell = record.status; break;
+                    case ViewColumn::Category:    cell = record.category; break;
+                    case ViewColumn::Priority:
+                        if (record.priority) std::format_to(std::back_inserter(cell), "{}", *record.priority);
+                        break;
+                    // Date with seconds (19 chars for YYYY-MM-DDTHH:MM:SS)
+                    case ViewColumn::Created:     cell = std::string_view(record.created_at).substr(0, 19); break;
+                    case ViewColumn::Updated:     cell = std::string_view(record.updated_at).substr(0, 19); break;
+                    case ViewColumn::Description: cell = record.description; break;
+                }
+                if (size_t fit = utf8Prefix(cell, spec.width); fit < cell.size()) {
+                    cell.resize(utf8Prefix(cell, spec.width - 3));
+                    cell += "...";
                 }
-                
-                if (key_pos >= task_obj.length()) return "";
-                
-                if (task_obj[key_pos] == '"') {
-                    key_pos++;
-                    size_t end_pos = key_pos;
-                    while (end_pos < task_obj.length() && task_obj[end_pos] != '"') {
-                        if (task_obj[end_pos] == '\\') end_pos++;
-                        end_pos++;
-                    }
-                    return unescapeJsonString(task_obj.substr(key_pos, end_pos - key_pos));
+                if (spec.right_align) {
+                    std::format_to(std::back_inserter(out), "│ {:>{}} ", cell, spec.width);
                 } else {
-                    size_t end_pos = key_pos;
-                    while (end_pos < task_obj.length() && 
-                           task_obj[end_pos] != ',' && 
-                           task_obj[end_pos] != '}' && 
-                           task_obj[end_pos] != '\n' &&
-                           task_obj[end_pos] != '\r') {
-                        end_pos++;
-                    }
-                    std::string value = task_obj.substr(key_pos, end_pos - key_pos);
-                    value.erase(0, value.find_first_not_of(" \t\n\r"));
-                    value.erase(value.find_last_not_of(" \t\n\r") + 1);
-                    return value;
+                    std::format_to(std::back_inserter(out), "│ {:<{}} ", cell, spec.width);
                 }
-            };
-            
-            // Parse task fields
-            std::string id_str = extractValue("id");
-            if (!id_str.empty()) {
-                task.id = std::stoi(id_str);
-            }
-            
-            task.title = extractValue("title");
-            task.status = extractValue("status");
-            task.category = extractValue("category");
-            task.created_at = extractValue("created_at");
-            task.description = extractValue("description");
-            
-            std::string priority_str = extractValue("priority");
-            if (!priority_str.empty()) {
-                task.priority = std::stoi(priority_str);
             }
-            
-            tasks.push_back(task);
-            pos = obj_end;
-        } else {
-            pos++;
+            out += "│\n";
+        });
+        ++shown;
+        ++total;
+        
+        // Show the first row at once instead of after the first full buffer
+        if (shown == 1 && !_options.batch) {
+            _out.flush();
         }
     }
     
-    return tasks;
-}
-
-std::vector<std::string> App::parseInput(const std::string& input) const {
-    std::vector<std::string> tokens;
-    std::istringstream iss(input);
-    std::string token;
-    bool in_quotes = false;
-    std::string current_token;
+    if (shown > 0) {
+        _out.write(tableBorder(view.columns, "└", "┴", "┘"));
+    }
+    if (!_options.batch) {
+        _out.flush();
+    }
     
-    char c;
-    while (iss.get(c)) {
-        if (c == '"') {
-            in_quotes = !in_quotes;
-        } else if (c == ' ' && !in_quotes) {
-            if (!current_token.empty()) {
-                tokens.push_back(current_token);
-                current_token.clear();
-            }
-        } else {
-            current_token += c;
-        }
+    // A full page looks one object ahead and stops there: the rest of a large file is never read
+    bool more = false;
+    if (step && *step && shown == view.limit) {
+        step = reader.skipNext(object_begin);
+        more = step && *step;
+    }
+    if (step && !more) {
+        step = reader.finish();
+    }
+    if (!step) {
+        report(step.error());
+        return;
     }
     
-    if (!current_token.empty()) {
-        tokens.push_back(current_token);
+    addResult("offset", view.offset);
+    addResult("shown", shown);
+    addResult("more", more);
+    if (!more) addResult("total", total);
+    if (more) {
+        _out.print("\n📋 Showing tasks {}-{}, more rows follow (use --offset {})\n",
+                   view.offset + 1, view.offset + shown, view.offset + shown);
+    } else if (total == 0) {
+        _out.write("\n📝 No tasks found in the file.\n");
+        return;
+    } else if (shown == total) {
+        _out.print("\n📋 {} task(s) total\n", total);
+    } else if (shown == 0) {
+        _out.print("\n📝 No tasks at offset {} ({} total)\n", view.offset, total);
+    } else {
+        _out.print("\n📋 Showing tasks {}-{} of {}\n", view.offset + 1, view.offset + shown, total);
     }
     
-    return tokens;
+    // Suggest using stats command for more details
+    _out.write("\n� Use 'stats' command to view detailed task statistics\n");
 }
 
 // C++23: std::expected-based parsing utilities
-std::expected<int, App::ParseError> App::parseInteger(const std::string& str) const {
+std::expected<int, App::ParseError> App::parseInteger(std::string_view str) const {
     if (str.empty()) {
         return std::unexpected(ParseError::Empty);
     }
     
-    try {
-        size_t pos;
-        int result = std::stoi(str, &pos);
-        
-        // Check if entire string was consumed
-        if (pos != str.length()) {
-            return std::unexpected(ParseError::InvalidFormat);
-        }
-        
-        return result;
-    } catch (const std::invalid_argument&) {
-        return std::unexpected(ParseError::InvalidFormat);
-    } catch (const std::out_of_range&) {
+    // from_chars: no copy, no exceptions, no locale; accepts a leading '+' like stoi
+    std::string_view digits = str.starts_with('+') ? str.substr(1) : str;
+    int result = 0;
+    auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), result);
+    if (ec == std::errc::result_out_of_range) {
         return std::unexpected(ParseError::OutOfRange);
     }
+    // The entire string must be consumed
+    if (ec != std::errc{} || ptr != digits.data() + digits.size()) {
+        return std::unexpected(ParseError::InvalidFormat);
+    }
+    return result;
 }
 
 std::string App::parseErrorToString(ParseError error) const {
@@ -831,87 +1839,95 @@ std::string App::parseErrorToString(ParseError error) const {
     }
 }
 
+std::optional<std::chrono::system_clock::time_point> App::parseSince(std::string_view text) const {
+    if (auto age = parseDuration(text)) {
+        return std::chrono::system_clock::now() - *age;
+    }
+    if (text.size() == 10) {
+        // A bare date: the start of that day
+        std::string midnight(text);
+        midnight += "T00:00:00Z";
+        return parseIsoTimestamp(midnight);
+    }
+    return parseIsoTimestamp(text);
+}
+
 void App::handleError(TaskError error) const {
-    std::cout << std::format("❌ Error: {}\n", taskErrorToString(error));
+    fail("Error: {}", taskErrorToString(error));
 }
 
 void App::printTaskDetails(const Task& task) const {
-    std::cout << task.to_string() << "\n";
+    _out.print("{}\n", task.to_string());
 }
 
 // C++23: New handlers using multidimensional subscript and other features
-void App::handleMatrix(const std::vector<std::string>& args) {
-    // Rebuild matrix from current tasks
-    _task_matrix.clear();
-    
-    // C++23: auto(x) decay copy for clean iteration
-    for (const auto& task : _task_manager.getAllTasks()) {
-        _task_matrix.addTask(auto(task));  // Clean copy
-    }
+void App::handleMatrix(std::span<const std::string_view> args) {
+    // The matrix is maintained live by TaskManager; nothing to rebuild
+    const TaskMatrix& matrix = _task_manager.getMatrix();
     
-    if (_task_matrix.getTotalTaskCount() == 0uz) {  // C++23: uz suffix
-        std::print("📭 No tasks to display in matrix\n");
+    if (matrix.getTotalTaskCount() == 0uz) {  // C++23: uz suffix
+        _out.print("📭 No tasks to display in matrix\n");
         return;
     }
     
-    _task_matrix.displayMatrix();
+    _out.append([&](std::string& out) { matrix.displayMatrix(_task_manager, out); });
     
     // Display statistics
-    std::print("\n📈 Matrix Statistics:\n");
-    std::print("  📊 Total tasks: {}\n", _task_matrix.getTotalTaskCount());
-    std::print("  📂 Categories: {}\n", _task_matrix.getCategories().size());
+    _out.print("\n📈 Matrix Statistics:\n");
+    _out.print("  📊 Total tasks: {}\n", matrix.getTotalTaskCount());
+    _out.print("  📂 Categories: {}\n", matrix.getCategories().size());
+    addResult("total", matrix.getTotalTaskCount());
+    addResult("categories", matrix.getCategories().size());
 }
 
-void App::handleGet(const std::vector<std::string>& args) {
-    const std::string& category = args[0];
+void App::handleGet(std::span<const std::string_view> args) {
+    std::string_view category = args[0];
     
     auto priority_result = parseInteger(args[1]);
     if (!priority_result) {
-        std::print("❌ {}\n", parseErrorToString(priority_result.error()));
+        fail("{}", parseErrorToString(priority_result.error()));
         return;
     }
     
     int priority = *priority_result;
     
-    // Rebuild matrix
-    _task_matrix.clear();
-    for (const auto& task : _task_manager.getAllTasks()) {
-        _task_matrix.addTask(task);
-    }
-    
     // C++23: Multidimensional subscript operator [category, priority]
-    const auto& tasks = _task_matrix[category, priority];
+    const auto& ids = _task_manager.getMatrix()[category, priority];
     
-    if (tasks.empty()) {
-        std::print("📭 No tasks found for category '{}' with priority {}\n", 
+    if (ids.empty()) {
+        _out.print("📭 No tasks found for category '{}' with priority {}\n", 
                    category, priority);
         return;
     }
     
-    std::print("🎯 Tasks in category '{}' with priority {}:\n", category, priority);
-    std::print("===============================================\n");
+    _out.print("🎯 Tasks in category '{}' with priority {}:\n", category, priority);
+    _out.print("===============================================\n");
     
-    for (const auto& task : tasks) {
-        std::print("  [{}] {} - {}\n", 
-                   task.getId(), 
-                   task.getTitle(), 
-                   getTaskStatusString(task.getStatus()));  // C++23: consteval function
+    for (int id : ids) {
+        const Task* task = _task_manager.findTask(id);
+        if (!task) continue;
+        _out.print("  [{}] {} - {}\n", 
+                   task->getId(), 
+                   task->getTitle(), 
+                   getTaskStatusString(task->getStatus()));  // C++23: consteval function
     }
     
-    std::print("\n📊 Found {} task(s)\n", tasks.size());
+    _out.print("\n📊 Found {} task(s)\n", ids.size());
+    addResultTasks("tasks", ids | std::views::transform([this](int id) { return _task_manager.findTask(id); }));
 }
 
-void App::handleRecent(const std::vector<std::string>& args) {
-    if (_recent_commands.empty()) {
-        std::print("📭 No recent commands\n");
+void App::handleRecent(std::span<const std::string_view> args) {
+    if (_recent_count == 0) {
+        _out.print("📭 No recent commands\n");
         return;
     }
     
-    std::print("🕐 Recent Commands:\n");
-    std::print("==================\n");
+    _out.print("🕐 Recent Commands:\n");
+    _out.print("==================\n");
     
-    // C++23: uz suffix and ranges
-    for (size_t i = 0uz; i < std::min(_recent_commands.size(), MAX_RECENT_COMMANDS); ++i) {
-        std::print("  {}. {}\n", i + 1, _recent_commands[i]);
+    // Oldest first; C++23: uz suffix
+    size_t oldest = (_recent_next + MAX_RECENT_COMMANDS - _recent_count) % MAX_RECENT_COMMANDS;
+    for (size_t i = 0uz; i < _recent_count; ++i) {
+        _out.print("  {}. {}\n", i + 1, _recent_commands[(oldest + i) % MAX_RECENT_COMMANDS]);
     }
 }
\ No newline at end of file
@@ -4,7 +4,19 @@
 #include "task.h"
 #include "task_manager.h"
 #include "task_matrix.h"
+#include "mapped_file.h"
+#include "task_journal.h"
+#include "task_json.h"
+#include "app_output.h"
+#include "command_tokenizer.h"
+#include "string_hash.h"
+#include "perf_counters.h"
+#include "task_query.h"
+#include "task_autosave.h"
+#include "sharded_task_store.h"
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 #include <unordered_map>
@@ -13,6 +25,14 @@
 #include <print>
 #include <compare>
 #include <expected>
+#include <optional>
+#include <concepts>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
 
 /**
  * @brief Maximum number of arguments for a command
@@ -30,6 +50,30 @@ constexpr auto MIN_COMMAND_LENGTH = 1uz;
  */
 constexpr auto MAX_INPUT_LENGTH = 1000uz;
 
+/**
+ * @enum OutputFormat
+ * @brief How App reports command results
+ */
+enum class OutputFormat {
+    Text,       /**< Human-readable text */
+    JsonLines   /**< One JSON object per command */
+};
+
+/**
+ * @struct AppOptions
+ * @brief Startup options taken from the command line
+ */
+struct AppOptions {
+    std::string journal_path;   /**< Snapshot path for journal mode; empty disables journaling */
+    JournalOptions journal;     /**< Journal durability settings */
+    unsigned workers = 1;       /**< Threads for bulk load/save/sort; 0 = one per hardware thread */
+    bool batch = false;         /**< Non-interactive: no banner, no prompt, output flushed in large chunks */
+    std::string script_path;    /**< Read commands from this file instead of stdin (implies batch) */
+    OutputFormat output = OutputFormat::Text; /**< Result format */
+    AutosaveOptions autosave;   /**< Background autosave target and schedule; empty path disables it */
+    std::vector<std::string> shard_paths; /**< Team files loaded into the sharded store at startup */
+};
+
 /**
  * @class App
  * @brief Main application class for the Task Tracker CLI
@@ -38,22 +82,67 @@ constexpr auto MAX_INPUT_LENGTH = 1000uz;
 class App {
 private:
     /**
-     * @struct TaskInfo
-     * @brief Helper structure for table display of task information
-     * @details Contains simplified task data for UI presentation
-     */
-    struct TaskInfo {
-        int id;                 /**< Task identifier */
-        std::string title;      /**< Task title */
-        std::string status;     /**< Task status as string */
-        std::string category;   /**< Task category */
-        int priority;           /**< Task priority level */
-        std::string created_at; /**< Creation timestamp */
-        std::string description; /**< Task description */
+     * @enum ViewColumn
+     * @brief Columns the 'view' command can show
+     */
+    enum class ViewColumn {
+        Id,             /**< Task identifier */
+        Title,          /**< Task title */
+        Status,         /**< Status as written in the file */
+        Category,       /**< Task category */
+        Priority,       /**< Task priority level */
+        Created,        /**< Creation timestamp */
+        Updated,        /**< Last update timestamp */
+        Description     /**< Task description */
+    };
+
+    /**
+     * @struct ViewOptions
+     * @brief Paging and column selection for the 'view' command
+     */
+    struct ViewOptions {
+        size_t offset = 0;                                  /**< Task objects to skip before the first row */
+        size_t limit = std::numeric_limits<size_t>::max();  /**< Maximum number of rows to print */
+        std::vector<ViewColumn> columns;                    /**< Columns in display order */
     };
 
     TaskManager _task_manager;  /**< Task manager instance */
     bool _running;              /**< Application running state */
+    AppOptions _options;        /**< Startup options */
+    
+    /**
+     * @brief Journal of mutations since the last snapshot (journal mode only)
+     * @details Declared after _task_manager, which holds a pointer to it
+     */
+    std::optional<TaskJournal> _journal;
+    
+    /**
+     * @brief Background autosave (autosave mode only)
+     * @details Declared after _task_manager so that its worker is stopped first
+     */
+    std::optional<TaskAutosave> _autosave;
+    size_t _autosave_failures = 0;  /**< Autosave failures already reported */
+    
+    ShardedTaskStore _shards;   /**< Team files opened next to the main task list ('shards') */
+    
+    /**
+     * @brief Buffered output shared by every handler
+     * @details Mutable so that const display helpers can write to it
+     */
+    mutable AppOutput _out;
+    
+    std::istream* _input = &std::cin;  /**< Command source: stdin or the script file */
+    
+    /**
+     * @brief Error message of the current command (JSON lines output)
+     * @details Set by the first fail() of the command
+     */
+    mutable std::string _error;
+    
+    /**
+     * @brief Comma-separated "key":value members of the current command's result (JSON lines output)
+     */
+    mutable std::string _result;
     
     /**
      * @struct Command
@@ -63,7 +152,7 @@ private:
     struct Command {
         std::string name;       /**< Command name */
         std::string description; /**< Command description */
-        std::function<void(const std::vector<std::string>&)> handler; /**< Command handler function */
+        std::function<void(std::span<const std::string_view>)> handler; /**< Command handler function */
         size_t min_args;        /**< Minimum required arguments */
         size_t max_args;        /**< Maximum allowed arguments */
         
@@ -86,13 +175,11 @@ private:
         }
     };
     
-    std::unordered_map<std::string, Command> _commands; /**< Registered commands map */
-    
     /**
-     * @brief TaskMatrix for multidimensional task access
-     * @details C++23: Uses flat_map for better cache locality
+     * @brief Registered commands map
+     * @details Transparent lookup: tokens are checked without building a std::string
      */
-    TaskMatrix _task_matrix;
+    std::unordered_map<std::string, Command, TransparentStringHash, std::equal_to<>> _commands;
     
     /**
      * @brief Maximum number of recent commands to store
@@ -100,7 +187,16 @@ private:
      */
     static constexpr auto MAX_RECENT_COMMANDS = 10uz;
     
-    std::vector<std::string> _recent_commands; /**< History of recent commands */
+    /**
+     * @brief Ring buffer of recent command names, overwritten in place
+     * @details Slots keep their capacity, so recording a command does not
+     *          allocate or shift the history
+     */
+    std::array<std::string, MAX_RECENT_COMMANDS> _recent_commands;
+    size_t _recent_count = 0;   /**< Commands recorded, up to MAX_RECENT_COMMANDS */
+    size_t _recent_next = 0;    /**< Slot the next command is written to */
+    
+    CommandTokenizer _tokenizer; /**< Tokenizer reused for every input line */
     
     /**
      * @brief Initialize all command handlers
@@ -126,119 +222,330 @@ private:
      * @brief Handle the 'add' command to create new tasks
      * @param args Command arguments (task title, description)
      */
-    void handleAdd(const std::vector<std::string>& args);
+    void handleAdd(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'list' command to display tasks
-     * @param args Command arguments (optional status filter)
+     * @details With --since, lists the tasks created since a date, a timestamp
+     *          or an age ago ("7d"), oldest first, through the time index
+     * @param args Command arguments (optional status filter, optional --since <when>)
      */
-    void handleList(const std::vector<std::string>& args);
+    void handleList(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'complete' command to mark tasks as completed
      * @param args Command arguments (task ID)
      */
-    void handleComplete(const std::vector<std::string>& args);
+    void handleComplete(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'remove' command to delete tasks
      * @param args Command arguments (task ID)
      */
-    void handleRemove(const std::vector<std::string>& args);
+    void handleRemove(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'status' command to update task status
      * @param args Command arguments (task ID, new status)
      */
-    void handleStatus(const std::vector<std::string>& args);
+    void handleStatus(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'priority' command to set task priority
      * @param args Command arguments (task ID, priority level)
      */
-    void handlePriority(const std::vector<std::string>& args);
+    void handlePriority(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'category' command to set task category
      * @param args Command arguments (task ID, category name)
      */
-    void handleCategory(const std::vector<std::string>& args);
+    void handleCategory(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'stats' command to display task statistics
      * @param args Command arguments (none)
      */
-    void handleStats(const std::vector<std::string>& args);
+    void handleStats(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'find' command to search for tasks
-     * @param args Command arguments (search keyword)
+     * @details Uses TaskManager::findTasks: every word must match (as a prefix)
+     *          a word of the title or description
+     * @param args Command arguments (search words)
      */
-    void handleFind(const std::vector<std::string>& args);
+    void handleFind(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'sort' command to sort tasks by criteria
-     * @param args Command arguments (sort criterion)
+     * @details Prints one page of the sorted view; --limit/--offset select it
+     * @param args Command arguments (sort criterion, optional --limit N and --offset N)
+     */
+    void handleSort(std::span<const std::string_view> args);
+    
+    /**
+     * @brief Handle the 'stale' command to list open tasks that were left alone
+     * @details Pending and in-progress tasks not updated for at least the given
+     *          age, longest idle first, through the time index
+     * @param args Command arguments (age such as 72h or 3d, optional --limit N)
+     */
+    void handleStale(std::span<const std::string_view> args);
+    
+    /**
+     * @brief Handle the 'throughput' command to show completions per day
+     * @details Counts the completed tasks by UTC day of completed_at for the last
+     *          N days (default 7), today included
+     * @param args Command arguments (optional number of days)
      */
-    void handleSort(const std::vector<std::string>& args);
+    void handleThroughput(std::span<const std::string_view> args);
+    
+    /**
+     * @brief Handle the 'query' command to filter tasks on several fields at once
+     * @details Parses the terms with parseTaskQuery and runs them with runTaskQuery
+     * @param args Command arguments (query terms)
+     */
+    void handleQuery(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'exit' command to quit the application
      * @param args Command arguments (none)
      */
-    void handleExit(const std::vector<std::string>& args);
+    void handleExit(std::span<const std::string_view> args);
     
     /**
-     * @brief Handle the 'save' command to save tasks to JSON
-     * @param args Command arguments (filename)
+     * @brief Handle the 'save' command to save tasks to JSON or a binary snapshot
+     * @param args Command arguments (optional --binary flag, filename)
      */
-    void handleSave(const std::vector<std::string>& args);
+    void handleSave(std::span<const std::string_view> args);
     
     /**
-     * @brief Handle the 'load' command to load tasks from JSON
-     * @param args Command arguments (filename)
+     * @brief Handle the 'load' command to load tasks from JSON or a binary snapshot
+     * @param args Command arguments (optional --binary flag, filename)
      */
-    void handleLoad(const std::vector<std::string>& args);
+    void handleLoad(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'view' command to display task JSON data
-     * @param args Command arguments (filename)
+     * @param args Command arguments (filename, --limit N, --offset N, --columns a,b,...)
      */
-    void handleView(const std::vector<std::string>& args);
+    void handleView(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'matrix' command to show task organization
      * @details C++23: Uses flat_map for displaying task matrix
      * @param args Command arguments (none)
      */
-    void handleMatrix(const std::vector<std::string>& args);
+    void handleMatrix(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'get' command to retrieve specific task
      * @details C++23: Uses deducing this for accessing tasks
      * @param args Command arguments (task ID)
      */
-    void handleGet(const std::vector<std::string>& args);
+    void handleGet(std::span<const std::string_view> args);
     
     /**
      * @brief Handle the 'recent' command to show command history
      * @param args Command arguments (none)
      */
-    void handleRecent(const std::vector<std::string>& args);
+    void handleRecent(std::span<const std::string_view> args);
+    
+    /**
+     * @brief Handle the 'journal' command to show journal status
+     * @param args Command arguments (none)
+     */
+    void handleJournal(std::span<const std::string_view> args);
+    
+    /**
+     * @brief Handle the 'compact' command to fold the journal into a new snapshot
+     * @param args Command arguments (none)
+     */
+    void handleCompact(std::span<const std::string_view> args);
+    
+    /**
+     * @brief Handle the 'batch' command to apply many updates at once
+     * @details Reads one update per line (status, complete, priority, category,
+     *          title, description) from a file, or from stdin up to a line "end",
+     *          and applies them with TaskManager::applyBatch
+     * @param args Command arguments (optional filename)
+     */
+    void handleBatch(std::span<const std::string_view> args);
+    
+    /**
+     * @brief Handle the 'perf' command to report the hot-path probes
+     * @details Prints call counts, p50/p99/max latency, bytes and allocations per
+     *          probe; 'jsonl' writes one JSON object per probe instead, appended
+     *          to a file if one is given. Needs a TASKTRACKER_PERF build.
+     * @param args Command arguments (optional jsonl [filename] or reset)
+     */
+    void handlePerf(std::span<const std::string_view> args);
+    
+    /**
+     * @brief Handle the 'autosave' command to show or force the background save
+     * @details Without arguments prints the worker status; 'now' hands off any
+     *          unsaved changes and waits until they are on disk
+     * @param args Command arguments (optional now)
+     */
+    void handleAutosave(std::span<const std::string_view> args);
+    
+    /**
+     * @brief Handle the 'shards' command to work across several team files
+     * @details Lists, loads and saves the shards and runs stats, matrix, query,
+     *          sort and find over all of them at once; tasks are shown with
+     *          their namespaced id, [shard:id]
+     * @param args Command arguments (subcommand and its arguments)
+     */
+    void handleShards(std::span<const std::string_view> args);
+    
+    /**
+     * @brief Load team files into the sharded store and report each one
+     * @param paths Files (or segmented directories) to load
+     */
+    void loadShards(std::span<const std::string> paths);
+    
+    /**
+     * @brief Turn one tokenized batch line into an update
+     * @param tokens Tokens of the line (command first)
+     * @return Update, or a message describing why the line is invalid
+     */
+    std::expected<TaskUpdate, std::string> parseBatchLine(std::span<const std::string_view> tokens) const;
     ///@}
     
     /**
-     * @name Utility Methods
-     * @brief Helper functions for command processing and UI
+     * @brief Parse and run one input line
+     * @param input Raw command line
+     */
+    void executeLine(std::string_view input);
+    
+    /**
+     * @name Result Reporting
+     * @brief Errors and structured results, for text and JSON lines output
      */
     ///@{
     /**
-     * @brief Parse user input into command and arguments
-     * @param input Raw input string from the user
-     * @return Vector of parsed command components
+     * @brief Whether results are reported as JSON lines
+     */
+    bool jsonLines() const {
+        return _options.output == OutputFormat::JsonLines;
+    }
+    
+    /**
+     * @brief Start reporting one command
+     * @details In JSON lines mode, the command's text output is captured
      */
-    std::vector<std::string> parseInput(const std::string& input) const;
+    void beginCommand();
     
+    /**
+     * @brief Finish reporting one command
+     * @details In JSON lines mode, writes the command's record:
+     *          {"command", "args", "ok", "error", "result", "output"}
+     * @param command Command name
+     * @param args Command arguments
+     */
+    void endCommand(std::string_view command, std::span<const std::string_view> args);
+    
+    /**
+     * @brief Report that the current command failed
+     * @details Prints the message with a ❌ marker; the first message of a command
+     *          becomes its "error" in JSON lines mode
+     * @tparam Args Format argument types
+     * @param fmt Message format string
+     * @param args Format arguments
+     */
+    template<typename... Args>
+    void fail(std::format_string<Args...> fmt, Args&&... args) const {
+        std::string message = std::format(fmt, std::forward<Args>(args)...);
+        _out.print("❌ {}\n", message);
+        if (_error.empty()) {
+            _error = std::move(message);
+        }
+    }
+    
+    /**
+     * @brief Open a member of the current command's result
+     * @param key Member name
+     */
+    void beginResultMember(std::string_view key) const;
+    
+    /**
+     * @brief Add a number or string to the current command's result
+     * @details No-op unless output is JSON lines
+     * @tparam T Arithmetic or string-like type
+     * @param key Member name
+     * @param value Member value
+     */
+    template<typename T>
+    void addResult(std::string_view key, const T& value) const {
+        if (!jsonLines()) return;
+        beginResultMember(key);
+        if constexpr (std::is_same_v<T, bool>) {
+            _result += value ? "true" : "false";
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            std::format_to(std::back_inserter(_result), "{}", value);
+        } else {
+            _result += '"';
+            appendJsonEscaped(_result, std::string_view(value));
+            _result += '"';
+        }
+    }
+    
+    /**
+     * @brief Add an array of tasks to the current command's result
+     * @details No-op unless output is JSON lines
+     * @tparam R Range of const Task& or const Task*
+     * @param key Member name
+     * @param tasks Tasks to add
+     */
+    template<std::ranges::input_range R>
+    void addResultTasks(std::string_view key, R&& tasks) const {
+        if (!jsonLines()) return;
+        beginResultMember(key);
+        _result += '[';
+        bool first = true;
+        for (const auto& element : tasks) {
+            if (!first) _result += ',';
+            first = false;
+            if constexpr (std::is_pointer_v<std::remove_cvref_t<decltype(element)>>) {
+                appendTaskJson(*element);
+            } else {
+                appendTaskJson(element);
+            }
+        }
+        _result += ']';
+    }
+    
+    /**
+     * @brief Append one task as a compact JSON object to the current result
+     * @param task Task to append
+     */
+    void appendTaskJson(const Task& task) const;
+    
+    /**
+     * @brief Add an array of tasks from the sharded store to the current result
+     * @details Each element is {"shard":name,"task":{...}}; no-op unless output is JSON lines
+     * @param key Member name
+     * @param tasks Tasks to add
+     */
+    void addResultShardedTasks(std::string_view key, std::span<const ShardedTask> tasks) const;
+    ///@}
+    
+    /**
+     * @brief Load the journal snapshot, replay the journal and start journaling
+     * @details Called from config() when AppOptions::journal_path is set
+     */
+    void openJournal();
+    
+    /**
+     * @brief Let the autosave worker pick up changes after a command
+     * @details Called from executeLine() after every command; reports new background failures
+     */
+    void pollAutosave();
+    
+    /**
+     * @name Utility Methods
+     * @brief Helper functions for command processing and UI
+     */
+    ///@{
     /**
      * @brief Handle and display task-related errors
      * @param error The task error that occurred
@@ -264,17 +571,15 @@ private:
      */
     ///@{
     /**
-     * @brief Display JSON content in tabular format
-     * @param json_content Raw JSON string to display
+     * @brief Stream the tasks of a JSON document as a table
+     * @details Rows are decoded one at a time with TaskJsonReader and written
+     *          straight to the output, so memory use does not grow with the file.
+     *          Skipped tasks and the ones after the last row are only scanned
+     *          for their boundaries to report the total.
+     * @param json_content Raw JSON text to display
+     * @param view Paging and columns to show
      */
-    void displayJsonAsTable(const std::string& json_content);
-    
-    /**
-     * @brief Parse task data from JSON into TaskInfo structures
-     * @param json_content Raw JSON string to parse
-     * @return Vector of TaskInfo objects
-     */
-    std::vector<TaskInfo> parseTasksFromJson(const std::string& json_content);
+    void displayJsonAsTable(std::string_view json_content, const ViewOptions& view);
     ///@}
     
     /**
@@ -283,12 +588,13 @@ private:
      */
     ///@{
     /**
-     * @brief Read content from a file with error handling
-     * @details C++23: Uses std::expected for functional error handling
+     * @brief Open a file for reading with error handling
+     * @details C++23: Uses std::expected for functional error handling.
+     *          The file is memory-mapped, so no copy of the content is made.
      * @param filename Name of file to read
-     * @return Content or error code
+     * @return Mapped content or error code
      */
-    std::expected<std::string, JsonError> readFileContent(const std::string& filename) const;
+    std::expected<MappedFile, JsonError> readFileContent(const std::string& filename) const;
     ///@}
     
     /**
@@ -312,7 +618,7 @@ private:
      * @param str String to parse
      * @return Integer value or error code
      */
-    std::expected<int, ParseError> parseInteger(const std::string& str) const;
+    std::expected<int, ParseError> parseInteger(std::string_view str) const;
     
     /**
      * @brief Convert parse error to human-readable string
@@ -320,6 +626,16 @@ private:
      * @return Error description
      */
     std::string parseErrorToString(ParseError error) const;
+    
+    /**
+     * @brief Parse a point in time given as a date, a timestamp or an age
+     * @details "2026-10-01" is midnight UTC of that day, ISO 8601 timestamps
+     *          are read by parseIsoTimestamp, and an age like "72h" or "7d" is
+     *          that long before now
+     * @param text Text to parse
+     * @return Time point, or std::nullopt if the text is none of these
+     */
+    std::optional<std::chrono::system_clock::time_point> parseSince(std::string_view text) const;
     ///@}
     
     /**
@@ -328,7 +644,7 @@ private:
      * @param cmd Command string to validate
      * @return true if command is valid
      */
-    bool validateCommand(const std::string& cmd) const {
+    bool validateCommand(std::string_view cmd) const {
         return !cmd.empty() && 
                cmd.length() >= MIN_COMMAND_LENGTH &&
                _commands.contains(cmd);
@@ -337,20 +653,25 @@ private:
 public:
     /**
      * @brief Constructor for the App class
+     * @param options Startup options (journal mode is off by default)
      */
-    App();
+    explicit App(AppOptions options = {});
     
     /**
      * @brief Configure the application before running
-     * @details Initializes commands and settings
+     * @details Initializes commands and settings, and restores state from the
+     *          snapshot and journal in journal mode
      */
     void config();
     
     /**
      * @brief Run the application main loop
-     * @details Handles input and command execution
+     * @details Handles input and command execution. Interactive by default; in
+     *          batch mode (AppOptions::batch or script_path) the banner and prompt
+     *          are skipped and output is only flushed in large chunks and at the end.
+     * @return false if the script file could not be opened
      */
-    void run();
+    bool run();
 };
 
 #endif // APP_H
\ No newline at end of file
@@ -0,0 +1,14 @@
+/**
+ * @file app_output.cpp
+ * @brief Implementation of AppOutput
+ */
+
+#include "app_output.h"
+
+void AppOutput::flush() {
+    if (!_buffer.empty()) {
+        std::fwrite(_buffer.data(), 1, _buffer.size(), _sink);
+        _buffer.clear(); // Keeps capacity for the next chunk
+    }
+    std::fflush(_sink);
+}
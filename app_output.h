@@ -0,0 +1,137 @@
+#ifndef APP_OUTPUT_H
+#define APP_OUTPUT_H
+
+/**
+ * @file app_output.h
+ * @brief Buffered console output for App
+ * @details Every handler writes through one AppOutput instead of mixing
+ *          std::cout and std::print. Text is formatted straight into a single
+ *          buffer that reaches the terminal in one write, either when it grows
+ *          past the flush threshold or when App explicitly flushes (before a
+ *          prompt, at exit). A scripted run of many commands therefore costs a
+ *          handful of write calls instead of several per command. For JSON lines
+ *          output, the text of a command can be captured instead and embedded
+ *          in that command's record.
+ */
+
+#include <cstdio>
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/**
+ * @class AppOutput
+ * @brief Output buffer in front of a C stream
+ */
+class AppOutput {
+private:
+    std::string _buffer;            ///< Pending output for the sink
+    std::string _capture;           ///< Text captured while capturing() is on
+    std::FILE* _sink;               ///< Destination stream
+    size_t _flush_threshold;        ///< Buffer size that triggers a write to the sink
+    bool _capturing = false;        ///< Whether text goes to _capture instead of _buffer
+
+    std::string& target() { return _capturing ? _capture : _buffer; }
+
+public:
+    /**
+     * @brief Default flush threshold (64 KiB)
+     */
+    static constexpr size_t DEFAULT_FLUSH_THRESHOLD = 64uz << 10;
+
+    /**
+     * @brief Construct an output buffer
+     * @param sink Destination stream
+     * @param flush_threshold Buffer size that triggers a write to the stream
+     */
+    explicit AppOutput(std::FILE* sink = stdout, size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD)
+        : _sink(sink), _flush_threshold(flush_threshold) {}
+
+    AppOutput(const AppOutput&) = delete;
+    AppOutput& operator=(const AppOutput&) = delete;
+
+    ~AppOutput() { flush(); }
+
+    /**
+     * @brief Format text into the buffer
+     * @tparam Args Format argument types
+     * @param fmt Format string
+     * @param args Format arguments
+     */
+    template<typename... Args>
+    void print(std::format_string<Args...> fmt, Args&&... args) {
+        std::format_to(std::back_inserter(target()), fmt, std::forward<Args>(args)...);
+        maybeFlush();
+    }
+
+    /**
+     * @brief Append text verbatim
+     * @param text Text to write
+     */
+    void write(std::string_view text) {
+        target() += text;
+        maybeFlush();
+    }
+
+    /**
+     * @brief Let a formatter append straight to the buffer
+     * @tparam Fn Callable taking std::string&
+     * @param fn Formatter, e.g. one of the TaskManager display methods
+     */
+    template<typename Fn>
+    void append(Fn&& fn) {
+        std::forward<Fn>(fn)(target());
+        maybeFlush();
+    }
+
+    /**
+     * @brief Append a complete line to the sink buffer, bypassing any capture
+     * @param line Line without the trailing newline
+     */
+    void writeLine(std::string_view line) {
+        _buffer += line;
+        _buffer += '\n';
+        maybeFlush();
+    }
+
+    /**
+     * @brief Start capturing text instead of buffering it for the sink
+     * @details Drops anything captured before
+     */
+    void beginCapture() {
+        _capture.clear();
+        _capturing = true;
+    }
+
+    /**
+     * @brief Stop capturing
+     * @return Text captured since beginCapture(); valid until the next capture
+     */
+    const std::string& endCapture() {
+        _capturing = false;
+        return _capture;
+    }
+
+    /**
+     * @brief Whether text is currently being captured
+     */
+    bool capturing() const { return _capturing; }
+
+    /**
+     * @brief Write the buffer out if it passed the threshold
+     */
+    void maybeFlush() {
+        if (_buffer.size() >= _flush_threshold) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Write the buffer to the sink and flush the stream
+     */
+    void flush();
+};
+
+#endif // APP_OUTPUT_H
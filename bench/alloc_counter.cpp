@@ -0,0 +1,66 @@
+/**
+ * @file alloc_counter.cpp
+ * @brief Counting replacements of the global allocation functions
+ * @details Only the plain and array forms are replaced; the nothrow, sized and
+ *          aligned forms of the standard library forward to them or are not
+ *          used by the code under test
+ */
+
+#include "alloc_counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+std::atomic<std::uint64_t> g_alloc_count{0};
+std::atomic<std::uint64_t> g_alloc_bytes{0};
+
+void* countedAlloc(std::size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace bench {
+
+AllocStats allocStats() {
+    return {
+        .count = g_alloc_count.load(std::memory_order_relaxed),
+        .bytes = g_alloc_bytes.load(std::memory_order_relaxed)
+    };
+}
+
+size_t peakRssBytes() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);           // Bytes
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024uz;  // Kilobytes
+#endif
+#else
+    return 0;
+#endif
+}
+
+} // namespace bench
@@ -0,0 +1,40 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+/**
+ * @file alloc_counter.h
+ * @brief Heap allocation counters and peak RSS for TaskTrackerBench
+ * @details alloc_counter.cpp replaces the global operator new/delete of the
+ *          benchmark executable only, so every allocation made by the code under
+ *          test, including standard containers, is counted
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bench {
+
+/**
+ * @struct AllocStats
+ * @brief Totals since process start
+ */
+struct AllocStats {
+    std::uint64_t count = 0;    ///< Number of operator new calls
+    std::uint64_t bytes = 0;    ///< Bytes requested from operator new
+};
+
+/**
+ * @brief Read the allocation totals
+ * @return Totals across all threads
+ */
+AllocStats allocStats();
+
+/**
+ * @brief Peak resident set size of the process
+ * @return Bytes, or 0 where the platform does not report it
+ */
+size_t peakRssBytes();
+
+} // namespace bench
+
+#endif // ALLOC_COUNTER_H
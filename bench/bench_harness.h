@@ -0,0 +1,114 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+/**
+ * @file bench_harness.h
+ * @brief Minimal self-contained benchmark harness for TaskTrackerBench
+ * @details Runs a callable repeatedly until a time budget is spent and reports
+ *          ns/op, heap allocations and bytes allocated per op and, when a byte
+ *          count is given, throughput in MB/s
+ */
+
+#include "alloc_counter.h"
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <format>
+#include <print>
+#include <utility>
+
+namespace bench {
+
+/**
+ * @struct Result
+ * @brief Timing summary of one benchmark case
+ */
+struct Result {
+    std::string name;       ///< Case name
+    size_t iterations = 0;  ///< Number of timed runs
+    double ns_per_op = 0.0; ///< Mean wall time per run
+    double mb_per_s = 0.0;  ///< Throughput (0 if no byte count was given)
+    double allocs_per_op = 0.0;      ///< Mean operator new calls per run
+    double alloc_bytes_per_op = 0.0; ///< Mean bytes allocated per run
+};
+
+/**
+ * @brief Prevent the optimizer from discarding a computed value
+ * @tparam T Value type
+ * @param value Value to keep alive
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief Time a callable
+ * @tparam Fn Callable taking no arguments
+ * @param name Case name used in the report
+ * @param bytes_per_op Bytes processed by one call (0 to skip MB/s)
+ * @param fn Work to measure
+ * @param budget Minimum total time to spend measuring
+ * @return Timing summary
+ */
+template<typename Fn>
+Result run(std::string_view name, size_t bytes_per_op, Fn&& fn,
+           std::chrono::milliseconds budget = std::chrono::milliseconds(500)) {
+    using clock = std::chrono::steady_clock;
+
+    fn(); // Warm-up run, not timed
+
+    Result result{.name = std::string(name)};
+    const AllocStats allocs_before = allocStats();
+    auto start = clock::now();
+    auto elapsed = clock::duration::zero();
+    do {
+        fn();
+        ++result.iterations;
+        elapsed = clock::now() - start;
+    } while (elapsed < budget || result.iterations < 3);
+    const AllocStats allocs_after = allocStats();
+
+    const auto runs = static_cast<double>(result.iterations);
+    result.allocs_per_op = static_cast<double>(allocs_after.count - allocs_before.count) / runs;
+    result.alloc_bytes_per_op = static_cast<double>(allocs_after.bytes - allocs_before.bytes) / runs;
+
+    double total_ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    result.ns_per_op = total_ns / static_cast<double>(result.iterations);
+    if (bytes_per_op > 0) {
+        result.mb_per_s = (static_cast<double>(bytes_per_op) / (1024.0 * 1024.0)) /
+                          (result.ns_per_op / 1e9);
+    }
+    return result;
+}
+
+/**
+ * @brief Print one result line
+ * @param result Result to print
+ */
+inline void report(const Result& result) {
+    std::string throughput = result.mb_per_s > 0.0 ? std::format("{:.1f} MB/s", result.mb_per_s) : "";
+    std::print("{:<44} {:>14.0f} ns/op {:>12} {:>12.1f} allocs/op {:>14.0f} B/op  ({} runs)\n",
+               result.name, result.ns_per_op, throughput, result.allocs_per_op,
+               result.alloc_bytes_per_op, result.iterations);
+}
+
+/**
+ * @brief Print the peak resident set size so far
+ * @details The peak only grows, so run scales from small to large to see each
+ * @param label What was just measured
+ */
+inline void reportPeakRss(std::string_view label) {
+    if (size_t bytes = peakRssBytes()) {
+        std::print("-- peak RSS after {}: {:.1f} MiB\n", label, static_cast<double>(bytes) / (1024.0 * 1024.0));
+    }
+}
+
+} // namespace bench
+
+#endif // BENCH_HARNESS_H
@@ -0,0 +1,740 @@
+/**
+ * @file bench_main.cpp
+ * @brief Entry point of TaskTrackerBench
+ * @details Usage: TaskTrackerBench [task_count...]
+ *          Runs every section once per task count, smallest first. The default
+ *          scales are 1k, 100k and 1M tasks. Command line dispatch does not
+ *          depend on the task count and runs once before the first scale.
+ */
+
+#include "bench_harness.h"
+#include "legacy_json.h"
+#include "task_generator.h"
+#include "task_json.h"
+#include "task_manager.h"
+#include "task_matrix.h"
+#include "string_search.h"
+#include "parallel.h"
+#include "shared_task_manager.h"
+#include "timestamp.h"
+#include "command_tokenizer.h"
+#include "task_sort.h"
+#include "task_autosave.h"
+#include "sharded_task_store.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <format>
+#include <iomanip>
+#include <numeric>
+#include <print>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<size_t> parseCounts(int argc, char* argv[]) {
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        size_t value = 0;
+        auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+        if (ec == std::errc{} && ptr == arg.data() + arg.size() && value > 0) {
+            counts.push_back(value);
+        } else {
+            std::print(stderr, "Ignoring invalid task count '{}'\n", arg);
+        }
+    }
+    if (counts.empty()) {
+        counts = {1'000, 100'000, 1'000'000};
+    }
+    std::ranges::sort(counts);
+    return counts;
+}
+
+void benchJsonParse(const TaskManager& base) {
+    const size_t task_count = base.getTaskCount();
+    TaskManager manager = base;
+    const std::string json = manager.toJsonString();
+
+    std::print("\n== JSON load ({} tasks, {} bytes) ==\n", task_count, json.size());
+
+    bench::report(bench::run("legacy substring parser", json.size(), [&] {
+        auto tasks = legacyParseTasks(json);
+        bench::doNotOptimize(tasks);
+    }));
+
+    bench::report(bench::run("TaskJsonReader (parseTaskDocument)", json.size(), [&] {
+        std::vector<Task> tasks;
+        auto info = parseTaskDocument(json, tasks);
+        bench::doNotOptimize(info);
+        bench::doNotOptimize(tasks);
+    }));
+
+    const unsigned workers = parallel::resolveWorkerCount(0);
+    bench::report(bench::run(std::format("parseTaskDocument, {} workers", workers), json.size(), [&] {
+        std::vector<Task> tasks;
+        auto info = parseTaskDocument(json, tasks, workers);
+        bench::doNotOptimize(info);
+        bench::doNotOptimize(tasks);
+    }));
+
+    std::print("\n== JSON save ({} tasks) ==\n", task_count);
+
+    bench::report(bench::run("toJsonString, 1 worker", json.size(), [&] {
+        bench::doNotOptimize(manager.toJsonString());
+    }));
+
+    manager.setWorkerCount(workers);
+    bench::report(bench::run(std::format("toJsonString, {} workers", workers), json.size(), [&] {
+        bench::doNotOptimize(manager.toJsonString());
+    }));
+}
+
+void benchJsonFiles(const TaskManager& base) {
+    const size_t task_count = base.getTaskCount();
+    const auto path = (std::filesystem::temp_directory_path() / "tasktracker_bench.json").string();
+    if (!base.saveToJson(path)) {
+        std::print(stderr, "Cannot write {}, skipping file benchmarks\n", path);
+        return;
+    }
+    const size_t bytes = std::filesystem::file_size(path);
+
+    std::print("\n== JSON files ({} tasks, {} bytes) ==\n", task_count, bytes);
+
+    bench::report(bench::run("saveToJson", bytes, [&] {
+        bench::doNotOptimize(base.saveToJson(path));
+    }));
+
+    TaskManager manager;
+    bench::report(bench::run("loadFromJson", bytes, [&] {
+        bench::doNotOptimize(manager.loadFromJson(path));
+    }));
+
+    // One object at a time, the way an import of single records would go
+    const std::string task_json = base.getTaskByIndex(task_count / 2).toJson();
+    bench::report(bench::run("Task::fromJson (one task)", task_json.size(), [&] {
+        bench::doNotOptimize(Task::fromJson(task_json));
+    }));
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+void benchSegments(const TaskManager& base) {
+    const size_t task_count = base.getTaskCount();
+    const auto directory = (std::filesystem::temp_directory_path() / "tasktracker_bench.segments").string();
+    const auto other_directory = directory + ".other";
+    TaskManager manager = base;
+
+    std::print("\n== segmented save ({} tasks) ==\n", task_count);
+
+    // Switching directories makes every save a full one
+    int full_saves = 0;
+    bench::report(bench::run("saveToSegments, every segment", 0, [&] {
+        bench::doNotOptimize(manager.saveToSegments(++full_saves % 2 ? other_directory : directory));
+    }));
+    if (full_saves % 2) {
+        manager.saveToSegments(directory);
+    }
+
+    // The workload this layout is for: a few hundred scattered changes, then save
+    const int first_id = manager.getTaskByIndex(0).getId();
+    const int id_span = static_cast<int>(task_count);
+    int round = 0;
+    bench::report(bench::run("saveToSegments after 300 updates", 0, [&] {
+        ++round;
+        for (int i = 0; i < 300; ++i) {
+            int id = first_id + static_cast<int>((static_cast<long long>(i) * 7919 + round) % id_span);
+            manager.updateTaskPriority(id, (i + round) % 11);
+        }
+        bench::doNotOptimize(manager.saveToSegments(directory));
+    }));
+
+    bench::report(bench::run("saveToSegments, nothing changed", 0, [&] {
+        bench::doNotOptimize(manager.saveToSegments(directory));
+    }));
+
+    bench::report(bench::run("loadFromSegments", 0, [&] {
+        bench::doNotOptimize(manager.loadFromSegments(directory));
+    }));
+
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+    std::filesystem::remove_all(other_directory, ec);
+}
+
+void benchAutosave(const TaskManager& base) {
+    const size_t task_count = base.getTaskCount();
+    const auto path = (std::filesystem::temp_directory_path() / "tasktracker_bench_autosave.json").string();
+    TaskManager manager = base;
+
+    std::print("\n== Autosave ({} tasks) ==\n", task_count);
+
+    // What the interactive thread paid before: the whole save, on the command path
+    bench::report(bench::run("saveToJson (blocking)", 0, [&] {
+        bench::doNotOptimize(manager.saveToJson(path));
+    }));
+
+    // After 300 scattered updates only the touched segments are copied at handoff
+    TaskAutosave autosave(AutosaveOptions{.path = path, .interval = std::chrono::seconds(0), .changes = 0});
+    autosave.saveNow(manager);
+    autosave.wait();
+    const int first_id = manager.getTaskByIndex(0).getId();
+    const int id_span = static_cast<int>(task_count);
+    int round = 0;
+    std::chrono::nanoseconds handoff{0};
+    bench::report(bench::run("autosave write after 300 updates", 0, [&] {
+        ++round;
+        for (int i = 0; i < 300; ++i) {
+            int id = first_id + static_cast<int>((static_cast<long long>(i) * 7919 + round) % id_span);
+            manager.updateTaskPriority(id, (i + round) % 11);
+        }
+        autosave.saveNow(manager);
+        autosave.wait();
+        handoff = autosave.status().last_handoff;
+    }));
+    std::print("  interactive-thread snapshot of the last round: {:.3f} ms\n", handoff.count() / 1e6);
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+void benchShards(const TaskManager& base) {
+    constexpr size_t SHARDS = 4;
+    const size_t task_count = base.getTaskCount();
+    const auto dir = std::filesystem::temp_directory_path();
+    std::vector<std::string> paths;
+    size_t bytes = 0;
+    for (size_t i = 0; i < SHARDS; ++i) {
+        TaskManager team;
+        bench::generateTasks(team, std::max(task_count / SHARDS, 1uz), static_cast<unsigned>(42 + i));
+        paths.push_back((dir / std::format("tasktracker_bench_team{}.json", i)).string());
+        if (!team.saveToJson(paths.back())) {
+            std::print(stderr, "Cannot write {}, skipping shard benchmarks\n", paths.back());
+            return;
+        }
+        bytes += std::filesystem::file_size(paths.back());
+    }
+
+    std::print("\n== {} shards ({} tasks each) ==\n", SHARDS, std::max(task_count / SHARDS, 1uz));
+
+    // Baseline: the files one after another
+    bench::report(bench::run("load files one by one", bytes, [&] {
+        for (const std::string& path : paths) {
+            TaskManager team;
+            bench::doNotOptimize(team.loadFromJson(path));
+        }
+    }));
+
+    ShardedTaskStore store;
+    store.setWorkerCount(static_cast<unsigned>(SHARDS));
+    bench::report(bench::run(std::format("loadFiles, {} workers", SHARDS), bytes, [&] {
+        bench::doNotOptimize(store.loadFiles(paths));
+    }));
+
+    // Warm sort caches: what remains is the k-way merge of four 50-task prefixes
+    bench::report(bench::run("merged top-50 by priority", 0, [&] {
+        bench::doNotOptimize(store.getSortedPage(TaskSortKey::Priority, 0, 50));
+    }));
+
+    const TaskQuery query{.min_priority = 8, .category = "Work", .sort = TaskSortKey::Created, .limit = 50};
+    bench::report(bench::run("merged query priority>=8 category=Work sort=created", 0, [&] {
+        bench::doNotOptimize(store.runQuery(query));
+    }));
+
+    bench::report(bench::run("summed counters + category counts", 0, [&] {
+        bench::doNotOptimize(store.getCounters());
+        bench::doNotOptimize(store.getCategoryCounts());
+    }));
+
+    std::error_code ec;
+    for (const std::string& path : paths) {
+        std::filesystem::remove(path, ec);
+    }
+}
+
+void benchTimestamps(const TaskManager& manager) {
+    const auto& tasks = manager.getAllTasks();
+    std::print("\n== Timestamp codec ({} timestamps) ==\n", tasks.size());
+
+    // Baseline: the previous iostream implementation through localtime_r/mktime
+    std::vector<std::string> legacy_text;
+    legacy_text.reserve(tasks.size());
+    bench::report(bench::run("put_time(localtime_r) via ostringstream", 0, [&] {
+        legacy_text.clear();
+        for (const auto& task : tasks) {
+            auto time = std::chrono::system_clock::to_time_t(task.getMetadata().created_at);
+            std::tm local_tm{};
+#ifdef _WIN32
+            localtime_s(&local_tm, &time);
+#else
+            localtime_r(&time, &local_tm);
+#endif
+            std::ostringstream oss;
+            oss << std::put_time(&local_tm, "%Y-%m-%dT%H:%M:%S");
+            legacy_text.push_back(oss.str());
+        }
+        bench::doNotOptimize(legacy_text.data());
+    }));
+
+    bench::report(bench::run("get_time + mktime via istringstream", 0, [&] {
+        std::chrono::system_clock::time_point last;
+        for (const auto& text : legacy_text) {
+            std::tm tm{};
+            std::istringstream ss(text);
+            ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+            last = std::chrono::system_clock::from_time_t(std::mktime(&tm));
+        }
+        bench::doNotOptimize(last);
+    }));
+
+    std::string buffer;
+    buffer.reserve(tasks.size() * ISO_TIMESTAMP_SIZE);
+    bench::report(bench::run("appendIsoTimestamp", tasks.size() * ISO_TIMESTAMP_SIZE, [&] {
+        buffer.clear();
+        for (const auto& task : tasks) {
+            appendIsoTimestamp(buffer, task.getMetadata().created_at);
+        }
+        bench::doNotOptimize(buffer.data());
+    }));
+
+    bench::report(bench::run("parseIsoTimestamp (UTC)", buffer.size(), [&] {
+        std::chrono::system_clock::time_point last;
+        for (size_t pos = 0; pos < buffer.size(); pos += ISO_TIMESTAMP_SIZE) {
+            last = parseIsoTimestamp(std::string_view(buffer).substr(pos, ISO_TIMESTAMP_SIZE)).value_or(last);
+        }
+        bench::doNotOptimize(last);
+    }));
+
+    // Files from before the 'Z' suffix go through the cached local time zone
+    bench::report(bench::run("parseIsoTimestamp (local, legacy files)", 0, [&] {
+        std::chrono::system_clock::time_point last;
+        for (const auto& text : legacy_text) {
+            last = parseIsoTimestamp(text).value_or(last);
+        }
+        bench::doNotOptimize(last);
+    }));
+}
+
+void benchTimeRanges(const TaskManager& manager) {
+    const auto& tasks = manager.getAllTasks();
+    std::print("\n== Time ranges ({} tasks) ==\n", tasks.size());
+    if (tasks.empty()) {
+        return;
+    }
+
+    // The newest 1% by creation time, the "created this week" shape
+    std::vector<std::chrono::system_clock::time_point> created;
+    created.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        created.push_back(task.getMetadata().created_at);
+    }
+    auto cutoff_it = created.begin() + static_cast<std::ptrdiff_t>(created.size() - created.size() / 100 - 1);
+    std::ranges::nth_element(created, cutoff_it);
+    const auto since = *cutoff_it;
+
+    bench::report(bench::run("created since, scan over Task objects", 0, [&] {
+        auto matches = manager.filterTasks([&](const Task& task) {
+            return task.getMetadata().created_at >= since;
+        });
+        bench::doNotOptimize(std::ranges::distance(matches));
+    }));
+
+    bench::report(bench::run("created since, time index", 0, [&] {
+        bench::doNotOptimize(manager.getTasksInTimeRange(TaskTime::Created, since).size());
+    }));
+
+    bench::report(bench::run("created since, time index count", 0, [&] {
+        bench::doNotOptimize(manager.countTasksInTimeRange(TaskTime::Created, since));
+    }));
+
+    const auto today = std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now());
+    bench::report(bench::run("completions per day, 30 days", 0, [&] {
+        bench::doNotOptimize(manager.countTasksPerDay(TaskTime::Completed, today - std::chrono::days(29), 30));
+    }));
+}
+
+void benchScans(const TaskManager& manager) {
+    const size_t task_count = manager.getTaskCount();
+    const size_t bytes = task_count * sizeof(Task);
+
+    std::print("\n== Filter scans ({} tasks, {} bytes of Task objects) ==\n", task_count, bytes);
+
+    // Baseline: the predicate reads each whole Task object
+    bench::report(bench::run("status scan over Task objects", bytes, [&] {
+        auto matches = manager.filterTasks([](const Task& task) {
+            return task.getStatus() == TaskStatus::Completed;
+        });
+        bench::doNotOptimize(std::ranges::distance(matches));
+    }));
+
+    bench::report(bench::run("status scan over status column", bytes, [&] {
+        bench::doNotOptimize(std::ranges::distance(manager.getTasksByStatus(TaskStatus::Completed)));
+    }));
+
+    bench::report(bench::run("priority 7-10 scan over Task objects", bytes, [&] {
+        auto matches = manager.filterTasks([](const Task& task) {
+            return task.getMetadata().priority >= 7;
+        });
+        bench::doNotOptimize(std::ranges::distance(matches));
+    }));
+
+    bench::report(bench::run("priority 7-10 scan over priority column", bytes, [&] {
+        bench::doNotOptimize(std::ranges::distance(manager.getTasksByPriority(7, 10)));
+    }));
+
+    bench::report(bench::run("category scan over Task objects", bytes, [&] {
+        auto matches = manager.filterTasks([](const Task& task) {
+            return task.getMetadata().category == "Work";
+        });
+        bench::doNotOptimize(std::ranges::distance(matches));
+    }));
+
+    bench::report(bench::run("category scan over category-id column", bytes, [&] {
+        bench::doNotOptimize(std::ranges::distance(manager.getTasksByCategory("Work")));
+    }));
+}
+
+void benchFind(const TaskManager& manager) {
+    const size_t task_count = manager.getTaskCount();
+
+    std::print("\n== find ({} tasks) ==\n", task_count);
+
+    // Baseline: the previous handleFind, three lowered copies per task per query
+    bench::report(bench::run("lowercase-copy scan 'report'", 0, [&] {
+        auto to_lower = [](std::string str) {
+            std::ranges::transform(str, str.begin(), ::tolower);
+            return str;
+        };
+        std::string keyword = to_lower("report");
+        auto matches = manager.filterTasks([&](const Task& task) {
+            return to_lower(task.getTitle()).contains(keyword) ||
+                   to_lower(task.getDescription()).contains(keyword);
+        });
+        bench::doNotOptimize(std::ranges::distance(matches));
+    }));
+
+    bench::report(bench::run("inverted index 'report'", 0, [&] {
+        bench::doNotOptimize(manager.findTasks("report"));
+    }));
+
+    bench::report(bench::run("inverted index prefix AND 'rep sched'", 0, [&] {
+        bench::doNotOptimize(manager.findTasks("rep sched"));
+    }));
+}
+
+void benchSort(const TaskManager& base) {
+    const size_t task_count = base.getTaskCount();
+    TaskManager manager = base;
+    const int first_id = manager.getTaskByIndex(0).getId();
+    int bump = 0;
+
+    std::print("\n== sort priority ({} tasks) ==\n", task_count);
+
+    // Baseline: the previous handleSort, a full copy of every Task sorted
+    bench::report(bench::run("copy + full sort", 0, [&] {
+        auto sorted = manager.getSortedTasks([](const Task& a, const Task& b) {
+            return a.getMetadata().priority > b.getMetadata().priority;
+        });
+        bench::doNotOptimize(sorted);
+    }));
+
+    // Changing a priority drops the cached order, so every page is a fresh partial_sort
+    bench::report(bench::run("top-50 page after a priority change", 0, [&] {
+        manager.updateTaskPriority(first_id, ++bump % 11);
+        bench::doNotOptimize(manager.getSortedPage(TaskSortKey::Priority, 0, 50));
+    }));
+
+    bench::report(bench::run("page 3 of 50 from cached order", 0, [&] {
+        bench::doNotOptimize(manager.getSortedPage(TaskSortKey::Priority, 100, 50));
+    }));
+
+    // Full order on two keys over the hot columns: comparison sort against packed-key radix sort
+    const TaskRows rows{manager.getAllTasks(), manager.hasColumnarScans() ? &manager.getColumns() : nullptr};
+    std::vector<size_t> slots(task_count);
+    bench::report(bench::run("priority,created slots, std::sort", 0, [&] {
+        std::iota(slots.begin(), slots.end(), 0uz);
+        std::ranges::sort(slots, PriorityCreatedSort::slotOrder(rows));
+        bench::doNotOptimize(slots);
+    }));
+    bench::report(bench::run("priority,created slots, radix sort", 0, [&] {
+        std::iota(slots.begin(), slots.end(), 0uz);
+        bench::doNotOptimize(radixSortSlots<PriorityCreatedSort>(rows, slots));
+    }));
+
+    const unsigned workers = parallel::resolveWorkerCount(0);
+    manager.setWorkerCount(workers);
+    bench::report(bench::run(std::format("copy + full sort, {} workers", workers), 0, [&] {
+        auto sorted = manager.getSortedTasks([](const Task& a, const Task& b) {
+            return a.getMetadata().priority > b.getMetadata().priority;
+        });
+        bench::doNotOptimize(sorted);
+    }));
+}
+
+void benchMatrix(const TaskManager& manager) {
+    const auto& tasks = manager.getAllTasks();
+
+    std::print("\n== TaskMatrix ({} tasks) ==\n", tasks.size());
+
+    bench::report(bench::run("addTask x n", 0, [&] {
+        TaskMatrix matrix;
+        for (const auto& task : tasks) matrix.addTask(task);
+        bench::doNotOptimize(matrix.getTotalTaskCount());
+    }));
+
+    bench::report(bench::run("addTask x n, then removeTask x n", 0, [&] {
+        TaskMatrix matrix;
+        for (const auto& task : tasks) matrix.addTask(task);
+        for (const auto& task : tasks) matrix.removeTask(task);
+        bench::doNotOptimize(matrix.getTotalTaskCount());
+    }));
+}
+
+void benchStats(const TaskManager& manager) {
+    std::print("\n== stats ({} tasks) ==\n", manager.getTaskCount());
+
+    // Baseline: one pass over the tasks per status, as a stats command without counters would do
+    bench::report(bench::run("count_if per status over Task objects", 0, [&] {
+        std::array<size_t, StatusCounters::STATUS_COUNT> counts{};
+        for (size_t status = 0; status < counts.size(); ++status) {
+            counts[status] = static_cast<size_t>(std::ranges::count_if(manager.getAllTasks(), [status](const Task& task) {
+                return static_cast<size_t>(task.getStatus()) == status;
+            }));
+        }
+        bench::doNotOptimize(counts);
+    }));
+
+    bench::report(bench::run("StatusCounters + getCompletionRate", 0, [&] {
+        bench::doNotOptimize(manager.getCounters());
+        bench::doNotOptimize(manager.getCompletionRate());
+    }));
+}
+
+void benchBatch(const TaskManager& base) {
+    const size_t task_count = base.getTaskCount();
+    TaskManager manager = base;
+    constexpr size_t UPDATES = 1000;
+
+    // Same mix of status/priority/category changes for both paths
+    std::vector<TaskUpdate> updates;
+    updates.reserve(UPDATES);
+    for (size_t i = 0; i < UPDATES; ++i) {
+        int id = manager.getTaskByIndex(i * 7919 % task_count).getId();
+        switch (i % 3) {
+            case 0: updates.push_back(TaskUpdate::status(id, i % 2 ? TaskStatus::Completed : TaskStatus::Pending)); break;
+            case 1: updates.push_back(TaskUpdate::priority(id, static_cast<int>(i % 11))); break;
+            default: updates.push_back(TaskUpdate::category(id, i % 2 ? "Work" : "Personal")); break;
+        }
+    }
+
+    std::print("\n== {} updates ({} tasks) ==\n", UPDATES, task_count);
+
+    bench::report(bench::run("one updateTask* call per update", 0, [&] {
+        for (const auto& update : updates) {
+            switch (update.field) {
+                case TaskUpdate::Field::Status: manager.updateTaskStatus(update.id, static_cast<TaskStatus>(update.value)); break;
+                case TaskUpdate::Field::Priority: manager.updateTaskPriority(update.id, update.value); break;
+                default: manager.updateTaskCategory(update.id, update.text); break;
+            }
+        }
+    }));
+
+    bench::report(bench::run("applyBatch", 0, [&] {
+        bench::doNotOptimize(manager.applyBatch(updates));
+    }));
+}
+
+void benchConcurrentUpdates(const TaskManager& base) {
+    const size_t task_count = base.getTaskCount();
+    SharedTaskManager shared;
+    shared.write([&](TaskManager& manager) { manager = base; });
+    const int first_id = shared.read([](const TaskManager& manager) { return manager.getTaskByIndex(0).getId(); });
+    constexpr unsigned SCANNERS = 3;
+
+    std::print("\n== status updates with {} concurrent full scans ({} tasks) ==\n", SCANNERS, task_count);
+
+    // Scanners loop until stopped; the timed work is one status update on this thread
+    auto withScanners = [&](std::string_view name, auto scan) {
+        std::atomic<bool> stop{false};
+        {
+            std::vector<std::jthread> scanners;
+            for (unsigned i = 0; i < SCANNERS; ++i) {
+                scanners.emplace_back([&] {
+                    while (!stop.load(std::memory_order_relaxed)) scan();
+                });
+            }
+            int flip = 0;
+            bench::report(bench::run(name, 0, [&] {
+                auto status = (++flip & 1) ? TaskStatus::InProgress : TaskStatus::Pending;
+                bench::doNotOptimize(shared.updateTaskStatus(first_id, status));
+            }));
+            stop = true;
+        }
+    };
+
+    withScanners("update while scanning under shared lock", [&] {
+        shared.read([](const TaskManager& manager) {
+            bench::doNotOptimize(std::ranges::distance(manager.filterTasks([](const Task& task) {
+                return task.getDescription().contains("backup");
+            })));
+        });
+    });
+
+    withScanners("update while scanning a snapshot", [&] {
+        auto snapshot = shared.snapshot();
+        bench::doNotOptimize(std::ranges::distance(snapshot->filter([](const Task& task) {
+            return task.getDescription().contains("backup");
+        })));
+    });
+}
+
+void benchStringSearch(const TaskManager& manager) {
+    const size_t task_count = manager.getTaskCount();
+    const auto& tasks = manager.getAllTasks();
+
+    size_t bytes = 0;
+    for (const auto& task : tasks) {
+        bytes += task.getTitle().size() + task.getDescription().size();
+    }
+
+    std::print("\n== Case-insensitive substring scan ({} tasks, {} bytes, active kernel: {}) ==\n",
+               task_count, bytes, stringSearchImplName(activeStringSearchImpl()));
+
+    // Baseline: the previous handleFind predicate
+    bench::report(bench::run("tolower copies + contains", bytes, [&] {
+        auto to_lower = [](std::string str) {
+            std::ranges::transform(str, str.begin(), ::tolower);
+            return str;
+        };
+        std::string keyword = to_lower("Schedule");
+        size_t matches = 0;
+        for (const auto& task : tasks) {
+            matches += to_lower(task.getTitle()).contains(keyword) ||
+                       to_lower(task.getDescription()).contains(keyword);
+        }
+        bench::doNotOptimize(matches);
+    }));
+
+    for (auto impl : {StringSearchImpl::Scalar, StringSearchImpl::SSE2, StringSearchImpl::AVX2}) {
+        if (!isStringSearchImplSupported(impl)) continue;
+        auto name = std::format("containsIgnoreCase ({})", stringSearchImplName(impl));
+        bench::report(bench::run(name, bytes, [&] {
+            size_t matches = 0;
+            for (const auto& task : tasks) {
+                matches += containsIgnoreCase(task.getTitle(), "Schedule", impl) ||
+                           containsIgnoreCase(task.getDescription(), "Schedule", impl);
+            }
+            bench::doNotOptimize(matches);
+        }));
+    }
+}
+
+void benchCommandLines() {
+    // A scripted session: mostly updates, some adds and searches
+    constexpr size_t line_count = 10'000;
+    std::vector<std::string> lines;
+    lines.reserve(line_count);
+    for (size_t i = 0; i < line_count; ++i) {
+        switch (i % 4) {
+            case 0: lines.push_back(std::format("status {} completed", i)); break;
+            case 1: lines.push_back(std::format("priority {} {}", i, i % 11)); break;
+            case 2: lines.push_back(std::format("add \"Weekly report {}\" \"Summarize the sprint\"", i)); break;
+            default: lines.push_back("find report schedule"); break;
+        }
+    }
+    constexpr size_t history = 10;
+    std::print("\n== Command line dispatch ({} lines) ==\n", line_count);
+
+    // Baseline: the previous istringstream tokenizer, args copy and history erase
+    bench::report(bench::run("istringstream tokens + args copy + history erase", 0, [&] {
+        std::vector<std::string> recent;
+        size_t total_args = 0;
+        for (const auto& line : lines) {
+            std::vector<std::string> tokens;
+            std::istringstream iss(line);
+            bool in_quotes = false;
+            std::string current_token;
+            char c;
+            while (iss.get(c)) {
+                if (c == '"') {
+                    in_quotes = !in_quotes;
+                } else if (c == ' ' && !in_quotes) {
+                    if (!current_token.empty()) {
+                        tokens.push_back(current_token);
+                        current_token.clear();
+                    }
+                } else {
+                    current_token += c;
+                }
+            }
+            if (!current_token.empty()) {
+                tokens.push_back(current_token);
+            }
+            std::vector<std::string> args(tokens.begin() + 1, tokens.end());
+            if (recent.size() >= history) {
+                recent.erase(recent.begin());
+            }
+            recent.push_back(tokens[0]);
+            total_args += args.size();
+        }
+        bench::doNotOptimize(total_args);
+    }));
+
+    CommandTokenizer tokenizer;
+    std::array<std::string, history> recent;
+    size_t recent_next = 0;
+    bench::report(bench::run("CommandTokenizer views + history ring", 0, [&] {
+        size_t total_args = 0;
+        for (const auto& line : lines) {
+            auto tokens = tokenizer.tokenize(line);
+            auto args = tokens.subspan(1);
+            recent[recent_next].assign(tokens[0]);
+            recent_next = (recent_next + 1) % history;
+            total_args += args.size();
+        }
+        bench::doNotOptimize(total_args);
+    }));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Independent of the task count
+    benchCommandLines();
+
+    for (size_t task_count : parseCounts(argc, argv)) {
+        std::print("\n######## {} tasks ########\n", task_count);
+
+        // Generated once per scale; sections that mutate work on a copy
+        TaskManager base;
+        bench::generateTasks(base, task_count);
+        bench::reportPeakRss("generating the tasks");
+
+        benchJsonParse(base);
+        benchJsonFiles(base);
+        benchSegments(base);
+        benchAutosave(base);
+        benchShards(base);
+        benchTimestamps(base);
+        benchScans(base);
+        benchTimeRanges(base);
+        benchFind(base);
+        benchSort(base);
+        benchMatrix(base);
+        benchStats(base);
+        benchBatch(base);
+        benchConcurrentUpdates(base);
+        benchStringSearch(base);
+        bench::reportPeakRss(std::format("the {} task run", task_count));
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file legacy_json.cpp
+ * @brief The substring-based JSON loader that TaskJsonReader replaced
+ * @details Kept only as a baseline for TaskTrackerBench; not used by the application.
+ *          Each task object is copied with substr and every field is located with
+ *          a separate find() over that copy.
+ */
+
+#include "legacy_json.h"
+#include <cctype>
+
+namespace {
+
+std::string legacyFindValue(const std::string& json_str, const std::string& key, bool unescape) {
+    std::string search_key = "\"" + key + "\":";
+    size_t pos = json_str.find(search_key);
+    if (pos == std::string::npos) return "";
+
+    pos += search_key.length();
+    while (pos < json_str.length() && std::isspace(static_cast<unsigned char>(json_str[pos]))) ++pos;
+
+    if (pos >= json_str.length()) return "";
+
+    if (json_str[pos] == '"') {
+        ++pos;
+        size_t end_pos = pos;
+        while (end_pos < json_str.length() && json_str[end_pos] != '"') {
+            if (json_str[end_pos] == '\\') ++end_pos;
+            ++end_pos;
+        }
+        std::string value = json_str.substr(pos, end_pos - pos);
+        return unescape ? unescapeJsonString(value) : value;
+    }
+
+    size_t end_pos = pos;
+    while (end_pos < json_str.length() &&
+           json_str[end_pos] != ',' &&
+           json_str[end_pos] != '}' &&
+           json_str[end_pos] != '\n' &&
+           json_str[end_pos] != '\r') {
+        ++end_pos;
+    }
+    std::string value = json_str.substr(pos, end_pos - pos);
+    value.erase(0, value.find_first_not_of(" \t\n\r"));
+    value.erase(value.find_last_not_of(" \t\n\r") + 1);
+    return value;
+}
+
+std::expected<Task, JsonError> legacyTaskFromJson(const std::string& json_str) {
+    try {
+        std::string id_str = legacyFindValue(json_str, "id", true);
+        std::string title = legacyFindValue(json_str, "title", true);
+        std::string description = legacyFindValue(json_str, "description", true);
+        std::string status_str = legacyFindValue(json_str, "status", true);
+        std::string category = legacyFindValue(json_str, "category", true);
+        std::string priority_str = legacyFindValue(json_str, "priority", true);
+        std::string created_at_str = legacyFindValue(json_str, "created_at", true);
+        std::string updated_at_str = legacyFindValue(json_str, "updated_at", true);
+        std::string completed_at_str = legacyFindValue(json_str, "completed_at", true);
+
+        if (id_str.empty() || title.empty()) {
+            return std::unexpected(JsonError::InvalidFormat);
+        }
+
+        auto status_opt = stringToTaskStatus(status_str);
+        if (!status_opt) {
+            return std::unexpected(JsonError::InvalidFormat);
+        }
+
+        Task task(std::stoi(id_str), title, description, *status_opt);
+        if (!category.empty()) task.setCategory(category);
+        if (!priority_str.empty()) task.setPriority(std::stoi(priority_str));
+        if (!created_at_str.empty()) task.getMetadata().created_at = isoStringToTimePoint(created_at_str);
+        if (!updated_at_str.empty()) task.getMetadata().updated_at = isoStringToTimePoint(updated_at_str);
+        if (!completed_at_str.empty()) task.getMetadata().completed_at = isoStringToTimePoint(completed_at_str);
+        return task;
+    } catch (const std::exception&) {
+        return std::unexpected(JsonError::ParseError);
+    }
+}
+
+} // namespace
+
+std::expected<std::vector<Task>, JsonError> legacyParseTasks(const std::string& json_str) {
+    std::vector<Task> tasks;
+
+    size_t tasks_pos = json_str.find("\"tasks\":");
+    if (tasks_pos == std::string::npos) return std::unexpected(JsonError::InvalidFormat);
+
+    size_t array_start = json_str.find("[", tasks_pos);
+    if (array_start == std::string::npos) return std::unexpected(JsonError::InvalidFormat);
+
+    size_t array_end = json_str.find("]", array_start);
+    if (array_end == std::string::npos) return std::unexpected(JsonError::InvalidFormat);
+
+    size_t pos = array_start + 1;
+    while (pos < array_end) {
+        size_t obj_start = json_str.find("{", pos);
+        if (obj_start >= array_end) break;
+
+        size_t obj_end = obj_start + 1;
+        int brace_count = 1;
+        while (obj_end < array_end && brace_count > 0) {
+            if (json_str[obj_end] == '{') ++brace_count;
+            else if (json_str[obj_end] == '}') --brace_count;
+            ++obj_end;
+        }
+
+        if (brace_count == 0) {
+            auto task = legacyTaskFromJson(json_str.substr(obj_start, obj_end - obj_start));
+            if (!task) return std::unexpected(task.error());
+            tasks.push_back(std::move(*task));
+        }
+        pos = obj_end;
+    }
+    return tasks;
+}
@@ -0,0 +1,21 @@
+#ifndef LEGACY_JSON_H
+#define LEGACY_JSON_H
+
+/**
+ * @file legacy_json.h
+ * @brief Baseline copy of the pre-TaskJsonReader loader for benchmark comparison
+ */
+
+#include "task.h"
+#include <string>
+#include <vector>
+#include <expected>
+
+/**
+ * @brief Parse a task document with the old substring-based algorithm
+ * @param json_str Full document text
+ * @return Parsed tasks, or the error the old loader would have reported
+ */
+std::expected<std::vector<Task>, JsonError> legacyParseTasks(const std::string& json_str);
+
+#endif // LEGACY_JSON_H
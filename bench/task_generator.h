@@ -0,0 +1,58 @@
+#ifndef TASK_GENERATOR_H
+#define TASK_GENERATOR_H
+
+/**
+ * @file task_generator.h
+ * @brief Deterministic synthetic task sets for TaskTrackerBench
+ */
+
+#include "task_manager.h"
+#include <array>
+#include <format>
+#include <random>
+#include <string>
+
+namespace bench {
+
+/**
+ * @brief Fill a TaskManager with a reproducible mix of tasks
+ * @details Titles are unique, descriptions vary in length up to the repo limit,
+ *          and categories/priorities/statuses follow a fixed pseudo-random mix
+ * @param manager Manager to fill (should be empty)
+ * @param count Number of tasks to add
+ * @param seed Random seed
+ */
+inline void generateTasks(TaskManager& manager, size_t count, unsigned seed = 42) {
+    static constexpr std::array categories{"General", "Work", "Personal", "Shopping", "School", "Health"};
+    static constexpr std::array words{"deploy", "review", "report", "meeting", "invoice", "backup",
+                                      "release", "design", "refactor", "budget", "schedule", "email"};
+    static constexpr std::array statuses{TaskStatus::Pending, TaskStatus::InProgress,
+                                         TaskStatus::Completed, TaskStatus::Cancelled};
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> word_dist(0, words.size() - 1);
+    std::uniform_int_distribution<size_t> length_dist(20, maxTaskDescriptionLength());
+
+    for (size_t i = 0; i < count; ++i) {
+        std::string title = std::format("{} {} #{}", words[word_dist(rng)], words[word_dist(rng)], i);
+
+        std::string description;
+        size_t target_length = length_dist(rng);
+        while (description.size() < target_length) {
+            description += words[word_dist(rng)];
+            description += ' ';
+        }
+        description.resize(target_length);
+
+        auto id = manager.addTask(title, description);
+        if (!id) continue;
+
+        manager.updateTaskCategory(*id, categories[rng() % categories.size()]);
+        manager.updateTaskPriority(*id, static_cast<int>(rng() % 11));
+        manager.updateTaskStatus(*id, statuses[rng() % statuses.size()]);
+    }
+}
+
+} // namespace bench
+
+#endif // TASK_GENERATOR_H
@@ -0,0 +1,44 @@
+/**
+ * @file command_tokenizer.cpp
+ * @brief Implementation of CommandTokenizer
+ */
+
+#include "command_tokenizer.h"
+
+std::span<const std::string_view> CommandTokenizer::tokenize(std::string_view line) {
+    _tokens.clear();
+    _chars.clear();
+    // The text of the tokens never exceeds the line, so the views below stay valid
+    _chars.reserve(line.size());
+
+    size_t token_start = 0;
+    auto finishToken = [&] {
+        if (_chars.size() > token_start) {
+            _tokens.emplace_back(_chars.data() + token_start, _chars.size() - token_start);
+            token_start = _chars.size();
+        }
+    };
+
+    bool in_quotes = false;
+    size_t pos = 0;
+    while (pos < line.size()) {
+        // Copy the run up to the next separator or quote in one step
+        size_t next = in_quotes ? line.find('"', pos) : line.find_first_of(" \"", pos);
+        if (next == std::string_view::npos) {
+            next = line.size();
+        }
+        _chars.append(line, pos, next - pos);
+        if (next == line.size()) {
+            break;
+        }
+        if (line[next] == '"') {
+            in_quotes = !in_quotes;
+        } else {
+            finishToken();
+        }
+        pos = next + 1;
+    }
+    finishToken();
+
+    return _tokens;
+}
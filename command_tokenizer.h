@@ -0,0 +1,40 @@
+#ifndef COMMAND_TOKENIZER_H
+#define COMMAND_TOKENIZER_H
+
+/**
+ * @file command_tokenizer.h
+ * @brief Reusable splitter for command lines
+ * @details Tokens are separated by spaces; double quotes group spaces into one
+ *          token and are removed. The unquoted text of all tokens is copied back
+ *          to back into one buffer owned by the tokenizer and handed out as
+ *          string_views, so once the buffers have grown to the longest line seen,
+ *          tokenizing a line allocates nothing.
+ */
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class CommandTokenizer
+ * @brief Splits command lines into string_view tokens backed by reused buffers
+ * @details The tokens of one call stay valid until the next call on the same
+ *          tokenizer; code that tokenizes while a caller still holds tokens (the
+ *          'batch' command inside a command) needs a tokenizer of its own.
+ */
+class CommandTokenizer {
+private:
+    std::string _chars;                     ///< Unquoted token text, back to back
+    std::vector<std::string_view> _tokens;  ///< Views into _chars
+
+public:
+    /**
+     * @brief Split a line into tokens
+     * @param line Command line without the trailing newline
+     * @return Tokens, valid until the next tokenize() call
+     */
+    std::span<const std::string_view> tokenize(std::string_view line);
+};
+
+#endif // COMMAND_TOKENIZER_H
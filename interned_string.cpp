@@ -0,0 +1,93 @@
+/**
+ * @file interned_string.cpp
+ * @brief The process-wide string pool behind InternedString
+ */
+
+#include "interned_string.h"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include "string_hash.h"
+
+namespace {
+
+/**
+ * @struct Pool
+ * @brief Entries in id order plus a text -> entry index
+ * @details A deque keeps entry addresses stable as the pool grows
+ */
+struct Pool {
+    std::shared_mutex mutex;
+    std::deque<InternedString::Entry> entries;
+    std::unordered_map<std::string_view, const InternedString::Entry*, TransparentStringHash, std::equal_to<>> index;
+
+    Pool() {
+        const auto& empty = entries.emplace_back(InternedString::Entry{.text = {}, .id = 0});
+        index.emplace(empty.text, &empty);
+    }
+
+    const InternedString::Entry* lookup(std::string_view text) {
+        auto it = index.find(text);
+        return it == index.end() ? nullptr : it->second;
+    }
+};
+
+Pool& pool() {
+    // Leaked on purpose: handles may be used during static destruction
+    static Pool* instance = new Pool();
+    return *instance;
+}
+
+} // namespace
+
+const InternedString::Entry* InternedString::emptyEntry() {
+    static const Entry* empty = &pool().entries.front();
+    return empty;
+}
+
+const InternedString::Entry* InternedString::internEntry(std::string_view text) {
+    if (text.empty()) {
+        return emptyEntry();
+    }
+
+    Pool& p = pool();
+    {
+        std::shared_lock lock(p.mutex);
+        if (const Entry* entry = p.lookup(text)) {
+            return entry;
+        }
+    }
+
+    std::unique_lock lock(p.mutex);
+    if (const Entry* entry = p.lookup(text)) {
+        return entry;  // Interned by another thread in between
+    }
+    const auto& entry = p.entries.emplace_back(Entry{.text = std::string(text), .id = static_cast<std::uint32_t>(p.entries.size())});
+    p.index.emplace(entry.text, &entry);
+    return &entry;
+}
+
+std::optional<InternedString> InternedString::find(std::string_view text) {
+    Pool& p = pool();
+    std::shared_lock lock(p.mutex);
+    if (const Entry* entry = p.lookup(text)) {
+        return InternedString(entry);
+    }
+    return std::nullopt;
+}
+
+InternedString InternedString::fromId(std::uint32_t id) {
+    Pool& p = pool();
+    std::shared_lock lock(p.mutex);
+    if (id >= p.entries.size()) {
+        return InternedString();
+    }
+    return InternedString(&p.entries[id]);
+}
+
+size_t InternedString::poolSize() {
+    Pool& p = pool();
+    std::shared_lock lock(p.mutex);
+    return p.entries.size();
+}
@@ -0,0 +1,146 @@
+#ifndef INTERNED_STRING_H
+#define INTERNED_STRING_H
+
+/**
+ * @file interned_string.h
+ * @brief Process-wide pool of immutable strings for low-cardinality fields
+ * @details Task categories repeat the same handful of names across every task.
+ *          An InternedString is one pointer into a shared pool, so copying,
+ *          comparing for equality and hashing are O(1) and a category costs no
+ *          allocation per task. Each pooled string also has a dense id, which the
+ *          hot columns and TaskMatrix use as their category key. The pool only
+ *          grows; it is meant for values like categories, not free text.
+ */
+
+#include <compare>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * @class InternedString
+ * @brief Handle to a pooled, immutable string
+ * @details Thread-safe: interning takes a lock, reading a handle does not.
+ */
+class InternedString {
+public:
+    /**
+     * @struct Entry
+     * @brief Pooled string with its dense id
+     */
+    struct Entry {
+        std::string text;       ///< The pooled text
+        std::uint32_t id;       ///< Position in the pool (0 is the empty string)
+    };
+
+private:
+    const Entry* _entry;        ///< Never null
+
+    explicit InternedString(const Entry* entry) : _entry(entry) {}
+
+    /**
+     * @brief Pool entry of the empty string
+     */
+    static const Entry* emptyEntry();
+
+    /**
+     * @brief Find or add a pool entry
+     */
+    static const Entry* internEntry(std::string_view text);
+
+public:
+    /**
+     * @brief The empty string
+     */
+    InternedString() : _entry(emptyEntry()) {}
+
+    /**
+     * @brief Intern a string
+     * @details Explicit so that comparing against a string literal or std::string
+     *          goes through the string_view overloads instead of interning
+     * @param text Text to look up or add to the pool
+     */
+    explicit InternedString(std::string_view text) : _entry(internEntry(text)) {}
+
+    InternedString& operator=(std::string_view text) {
+        _entry = internEntry(text);
+        return *this;
+    }
+
+    /**
+     * @brief Look up a string without adding it to the pool
+     * @param text Text to look up
+     * @return Handle, or nullopt if the text was never interned
+     */
+    static std::optional<InternedString> find(std::string_view text);
+
+    /**
+     * @brief Get the pooled string with a given id
+     * @param id Id returned by id()
+     * @return Handle, or the empty string if the id is unknown
+     */
+    static InternedString fromId(std::uint32_t id);
+
+    /**
+     * @brief Number of strings in the pool
+     */
+    static size_t poolSize();
+
+    const std::string& str() const { return _entry->text; }
+    std::string_view view() const { return _entry->text; }
+    operator const std::string&() const { return _entry->text; }
+
+    /**
+     * @brief Dense id of the string (0 for the empty string)
+     */
+    std::uint32_t id() const { return _entry->id; }
+
+    bool empty() const { return _entry->text.empty(); }
+    size_t size() const { return _entry->text.size(); }
+
+    /**
+     * @brief Equal handles point to the same entry, so equality is a pointer compare
+     */
+    bool operator==(const InternedString& other) const { return _entry == other._entry; }
+    bool operator==(std::string_view text) const { return view() == text; }
+
+    /**
+     * @brief Order by text
+     */
+    std::strong_ordering operator<=>(const InternedString& other) const {
+        if (_entry == other._entry) return std::strong_ordering::equal;
+        return view() <=> other.view();
+    }
+    std::strong_ordering operator<=>(std::string_view text) const { return view() <=> text; }
+};
+
+/**
+ * @struct InternedStringLess
+ * @brief Transparent by-text order for ordered containers keyed by InternedString
+ */
+struct InternedStringLess {
+    using is_transparent = void;
+
+    bool operator()(const InternedString& a, const InternedString& b) const { return a < b; }
+    bool operator()(const InternedString& a, std::string_view b) const { return a.view() < b; }
+    bool operator()(std::string_view a, const InternedString& b) const { return a < b.view(); }
+};
+
+template<>
+struct std::hash<InternedString> {
+    size_t operator()(const InternedString& str) const noexcept {
+        return std::hash<std::uint32_t>{}(str.id());
+    }
+};
+
+template<>
+struct std::formatter<InternedString> : std::formatter<std::string_view> {
+    auto format(const InternedString& str, std::format_context& ctx) const {
+        return std::formatter<std::string_view>::format(str.view(), ctx);
+    }
+};
+
+#endif // INTERNED_STRING_H
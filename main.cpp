@@ -1,8 +1,82 @@
 #include "app.h"
+#include <charconv>
+#include <string_view>
 
-int main() {
-    App app;
+namespace {
+
+void printUsage(const char* program) {
+    std::print(stderr, "Usage: {} [--journal <snapshot>] [--fsync always|batch|never] [--workers N]\n", program);
+    std::print(stderr, "       {} [--batch | -f <script>] [--output text|jsonl]\n", program);
+    std::print(stderr, "       {} [--autosave <file>] [--autosave-every N] [--autosave-interval <seconds>]\n", program);
+    std::print(stderr, "       {} [--shard <file>]...\n", program);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    AppOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--journal" && i + 1 < argc) {
+            options.journal_path = argv[++i];
+        } else if (arg == "--fsync" && i + 1 < argc) {
+            auto policy = stringToFsyncPolicy(argv[++i]);
+            if (!policy) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            options.journal.fsync = *policy;
+        } else if (arg == "--batch") {
+            options.batch = true;
+        } else if ((arg == "-f" || arg == "--file") && i + 1 < argc) {
+            options.script_path = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            std::string_view format = argv[++i];
+            if (format == "text") {
+                options.output = OutputFormat::Text;
+            } else if (format == "jsonl") {
+                options.output = OutputFormat::JsonLines;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--workers" && i + 1 < argc) {
+            std::string_view value = argv[++i];
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), options.workers);
+            if (ec != std::errc{} || ptr != value.data() + value.size()) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--shard" && i + 1 < argc) {
+            options.shard_paths.emplace_back(argv[++i]);
+        } else if (arg == "--autosave" && i + 1 < argc) {
+            options.autosave.path = argv[++i];
+        } else if ((arg == "--autosave-every" || arg == "--autosave-interval") && i + 1 < argc) {
+            std::string_view value = argv[++i];
+            std::uint64_t number = 0;
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+            if (ec != std::errc{} || ptr != value.data() + value.size()) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            if (arg == "--autosave-every") {
+                options.autosave.changes = number;
+            } else {
+                options.autosave.interval = std::chrono::seconds(number);
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.batch || !options.script_path.empty()) {
+        // App never writes through std::cout, so input need not stay in sync with C stdio
+        std::ios::sync_with_stdio(false);
+        std::cin.tie(nullptr);
+    }
+
+    App app(std::move(options));
     app.config();
-    app.run();
-    return 0;
+    return app.run() ? 0 : 1;
 }
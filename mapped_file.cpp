@@ -0,0 +1,137 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Implementation of MappedFile
+ */
+
+#include "mapped_file.h"
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TASKTRACKER_HAS_MMAP 1
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define TASKTRACKER_HAS_MMAP 0
+#endif
+
+MappedFile::~MappedFile() {
+    reset();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0)),
+      _mapped(std::exchange(other._mapped, false)),
+      _buffer(std::move(other._buffer)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        reset();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+        _mapped = std::exchange(other._mapped, false);
+        _buffer = std::move(other._buffer);
+    }
+    return *this;
+}
+
+void MappedFile::reset() noexcept {
+#if TASKTRACKER_HAS_MMAP
+    if (_mapped && _data) {
+        ::munmap(const_cast<char*>(_data), _size);
+    }
+#endif
+    _buffer.reset();
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+}
+
+#if TASKTRACKER_HAS_MMAP
+
+std::expected<MappedFile, JsonError> MappedFile::open(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::unexpected(JsonError::FileNotFound);
+    }
+
+    MappedFile file;
+    struct stat info {};
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        file._size = static_cast<size_t>(info.st_size);
+        if (file._size == 0) {
+            ::close(fd);
+            return file;
+        }
+
+        void* region = ::mmap(nullptr, file._size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (region != MAP_FAILED) {
+            // The parser reads front to back exactly once
+            ::madvise(region, file._size, MADV_SEQUENTIAL);
+            ::close(fd);
+            file._data = static_cast<const char*>(region);
+            file._mapped = true;
+            return file;
+        }
+    }
+
+    // Fallback: read() into one growing buffer (also covers pipes and FIFOs)
+    size_t capacity = file._size > 0 ? file._size : 64 * 1024;
+    size_t length = 0;
+    auto buffer = std::make_unique<char[]>(capacity);
+    while (true) {
+        if (length == capacity) {
+            auto bigger = std::make_unique<char[]>(capacity * 2);
+            std::copy_n(buffer.get(), length, bigger.get());
+            buffer = std::move(bigger);
+            capacity *= 2;
+        }
+
+        ssize_t count = ::read(fd, buffer.get() + length, capacity - length);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            return std::unexpected(JsonError::ParseError);
+        }
+        if (count == 0) break;
+        length += static_cast<size_t>(count);
+    }
+    ::close(fd);
+
+    file._buffer = std::move(buffer);
+    file._data = file._buffer.get();
+    file._size = length;
+    return file;
+}
+
+#else
+
+std::expected<MappedFile, JsonError> MappedFile::open(const std::string& filename) {
+    std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+    if (!stream.is_open()) {
+        return std::unexpected(JsonError::FileNotFound);
+    }
+
+    MappedFile file;
+    auto end = stream.tellg();
+    if (end <= 0) {
+        return file;
+    }
+
+    file._size = static_cast<size_t>(end);
+    file._buffer = std::make_unique<char[]>(file._size);
+    stream.seekg(0);
+    if (!stream.read(file._buffer.get(), static_cast<std::streamsize>(file._size))) {
+        return std::unexpected(JsonError::ParseError);
+    }
+
+    file._data = file._buffer.get();
+    return file;
+}
+
+#endif
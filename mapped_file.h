@@ -0,0 +1,67 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/**
+ * @file mapped_file.h
+ * @brief Read-only view of a whole file without copying it into a std::string
+ * @details Uses mmap on POSIX systems and falls back to a single read into one
+ *          buffer when mapping is not available (pipes, special files, non-POSIX)
+ */
+
+#include "task.h"
+#include <string>
+#include <string_view>
+#include <memory>
+#include <expected>
+
+/**
+ * @class MappedFile
+ * @brief Move-only owner of a file's contents exposed as a std::string_view
+ */
+class MappedFile {
+private:
+    const char* _data = nullptr;        ///< Start of the file contents
+    size_t _size = 0;                   ///< Length of the file contents
+    bool _mapped = false;               ///< true if _data points into an mmap region
+    std::unique_ptr<char[]> _buffer;    ///< Owned storage for the read() fallback
+
+    /**
+     * @brief Release the mapping or buffer
+     */
+    void reset() noexcept;
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Open a file and expose its contents
+     * @param filename Path of the file to open
+     * @return MappedFile on success, FileNotFound if it cannot be opened,
+     *         ParseError if reading fails
+     */
+    static std::expected<MappedFile, JsonError> open(const std::string& filename);
+
+    /**
+     * @brief View over the whole file; valid while this object is alive
+     */
+    std::string_view view() const { return {_data ? _data : "", _size}; }
+
+    /**
+     * @brief Size of the file in bytes
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * @brief Check whether the contents are memory-mapped rather than read
+     */
+    bool isMapped() const { return _mapped; }
+};
+
+#endif // MAPPED_FILE_H
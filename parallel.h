@@ -0,0 +1,136 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+/**
+ * @file parallel.h
+ * @brief Fork-join helpers for the opt-in parallel bulk paths
+ * @details Work is split into contiguous chunks, one per worker; chunk 0 runs on
+ *          the calling thread and the others on short-lived std::jthread workers.
+ *          Results are always combined in chunk order, so output matches the
+ *          sequential path exactly. The first exception thrown by a chunk is
+ *          rethrown on the calling thread.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+/**
+ * @brief Turn a requested worker count into an actual one
+ * @param requested Worker count, or 0 for one per hardware thread
+ * @return At least 1
+ */
+inline unsigned resolveWorkerCount(unsigned requested) {
+    if (requested == 0) {
+        requested = std::thread::hardware_concurrency();
+    }
+    return std::max(requested, 1u);
+}
+
+/**
+ * @brief Number of chunks forEachChunk splits count items into
+ * @param count Number of items
+ * @param workers Worker count (already resolved)
+ * @param min_chunk Smallest chunk worth a thread
+ */
+inline size_t chunkCount(size_t count, unsigned workers, size_t min_chunk) {
+    if (count == 0) return 0;
+    const size_t step = std::max(min_chunk, 1uz);
+    const size_t by_size = (count + step - 1) / step;
+    return std::clamp(by_size, 1uz, static_cast<size_t>(std::max(workers, 1u)));
+}
+
+/**
+ * @brief Run fn(chunk, begin, end) over contiguous chunks of [0, count) in parallel
+ * @param count Number of items
+ * @param workers Worker count (already resolved)
+ * @param min_chunk Smallest chunk worth a thread; small inputs stay on one thread
+ * @param fn Callable taking (chunk index, first item, one past the last item)
+ */
+template<typename Fn>
+void forEachChunk(size_t count, unsigned workers, size_t min_chunk, Fn&& fn) {
+    const size_t chunks = chunkCount(count, workers, min_chunk);
+    if (chunks <= 1) {
+        if (chunks == 1) fn(0uz, 0uz, count);
+        return;
+    }
+
+    auto bounds = [count, chunks](size_t chunk) { return count * chunk / chunks; };
+    std::vector<std::exception_ptr> errors(chunks);
+    auto runChunk = [&](size_t chunk) {
+        try {
+            fn(chunk, bounds(chunk), bounds(chunk + 1));
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+
+    {
+        std::vector<std::jthread> threads;
+        threads.reserve(chunks - 1);
+        for (size_t chunk = 1; chunk < chunks; ++chunk) {
+            threads.emplace_back(runChunk, chunk);
+        }
+        runChunk(0);
+    } // Joins the workers
+
+    for (auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Sort a random-access range on several threads
+ * @details Chunks are sorted in parallel, then merged pairwise, each round of
+ *          merges also in parallel. Falls back to std::sort for one worker or
+ *          small inputs. Not stable, like std::sort.
+ * @param first Start of the range
+ * @param last End of the range
+ * @param comp Strict weak order
+ * @param workers Worker count (already resolved)
+ */
+template<std::random_access_iterator It, typename Compare>
+void sort(It first, It last, Compare comp, unsigned workers) {
+    constexpr size_t MIN_SORT_CHUNK = 1uz << 14;
+    const auto count = static_cast<size_t>(last - first);
+    const size_t chunks = chunkCount(count, workers, MIN_SORT_CHUNK);
+    if (chunks <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t chunk = 0; chunk <= chunks; ++chunk) {
+        bounds[chunk] = count * chunk / chunks;
+    }
+
+    forEachChunk(chunks, workers, 1, [&](size_t, size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+            std::sort(first + bounds[chunk], first + bounds[chunk + 1], comp);
+        }
+    });
+
+    // Merge runs [i, i + width) and [i + width, i + 2 * width) until one run remains
+    for (size_t width = 1; width < chunks; width *= 2) {
+        const size_t merges = (chunks + 2 * width - 1) / (2 * width);
+        forEachChunk(merges, workers, 1, [&](size_t, size_t begin, size_t end) {
+            for (size_t merge = begin; merge < end; ++merge) {
+                size_t lo = merge * 2 * width;
+                size_t mid = std::min(lo + width, chunks);
+                size_t hi = std::min(lo + 2 * width, chunks);
+                if (mid < hi) {
+                    std::inplace_merge(first + bounds[lo], first + bounds[mid], first + bounds[hi], comp);
+                }
+            }
+        });
+    }
+}
+
+} // namespace parallel
+
+#endif // PARALLEL_H
@@ -0,0 +1,30 @@
+/**
+ * @file perf_alloc_hook.cpp
+ * @brief Global allocation functions that feed the perf allocation counters
+ * @details Linked into the TaskTracker executable only when TASKTRACKER_PERF is
+ *          on, so the library never replaces operator new for its users. As in
+ *          the benchmark's counter, only the plain and array forms are replaced.
+ */
+
+#include "perf_counters.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+void* countedAlloc(std::size_t size) {
+    notePerfAllocation(size);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
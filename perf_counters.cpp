@@ -0,0 +1,165 @@
+/**
+ * @file perf_counters.cpp
+ * @brief Storage and reporting for the hot-path probes
+ */
+
+#include "perf_counters.h"
+#include <atomic>
+#include <bit>
+#include <format>
+#include <iterator>
+
+namespace {
+
+/**
+ * @brief Sub-buckets per power of two
+ */
+constexpr unsigned SUB_BUCKET_BITS = 3;
+constexpr uint64_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+
+/**
+ * @brief Enough buckets for any 64-bit nanosecond value
+ */
+constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+/**
+ * @brief Histogram bucket of a latency
+ * @details Values below SUB_BUCKETS get one bucket each; above, the bucket is
+ *          the position of the highest set bit plus the next three bits
+ */
+size_t bucketFor(uint64_t ns) {
+    if (ns < SUB_BUCKETS) {
+        return static_cast<size_t>(ns);
+    }
+    unsigned msb = static_cast<unsigned>(std::bit_width(ns)) - 1;
+    uint64_t sub = (ns >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return static_cast<size_t>((msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub);
+}
+
+/**
+ * @brief Middle of the latency range covered by a bucket
+ */
+uint64_t bucketMidpoint(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    unsigned msb = static_cast<unsigned>(bucket / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+    uint64_t sub = bucket % SUB_BUCKETS;
+    uint64_t width = uint64_t{1} << (msb - SUB_BUCKET_BITS);
+    return ((SUB_BUCKETS + sub) << (msb - SUB_BUCKET_BITS)) + width / 2;
+}
+
+/**
+ * @struct ProbeData
+ * @brief Live counters of one probe
+ */
+struct ProbeData {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> alloc_bytes{0};
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+};
+
+std::array<ProbeData, static_cast<size_t>(PerfProbe::Count)> g_probes;
+
+/**
+ * @brief Per-thread allocation counts; trivially destructible so the hook can
+ *        run at any point of a thread's life
+ */
+thread_local PerfAllocations t_allocations;
+
+uint64_t percentile(const ProbeData& data, uint64_t calls, double fraction) {
+    uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(calls - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        seen += data.buckets[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return bucketMidpoint(bucket);
+        }
+    }
+    return data.max_ns.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+std::string_view perfProbeName(PerfProbe probe) {
+    switch (probe) {
+        case PerfProbe::LoadJson:       return "load_json";
+        case PerfProbe::SaveJson:       return "save_json";
+        case PerfProbe::TaskFromJson:   return "task_from_json";
+        case PerfProbe::RebuildIndexes: return "rebuild_indexes";
+        case PerfProbe::Command:        return "command";
+        case PerfProbe::Find:           return "find";
+        case PerfProbe::Count:          break;
+    }
+    return "unknown";
+}
+
+void recordPerf(PerfProbe probe, uint64_t ns, uint64_t bytes, uint64_t allocs, uint64_t alloc_bytes) {
+    ProbeData& data = g_probes[static_cast<size_t>(probe)];
+    data.calls.fetch_add(1, std::memory_order_relaxed);
+    data.total_ns.fetch_add(ns, std::memory_order_relaxed);
+    data.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    data.allocs.fetch_add(allocs, std::memory_order_relaxed);
+    data.alloc_bytes.fetch_add(alloc_bytes, std::memory_order_relaxed);
+    data.buckets[bucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = data.max_ns.load(std::memory_order_relaxed);
+    while (ns > max && !data.max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+std::vector<PerfSummary> perfSnapshot() {
+    std::vector<PerfSummary> summaries;
+    for (size_t i = 0; i < g_probes.size(); ++i) {
+        const ProbeData& data = g_probes[i];
+        uint64_t calls = data.calls.load(std::memory_order_relaxed);
+        if (calls == 0) continue;
+        summaries.push_back(PerfSummary{
+            .probe = static_cast<PerfProbe>(i),
+            .calls = calls,
+            .total_ns = data.total_ns.load(std::memory_order_relaxed),
+            .p50_ns = percentile(data, calls, 0.5),
+            .p99_ns = percentile(data, calls, 0.99),
+            .max_ns = data.max_ns.load(std::memory_order_relaxed),
+            .bytes = data.bytes.load(std::memory_order_relaxed),
+            .allocs = data.allocs.load(std::memory_order_relaxed),
+            .alloc_bytes = data.alloc_bytes.load(std::memory_order_relaxed),
+        });
+    }
+    return summaries;
+}
+
+void resetPerf() {
+    for (ProbeData& data : g_probes) {
+        data.calls.store(0, std::memory_order_relaxed);
+        data.total_ns.store(0, std::memory_order_relaxed);
+        data.max_ns.store(0, std::memory_order_relaxed);
+        data.bytes.store(0, std::memory_order_relaxed);
+        data.allocs.store(0, std::memory_order_relaxed);
+        data.alloc_bytes.store(0, std::memory_order_relaxed);
+        for (auto& bucket : data.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void appendPerfJson(std::string& out, const PerfSummary& summary) {
+    std::format_to(std::back_inserter(out),
+                   "{{\"probe\":\"{}\",\"calls\":{},\"total_ns\":{},\"p50_ns\":{},\"p99_ns\":{},"
+                   "\"max_ns\":{},\"bytes\":{},\"allocs\":{},\"alloc_bytes\":{}}}",
+                   perfProbeName(summary.probe), summary.calls, summary.total_ns, summary.p50_ns,
+                   summary.p99_ns, summary.max_ns, summary.bytes, summary.allocs, summary.alloc_bytes);
+}
+
+void notePerfAllocation(size_t bytes) noexcept {
+    ++t_allocations.count;
+    t_allocations.bytes += bytes;
+}
+
+PerfAllocations threadPerfAllocations() noexcept {
+    return t_allocations;
+}
@@ -0,0 +1,154 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+/**
+ * @file perf_counters.h
+ * @brief Scoped timers and counters for the hot paths
+ * @details Each probe keeps a call count, byte and allocation totals and a
+ *          log-linear latency histogram (eight buckets per power of two, so
+ *          percentiles are within about 6%). Recording is a handful of relaxed
+ *          atomic adds. Everything here is compiled out unless the build defines
+ *          TASKTRACKER_PERF=1 (CMake option TASKTRACKER_PERF); PerfScope then
+ *          has no effect and perfSnapshot() returns nothing.
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef TASKTRACKER_PERF
+#define TASKTRACKER_PERF 0
+#endif
+
+/**
+ * @brief Whether instrumentation is compiled in
+ */
+inline constexpr bool PERF_ENABLED = TASKTRACKER_PERF != 0;
+
+/**
+ * @enum PerfProbe
+ * @brief Instrumented code paths
+ */
+enum class PerfProbe {
+    LoadJson,       ///< TaskManager::loadFromJson
+    SaveJson,       ///< TaskManager::saveToJson
+    TaskFromJson,   ///< Task::fromJson
+    RebuildIndexes, ///< TaskManager::rebuildIndexes (matrix, counters, text index)
+    Command,        ///< One command handler run by App
+    Find,           ///< App::handleFind
+    Count           ///< Number of probes
+};
+
+/**
+ * @struct PerfSummary
+ * @brief Aggregated measurements of one probe
+ */
+struct PerfSummary {
+    PerfProbe probe;            ///< Probe described
+    uint64_t calls = 0;         ///< Completed scopes
+    uint64_t total_ns = 0;      ///< Sum of scope latencies
+    uint64_t p50_ns = 0;        ///< Median latency (histogram estimate)
+    uint64_t p99_ns = 0;        ///< 99th percentile latency (histogram estimate)
+    uint64_t max_ns = 0;        ///< Slowest scope
+    uint64_t bytes = 0;         ///< Bytes parsed or written
+    uint64_t allocs = 0;        ///< Heap allocations on the measuring thread
+    uint64_t alloc_bytes = 0;   ///< Bytes of those allocations
+};
+
+/**
+ * @brief Name of a probe, e.g. "load_json"
+ */
+std::string_view perfProbeName(PerfProbe probe);
+
+/**
+ * @brief Record one completed scope
+ * @details Called by PerfScope; available for code that times itself
+ */
+void recordPerf(PerfProbe probe, uint64_t ns, uint64_t bytes, uint64_t allocs, uint64_t alloc_bytes);
+
+/**
+ * @brief Summaries of every probe that has been hit, in PerfProbe order
+ */
+std::vector<PerfSummary> perfSnapshot();
+
+/**
+ * @brief Clear all probes
+ */
+void resetPerf();
+
+/**
+ * @brief Append a summary as one JSON object without a trailing newline
+ * @param out Destination buffer
+ * @param summary Summary to write
+ */
+void appendPerfJson(std::string& out, const PerfSummary& summary);
+
+/**
+ * @brief Count one heap allocation on the calling thread
+ * @details Called by the operator new hook linked into the TaskTracker
+ *          executable when instrumentation is enabled; without the hook
+ *          allocation counts stay zero
+ */
+void notePerfAllocation(size_t bytes) noexcept;
+
+/**
+ * @struct PerfAllocations
+ * @brief Allocations counted on one thread so far
+ */
+struct PerfAllocations {
+    uint64_t count = 0;     ///< Number of allocations
+    uint64_t bytes = 0;     ///< Bytes requested
+};
+
+/**
+ * @brief Allocations counted on the calling thread so far
+ */
+PerfAllocations threadPerfAllocations() noexcept;
+
+/**
+ * @class PerfScope
+ * @brief Times the enclosing scope and records it under a probe on exit
+ * @details Allocations made by worker threads the scope starts are not counted
+ */
+class PerfScope {
+private:
+    PerfProbe _probe;
+    std::chrono::steady_clock::time_point _start;
+    PerfAllocations _allocs_at_start;
+    uint64_t _bytes = 0;
+
+public:
+    explicit PerfScope(PerfProbe probe) noexcept : _probe(probe) {
+        if constexpr (PERF_ENABLED) {
+            _allocs_at_start = threadPerfAllocations();
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+    ~PerfScope() {
+        if constexpr (PERF_ENABLED) {
+            auto elapsed = std::chrono::steady_clock::now() - _start;
+            PerfAllocations allocs = threadPerfAllocations();
+            recordPerf(_probe,
+                       static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                       _bytes, allocs.count - _allocs_at_start.count, allocs.bytes - _allocs_at_start.bytes);
+        }
+    }
+
+    /**
+     * @brief Attribute bytes parsed or written to this scope
+     */
+    void addBytes(uint64_t bytes) noexcept {
+        if constexpr (PERF_ENABLED) {
+            _bytes += bytes;
+        }
+    }
+};
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,313 @@
+/**
+ * @file sharded_task_store.cpp
+ * @brief Implementation of ShardedTaskStore
+ */
+
+#include "sharded_task_store.h"
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <map>
+#include <queue>
+
+namespace {
+
+/**
+ * @brief a + b, clamped instead of wrapping (offset + "no limit")
+ */
+size_t saturatingAdd(size_t a, size_t b) {
+    return a > std::numeric_limits<size_t>::max() - b ? std::numeric_limits<size_t>::max() : a + b;
+}
+
+} // namespace
+
+std::optional<ShardedTaskId> parseShardedTaskId(std::string_view text) {
+    size_t colon = text.rfind(':');
+    if (colon == std::string_view::npos || colon == 0) {
+        return std::nullopt;
+    }
+    std::string_view digits = text.substr(colon + 1);
+    int id = 0;
+    auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), id);
+    if (ec != std::errc{} || ptr != digits.data() + digits.size() || id <= 0) {
+        return std::nullopt;
+    }
+    return ShardedTaskId{.shard = text.substr(0, colon), .id = id};
+}
+
+std::string ShardedTaskStore::shardNameFor(std::string_view path) {
+    std::filesystem::path file(path);
+    if (!file.has_filename()) {
+        file = file.parent_path();  // "team.segments/"
+    }
+    return file.stem().string();
+}
+
+ShardFormat ShardedTaskStore::shardFormatFor(const std::string& path) {
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec)) {
+        return ShardFormat::Segments;
+    }
+    return std::filesystem::path(path).extension() == ".bin" ? ShardFormat::Binary : ShardFormat::Json;
+}
+
+std::vector<ShardLoadResult> ShardedTaskStore::loadFiles(std::span<const std::string> paths) {
+    std::vector<ShardLoadResult> results(paths.size());
+    std::vector<std::unique_ptr<Shard>> loaded(paths.size());
+    std::map<std::string, size_t, std::less<>> first_with_name;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        results[i].name = shardNameFor(paths[i]);
+        results[i].path = paths[i];
+        results[i].result = true;
+        if (results[i].name.empty() || !first_with_name.try_emplace(results[i].name, i).second) {
+            // Two files would share a namespace; neither id space may shadow the other
+            results[i].result = std::unexpected(JsonError::InvalidFormat);
+        }
+    }
+
+    // One file per worker; each shard's own bulk paths share what is left
+    const unsigned inner_workers = std::max(1u, _workers / static_cast<unsigned>(std::max(paths.size(), 1uz)));
+    parallel::forEachChunk(paths.size(), _workers, 1, [&](size_t, size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            if (!results[i].result) continue;
+            auto shard = std::make_unique<Shard>();
+            shard->name = results[i].name;
+            shard->path = paths[i];
+            shard->manager.setWorkerCount(inner_workers);
+            switch (shardFormatFor(paths[i])) {
+                case ShardFormat::Json:     results[i].result = shard->manager.loadFromJson(paths[i]); break;
+                case ShardFormat::Binary:   results[i].result = shard->manager.loadFromBinary(paths[i]); break;
+                case ShardFormat::Segments: results[i].result = shard->manager.loadFromSegments(paths[i]); break;
+            }
+            if (results[i].result) {
+                results[i].tasks = shard->manager.getTaskCount();
+                shard->manager.setWorkerCount(1);  // Fan-out already runs one shard per worker
+                loaded[i] = std::move(shard);
+            }
+        }
+    });
+
+    // Replace shards in place so the indexes of the others stay put
+    for (auto& shard : loaded) {
+        if (!shard) continue;
+        if (auto existing = findShard(shard->name)) {
+            _shards[*existing] = std::move(shard);
+        } else {
+            _shards.push_back(std::move(shard));
+        }
+    }
+    return results;
+}
+
+std::vector<JsonResult> ShardedTaskStore::saveAll() {
+    std::vector<JsonResult> results(_shards.size(), true);
+    forEachShard([&](size_t index) {
+        Shard& shard = *_shards[index];
+        switch (shardFormatFor(shard.path)) {
+            case ShardFormat::Json:     results[index] = shard.manager.saveToJson(shard.path); break;
+            case ShardFormat::Binary:   results[index] = shard.manager.saveToBinary(shard.path); break;
+            case ShardFormat::Segments: {
+                auto stats = shard.manager.saveToSegments(shard.path);
+                results[index] = stats ? JsonResult(true) : std::unexpected(stats.error());
+                break;
+            }
+        }
+    });
+    return results;
+}
+
+std::optional<size_t> ShardedTaskStore::findShard(std::string_view name) const {
+    for (size_t i = 0; i < _shards.size(); ++i) {
+        if (_shards[i]->name == name) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<ShardedTask> ShardedTaskStore::findTask(const ShardedTaskId& id) const {
+    auto index = findShard(id.shard);
+    if (!index) {
+        return std::nullopt;
+    }
+    const Task* task = _shards[*index]->manager.findTask(id.id);
+    if (!task) {
+        return std::nullopt;
+    }
+    return ShardedTask{.shard = *index, .task = task};
+}
+
+size_t ShardedTaskStore::getTaskCount() const {
+    size_t total = 0;
+    for (const auto& shard : _shards) {
+        total += shard->manager.getTaskCount();
+    }
+    return total;
+}
+
+StatusCounters ShardedTaskStore::getCounters() const {
+    // O(shards): every manager keeps its counters up to date
+    StatusCounters total;
+    for (const auto& shard : _shards) {
+        const StatusCounters& counters = shard->manager.getCounters();
+        for (size_t i = 0; i < StatusCounters::STATUS_COUNT; ++i) {
+            total.by_status[i] += counters.by_status[i];
+        }
+        for (size_t i = 0; i < StatusCounters::PRIORITY_LEVELS; ++i) {
+            total.by_priority[i] += counters.by_priority[i];
+        }
+    }
+    return total;
+}
+
+std::vector<CategoryCounts> ShardedTaskStore::getCategoryCounts() const {
+    std::vector<std::vector<CategoryCounts>> per_shard(_shards.size());
+    forEachShard([&](size_t index) {
+        const TaskMatrix& matrix = _shards[index]->manager.getMatrix();
+        for (const std::string& category : matrix.getCategories()) {
+            CategoryCounts& counts = per_shard[index].emplace_back();
+            counts.category = category;
+            for (int priority : matrix.getPriorities(category)) {
+                size_t count = matrix.getTaskCount(category, priority);
+                counts.by_priority[static_cast<size_t>(priority)] += count;
+                counts.total += count;
+            }
+        }
+    });
+
+    std::map<std::string, CategoryCounts, std::less<>> merged;
+    for (auto& shard_counts : per_shard) {
+        for (auto& counts : shard_counts) {
+            auto [it, inserted] = merged.try_emplace(counts.category);
+            if (inserted) {
+                it->second = std::move(counts);
+                continue;
+            }
+            for (size_t p = 0; p < StatusCounters::PRIORITY_LEVELS; ++p) {
+                it->second.by_priority[p] += counts.by_priority[p];
+            }
+            it->second.total += counts.total;
+        }
+    }
+
+    std::vector<CategoryCounts> result;
+    result.reserve(merged.size());
+    for (auto& [name, counts] : merged) {
+        result.push_back(std::move(counts));
+    }
+    return result;
+}
+
+std::vector<ShardedTask> ShardedTaskStore::mergeSorted(TaskSortKey key, std::span<const std::vector<const Task*>> runs,
+                                                       size_t offset, size_t limit) {
+    std::vector<ShardedTask> page;
+    withSortOrder(key, [&]<typename Order>(Order order) {
+        // Cursor into one run; the heap keeps the cursor with the smallest head on top
+        struct Cursor {
+            size_t shard;
+            size_t next;
+        };
+        auto after = [&](const Cursor& a, const Cursor& b) {
+            const Task& x = *runs[a.shard][a.next];
+            const Task& y = *runs[b.shard][b.next];
+            if (order(y, x)) return true;
+            if (order(x, y)) return false;
+            return a.shard > b.shard;  // Same key and id in two shards: shard order
+        };
+        std::priority_queue<Cursor, std::vector<Cursor>, decltype(after)> heap(after);
+        for (size_t shard = 0; shard < runs.size(); ++shard) {
+            if (!runs[shard].empty()) {
+                heap.push({shard, 0});
+            }
+        }
+
+        const size_t end = saturatingAdd(offset, limit);
+        for (size_t position = 0; position < end && !heap.empty(); ++position) {
+            Cursor cursor = heap.top();
+            heap.pop();
+            if (position >= offset) {
+                page.push_back({cursor.shard, runs[cursor.shard][cursor.next]});
+            }
+            if (++cursor.next < runs[cursor.shard].size()) {
+                heap.push(cursor);
+            }
+        }
+    });
+    return page;
+}
+
+ShardedPage ShardedTaskStore::getSortedPage(TaskSortKey key, size_t offset, size_t limit) const {
+    ShardedPage page{.offset = offset};
+    if (limit == 0) {
+        page.total = getTaskCount();
+        return page;
+    }
+
+    // No shard contributes more than the merged page's last position
+    const size_t prefix = saturatingAdd(offset, limit);
+    std::vector<std::vector<const Task*>> runs(_shards.size());
+    std::vector<size_t> totals(_shards.size());
+    forEachShard([&](size_t index) {
+        SortedPage shard_page = _shards[index]->manager.getSortedPage(key, 0, prefix);
+        runs[index] = std::move(shard_page.tasks);
+        totals[index] = shard_page.total;
+    });
+
+    for (size_t total : totals) {
+        page.total += total;
+    }
+    page.tasks = mergeSorted(key, runs, offset, limit);
+    return page;
+}
+
+ShardedPage ShardedTaskStore::runQuery(const TaskQuery& query) const {
+    ShardedPage page{.offset = query.offset};
+    TaskQuery shard_query = query;
+    shard_query.offset = 0;
+    shard_query.limit = saturatingAdd(query.offset, query.limit);
+
+    std::vector<std::vector<const Task*>> runs(_shards.size());
+    std::vector<QueryResult> results(_shards.size());
+    forEachShard([&](size_t index) {
+        results[index] = runTaskQuery(_shards[index]->manager, shard_query);
+        runs[index] = std::move(results[index].tasks);
+    });
+
+    for (const QueryResult& result : results) {
+        page.total += result.total;
+        page.candidates += result.candidates;
+    }
+    if (query.limit == 0) {
+        return page;
+    }
+    if (query.sort) {
+        page.tasks = mergeSorted(*query.sort, runs, query.offset, query.limit);
+        return page;
+    }
+
+    // Unsorted: shard by shard, each shard in its own result order
+    size_t position = 0;
+    for (size_t shard = 0; shard < runs.size() && page.tasks.size() < query.limit; ++shard) {
+        for (const Task* task : runs[shard]) {
+            if (position++ < query.offset) continue;
+            page.tasks.push_back({shard, task});
+            if (page.tasks.size() == query.limit) break;
+        }
+    }
+    return page;
+}
+
+std::vector<ShardedTask> ShardedTaskStore::findTasks(std::string_view query) const {
+    std::vector<std::vector<int>> ids(_shards.size());
+    forEachShard([&](size_t index) {
+        ids[index] = _shards[index]->manager.findTasks(query);
+    });
+
+    std::vector<ShardedTask> matches;
+    for (size_t shard = 0; shard < ids.size(); ++shard) {
+        for (int id : ids[shard]) {
+            matches.push_back({shard, _shards[shard]->manager.findTask(id)});
+        }
+    }
+    return matches;
+}
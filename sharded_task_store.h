@@ -0,0 +1,255 @@
+#ifndef SHARDED_TASK_STORE_H
+#define SHARDED_TASK_STORE_H
+
+/**
+ * @file sharded_task_store.h
+ * @brief Several task files served from one process, one TaskManager per file
+ * @details Each file becomes a shard named after the file (team.json -> "team")
+ *          with its own TaskManager, so every shard keeps its own ids, indexes
+ *          and next id. Tasks are addressed across shards by namespaced ids,
+ *          "team:42". Files are loaded concurrently, one shard per worker, and
+ *          queries, sorted pages, searches, statistics and the category x
+ *          priority counts fan out to every shard in parallel and are merged:
+ *          sorted output by a k-way merge of each shard's first offset + limit
+ *          tasks, so no shard sorts more than the requested page needs. Shards
+ *          run on separate managers, so the fan-out needs no locking, but the
+ *          store itself is not synchronized.
+ */
+
+#include "task.h"
+#include "task_manager.h"
+#include "task_query.h"
+#include "task_sort.h"
+#include "parallel.h"
+#include <array>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @enum ShardFormat
+ * @brief On-disk format of a shard, chosen from its path
+ */
+enum class ShardFormat {
+    Json,       ///< Any other path: a JSON document
+    Binary,     ///< ".bin": a binary snapshot (save --binary)
+    Segments    ///< An existing directory: a segmented directory (save --segments)
+};
+
+/**
+ * @struct ShardedTaskId
+ * @brief Task address across shards, written "shard:id"
+ */
+struct ShardedTaskId {
+    std::string_view shard;  ///< Shard name (views the parsed text)
+    int id = 0;              ///< Task ID within the shard
+};
+
+/**
+ * @brief Parse a namespaced id such as "team:42"
+ * @details The shard name is everything before the last ':'
+ * @return Id, or std::nullopt if there is no name or no positive id
+ */
+std::optional<ShardedTaskId> parseShardedTaskId(std::string_view text);
+
+/**
+ * @struct ShardedTask
+ * @brief A task and the shard it belongs to
+ * @details The pointer is invalidated like TaskManager's: by adding, removing
+ *          and loading tasks in that shard
+ */
+struct ShardedTask {
+    size_t shard = 0;           ///< Index of the shard (ShardedTaskStore::shardName)
+    const Task* task = nullptr; ///< The task
+};
+
+/**
+ * @struct ShardedPage
+ * @brief One page of tasks merged from every shard
+ */
+struct ShardedPage {
+    std::vector<ShardedTask> tasks;  ///< Tasks on the page, in order
+    size_t offset = 0;               ///< Position of the first task in the merged order
+    size_t total = 0;                ///< Number of tasks in the merged order
+    size_t candidates = 0;           ///< Tasks checked by the shards (queries only)
+};
+
+/**
+ * @struct ShardLoadResult
+ * @brief Outcome of loading one file
+ */
+struct ShardLoadResult {
+    std::string name;           ///< Shard the file was loaded into
+    std::string path;           ///< File loaded
+    JsonResult result;          ///< Success, or why the file was not loaded
+    size_t tasks = 0;           ///< Tasks in the shard after loading
+};
+
+/**
+ * @struct CategoryCounts
+ * @brief Task count per priority for one category, summed over shards
+ */
+struct CategoryCounts {
+    std::string category;                                        ///< Category name
+    std::array<size_t, StatusCounters::PRIORITY_LEVELS> by_priority{}; ///< Count per priority 0-10
+    size_t total = 0;                                            ///< Sum of by_priority
+};
+
+/**
+ * @class ShardedTaskStore
+ * @brief Named TaskManager shards with parallel load and merged queries
+ */
+class ShardedTaskStore {
+private:
+    /**
+     * @struct Shard
+     * @brief One loaded file
+     */
+    struct Shard {
+        std::string name;
+        std::string path;
+        TaskManager manager;
+    };
+
+    std::vector<std::unique_ptr<Shard>> _shards;  ///< In load order; stable addresses
+    unsigned _workers = 1;                        ///< Threads for the fan-out
+
+    /**
+     * @brief Run fn(shard index) for every shard, spread over the workers
+     */
+    template<typename Fn>
+    void forEachShard(Fn&& fn) const {
+        parallel::forEachChunk(_shards.size(), _workers, 1, [&](size_t, size_t first, size_t last) {
+            for (size_t index = first; index < last; ++index) {
+                fn(index);
+            }
+        });
+    }
+
+    /**
+     * @brief Merge per-shard runs that are each in key order into one page
+     * @param key Order of every run
+     * @param runs Tasks per shard, in key order
+     * @param offset Merged positions to skip
+     * @param limit Maximum tasks to return
+     */
+    static std::vector<ShardedTask> mergeSorted(TaskSortKey key, std::span<const std::vector<const Task*>> runs,
+                                                size_t offset, size_t limit);
+
+public:
+    /**
+     * @brief Shard name for a path: the file name without its extension
+     */
+    static std::string shardNameFor(std::string_view path);
+
+    /**
+     * @brief Format a shard is stored in, from its path
+     */
+    static ShardFormat shardFormatFor(const std::string& path);
+
+    /**
+     * @brief Set the number of threads used for loading and fan-out
+     * @param workers Thread count, 0 for one per hardware thread, 1 to disable
+     */
+    void setWorkerCount(unsigned workers) {
+        _workers = parallel::resolveWorkerCount(workers);
+    }
+
+    /**
+     * @brief Load files concurrently into shards
+     * @details A file replaces the shard of the same name, if any; files whose
+     *          name repeats within the call, or that fail to load, leave the
+     *          store unchanged. Shards load one per worker; a shard's own bulk
+     *          paths get the workers left over.
+     * @param paths Files (or segmented directories) to load
+     * @return One result per path, in order
+     */
+    std::vector<ShardLoadResult> loadFiles(std::span<const std::string> paths);
+
+    /**
+     * @brief Write every shard back to its file concurrently, in its format
+     * @return One result per shard, in shard order
+     */
+    std::vector<JsonResult> saveAll();
+
+    /**
+     * @brief Number of shards
+     */
+    size_t shardCount() const { return _shards.size(); }
+
+    /**
+     * @brief Name of a shard
+     */
+    const std::string& shardName(size_t index) const { return _shards[index]->name; }
+
+    /**
+     * @brief File a shard was loaded from
+     */
+    const std::string& shardPath(size_t index) const { return _shards[index]->path; }
+
+    /**
+     * @brief Tasks of one shard, for mutations
+     */
+    TaskManager& shard(size_t index) { return _shards[index]->manager; }
+
+    /**
+     * @brief Tasks of one shard
+     */
+    const TaskManager& shard(size_t index) const { return _shards[index]->manager; }
+
+    /**
+     * @brief Index of a shard by name
+     */
+    std::optional<size_t> findShard(std::string_view name) const;
+
+    /**
+     * @brief Find a task by its namespaced id
+     * @return The task and its shard, or std::nullopt if either does not exist
+     */
+    std::optional<ShardedTask> findTask(const ShardedTaskId& id) const;
+
+    /**
+     * @brief Tasks in all shards
+     */
+    size_t getTaskCount() const;
+
+    /**
+     * @brief Per-status and per-priority counts summed over shards
+     */
+    StatusCounters getCounters() const;
+
+    /**
+     * @brief Task count per category and priority, summed over shards
+     * @return One entry per category, in name order
+     */
+    std::vector<CategoryCounts> getCategoryCounts() const;
+
+    /**
+     * @brief One page of all tasks in a fixed order
+     * @details Each shard serves its first offset + limit tasks from its sort
+     *          cache (TaskManager::getSortedPage), then the runs are merged. Ties
+     *          are broken by id, then by shard order. Like getSortedPage, not
+     *          safe to call from several threads at once.
+     */
+    ShardedPage getSortedPage(TaskSortKey key, size_t offset = 0,
+                              size_t limit = std::numeric_limits<size_t>::max()) const;
+
+    /**
+     * @brief Run a query on every shard and merge the matches
+     * @details Sorted queries are k-way merged like getSortedPage; unsorted ones
+     *          list the shards' matches shard by shard
+     */
+    ShardedPage runQuery(const TaskQuery& query) const;
+
+    /**
+     * @brief Find tasks by words in title or description in every shard
+     * @return Matches shard by shard, ascending id within a shard
+     */
+    std::vector<ShardedTask> findTasks(std::string_view query) const;
+};
+
+#endif // SHARDED_TASK_STORE_H
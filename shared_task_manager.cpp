@@ -0,0 +1,190 @@
+/**
+ * @file shared_task_manager.cpp
+ * @brief Implementation of SharedTaskManager
+ */
+
+#include "shared_task_manager.h"
+
+namespace {
+
+/**
+ * @brief Copy a range of tasks out while the lock is still held
+ */
+template<std::ranges::input_range R>
+std::vector<Task> copyTasks(R&& range) {
+    std::vector<Task> tasks;
+    for (const Task& task : range) {
+        tasks.push_back(task);
+    }
+    return tasks;
+}
+
+} // namespace
+
+std::shared_ptr<const TaskSnapshot> SharedTaskManager::snapshot() const {
+    std::shared_lock lock(_mutex);
+    // Writers touch the snapshot state only under the exclusive lock, so this mutex
+    // just keeps concurrent readers from building the same snapshot twice
+    std::lock_guard guard(_snapshot_mutex);
+    if (_snapshot) {
+        return _snapshot;
+    }
+
+    const auto& tasks = _manager.getAllTasks();
+    const size_t chunk_count = (tasks.size() + SNAPSHOT_CHUNK - 1) / SNAPSHOT_CHUNK;
+    _chunks.resize(chunk_count);
+    _dirty.resize(chunk_count, false);
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        if (chunk < _dirty_from && !_dirty[chunk] && _chunks[chunk]) {
+            continue;  // Unchanged since the last snapshot; share it
+        }
+        auto first = tasks.begin() + static_cast<std::ptrdiff_t>(chunk * SNAPSHOT_CHUNK);
+        auto last = tasks.begin() + static_cast<std::ptrdiff_t>(std::min(tasks.size(), (chunk + 1) * SNAPSHOT_CHUNK));
+        _chunks[chunk] = std::make_shared<const TaskSnapshot::Chunk>(first, last);
+    }
+    _dirty.assign(chunk_count, false);
+    _dirty_from = chunk_count;
+
+    _snapshot = std::make_shared<const TaskSnapshot>(TaskSnapshot{
+        .chunks = _chunks,
+        .size = tasks.size(),
+        .version = version()
+    });
+    return _snapshot;
+}
+
+void SharedTaskManager::markSlotDirty(size_t slot) {
+    size_t chunk = slot / SNAPSHOT_CHUNK;
+    if (chunk < _dirty.size()) {
+        _dirty[chunk] = true;
+    } else {
+        markDirtyFrom(slot);
+    }
+}
+
+std::optional<size_t> SharedTaskManager::slotOf(int id) const {
+    const Task* task = _manager.findTask(id);
+    if (!task) {
+        return std::nullopt;
+    }
+    return static_cast<size_t>(task - _manager.getAllTasks().data());
+}
+
+TaskAddResult SharedTaskManager::addTask(const std::string& title, const std::string& description) {
+    std::unique_lock lock(_mutex);
+    auto result = _manager.addTask(title, description);
+    if (result) {
+        markDirtyFrom(_manager.getTaskCount() - 1);
+        retireSnapshot();
+    }
+    return result;
+}
+
+TaskResult SharedTaskManager::removeTask(int id) {
+    std::unique_lock lock(_mutex);
+    auto slot = slotOf(id);
+    auto result = _manager.removeTask(id);
+    if (result && slot) {
+        // Every task behind the removed one moves down a slot
+        markDirtyFrom(*slot);
+        retireSnapshot();
+    }
+    return result;
+}
+
+TaskResult SharedTaskManager::updateTaskStatus(int id, TaskStatus status) {
+    return writeTask(id, [&](TaskManager& manager) { return manager.updateTaskStatus(id, status); });
+}
+
+TaskResult SharedTaskManager::updateTaskTitle(int id, const std::string& title) {
+    return writeTask(id, [&](TaskManager& manager) { return manager.updateTaskTitle(id, title); });
+}
+
+TaskResult SharedTaskManager::updateTaskDescription(int id, const std::string& description) {
+    return writeTask(id, [&](TaskManager& manager) { return manager.updateTaskDescription(id, description); });
+}
+
+TaskResult SharedTaskManager::updateTaskPriority(int id, int priority) {
+    return writeTask(id, [&](TaskManager& manager) { return manager.updateTaskPriority(id, priority); });
+}
+
+TaskResult SharedTaskManager::updateTaskCategory(int id, const std::string& category) {
+    return writeTask(id, [&](TaskManager& manager) { return manager.updateTaskCategory(id, category); });
+}
+
+BatchResult SharedTaskManager::applyBatch(std::span<const TaskUpdate> updates) {
+    std::unique_lock lock(_mutex);
+    auto result = _manager.applyBatch(updates);
+    for (const auto& update : updates) {
+        if (auto slot = slotOf(update.id)) {
+            markSlotDirty(*slot);
+        }
+    }
+    retireSnapshot();
+    return result;
+}
+
+JsonResult SharedTaskManager::loadFromJson(const std::string& filename) {
+    return write([&](TaskManager& manager) { return manager.loadFromJson(filename); });
+}
+
+JsonResult SharedTaskManager::loadFromBinary(const std::string& filename) {
+    return write([&](TaskManager& manager) { return manager.loadFromBinary(filename); });
+}
+
+TaskOptional SharedTaskManager::getTask(int id) const {
+    return read([id](const TaskManager& manager) -> TaskOptional {
+        const Task* task = manager.findTask(id);
+        if (!task) {
+            return std::unexpected(TaskError::TaskNotFound);
+        }
+        return *task;
+    });
+}
+
+std::vector<Task> SharedTaskManager::getTasksByStatus(TaskStatus status) const {
+    return read([status](const TaskManager& manager) { return copyTasks(manager.getTasksByStatus(status)); });
+}
+
+std::vector<Task> SharedTaskManager::getTasksByPriority(int min_priority, int max_priority) const {
+    return read([=](const TaskManager& manager) {
+        return copyTasks(manager.getTasksByPriority(min_priority, max_priority));
+    });
+}
+
+std::vector<Task> SharedTaskManager::getTasksByCategory(std::string_view category) const {
+    return read([category](const TaskManager& manager) { return copyTasks(manager.getTasksByCategory(category)); });
+}
+
+std::vector<int> SharedTaskManager::findTasks(std::string_view query) const {
+    return read([query](const TaskManager& manager) { return manager.findTasks(query); });
+}
+
+size_t SharedTaskManager::getTaskCount() const {
+    return read([](const TaskManager& manager) { return manager.getTaskCount(); });
+}
+
+StatusCounters SharedTaskManager::getCounters() const {
+    return read([](const TaskManager& manager) { return manager.getCounters(); });
+}
+
+double SharedTaskManager::getCompletionRate() const {
+    return read([](const TaskManager& manager) { return manager.getCompletionRate(); });
+}
+
+JsonResult SharedTaskManager::saveToJson(const std::string& filename) const {
+    return read([&](const TaskManager& manager) { return manager.saveToJson(filename); });
+}
+
+JsonResult SharedTaskManager::saveToBinary(const std::string& filename) const {
+    return read([&](const TaskManager& manager) { return manager.saveToBinary(filename); });
+}
+
+std::vector<Task> SharedTaskManager::getSortedPage(TaskSortKey key, size_t offset, size_t limit) const {
+    std::unique_lock lock(_mutex);
+    std::vector<Task> tasks;
+    for (const Task* task : _manager.getSortedPage(key, offset, limit).tasks) {
+        tasks.push_back(*task);
+    }
+    return tasks;
+}
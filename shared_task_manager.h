@@ -0,0 +1,227 @@
+#ifndef SHARED_TASK_MANAGER_H
+#define SHARED_TASK_MANAGER_H
+
+/**
+ * @file shared_task_manager.h
+ * @brief Thread-safe front-end over TaskManager for embedded/server use
+ * @details Reads take a shared lock and run concurrently; mutations take an
+ *          exclusive lock and are serialized. Everything is returned by value,
+ *          never as a lazy view or pointer into the table. Long scans should run
+ *          on snapshot(): an immutable copy-on-write image of the task table that
+ *          is shared between readers until the next mutation, so a scan holds no
+ *          lock at all and never delays a status update. Snapshots are built from
+ *          fixed-size chunks of tasks, and a new snapshot only re-copies the chunks
+ *          touched since the previous one.
+ */
+
+#include "task_manager.h"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct TaskSnapshot
+ * @brief Immutable image of the task table at one version
+ */
+struct TaskSnapshot {
+    using Chunk = std::vector<Task>;
+
+    std::vector<std::shared_ptr<const Chunk>> chunks; ///< Consecutive slices of the task table
+    size_t size = 0;                                  ///< Total number of tasks
+    std::uint64_t version = 0;                        ///< SharedTaskManager::version() when taken
+
+    /**
+     * @brief All tasks in collection order
+     * @details Safe to iterate from any thread for as long as the snapshot is held
+     */
+    auto tasks() const {
+        return chunks
+             | std::views::transform([](const std::shared_ptr<const Chunk>& chunk) -> const Chunk& { return *chunk; })
+             | std::views::join;
+    }
+
+    /**
+     * @brief Filter the snapshot's tasks
+     * @tparam Predicate Function type that takes a Task and returns bool
+     * @param pred Predicate function for filtering
+     * @return Range of matching tasks
+     */
+    template<std::predicate<const Task&> Predicate>
+    auto filter(Predicate&& pred) const {
+        return tasks() | std::views::filter(std::forward<Predicate>(pred));
+    }
+};
+
+/**
+ * @class SharedTaskManager
+ * @brief TaskManager guarded by a std::shared_mutex, plus COW snapshots
+ * @details The wrapped manager is only reachable through read() and write(), so
+ *          no caller can touch it without the matching lock.
+ */
+class SharedTaskManager {
+private:
+    mutable std::shared_mutex _mutex;   /**< Shared for reads, exclusive for writes */
+    TaskManager _manager;               /**< Guarded by _mutex */
+
+    std::atomic<std::uint64_t> _version{0};  /**< Bumped by every write */
+
+    static constexpr auto SNAPSHOT_CHUNK = 1024uz;  /**< Tasks per snapshot chunk */
+
+    mutable std::mutex _snapshot_mutex;                /**< Serializes snapshot construction */
+    mutable std::shared_ptr<const TaskSnapshot> _snapshot; /**< Current snapshot, nullptr if stale */
+
+    /**
+     * @brief Chunks of the last snapshot, reused for the next one where clean
+     */
+    mutable std::vector<std::shared_ptr<const TaskSnapshot::Chunk>> _chunks;
+
+    /**
+     * @brief Index of the first chunk changed since the last snapshot, for
+     *        mutations that shift slots; every chunk from here on is re-copied
+     */
+    mutable size_t _dirty_from = 0;
+    mutable std::vector<bool> _dirty;  /**< Chunks changed in place since the last snapshot */
+
+    /**
+     * @brief Record a mutation: bump the version and retire the current snapshot
+     * @details Called with _mutex held exclusively; readers still holding the old
+     *          snapshot keep it alive
+     */
+    void retireSnapshot() {
+        _version.fetch_add(1, std::memory_order_release);
+        _snapshot.reset();
+    }
+
+    /**
+     * @brief Mark the chunk holding a slot as changed in place
+     */
+    void markSlotDirty(size_t slot);
+
+    /**
+     * @brief Mark every chunk from the one holding slot onwards as changed
+     */
+    void markDirtyFrom(size_t slot) {
+        _dirty_from = std::min(_dirty_from, slot / SNAPSHOT_CHUNK);
+    }
+
+    /**
+     * @brief Slot of a task in the wrapped manager
+     * @return Slot, or nullopt if no task has this ID
+     */
+    std::optional<size_t> slotOf(int id) const;
+
+    /**
+     * @brief Run a mutation of one existing task that keeps slots in place
+     */
+    template<typename Fn>
+    TaskResult writeTask(int id, Fn&& fn) {
+        std::unique_lock lock(_mutex);
+        auto result = std::forward<Fn>(fn)(_manager);
+        if (auto slot = slotOf(id)) {
+            markSlotDirty(*slot);
+        }
+        retireSnapshot();
+        return result;
+    }
+
+public:
+    /**
+     * @brief Run a read-only operation under a shared lock
+     * @details fn must not let references or views into the manager escape
+     * @tparam Fn Callable taking const TaskManager&
+     * @param fn Operation to run
+     * @return Whatever fn returns
+     */
+    template<typename Fn>
+    decltype(auto) read(Fn&& fn) const {
+        std::shared_lock lock(_mutex);
+        return std::forward<Fn>(fn)(std::as_const(_manager));
+    }
+
+    /**
+     * @brief Run a mutation under an exclusive lock
+     * @details Always counts as a write; use read() for anything that does not modify
+     * @tparam Fn Callable taking TaskManager&
+     * @param fn Operation to run
+     * @return Whatever fn returns
+     */
+    template<typename Fn>
+    decltype(auto) write(Fn&& fn) {
+        std::unique_lock lock(_mutex);
+        retireSnapshot();
+        markDirtyFrom(0);  // Unknown change: the next snapshot copies everything
+        return std::forward<Fn>(fn)(_manager);
+    }
+
+    /**
+     * @brief Get an immutable image of the task table
+     * @details Built under a shared lock on first use after a write, then shared by
+     *          every reader until the next write. Only chunks changed since the
+     *          previous snapshot are copied. Holding one never blocks writers.
+     * @return Snapshot of the current tasks
+     */
+    std::shared_ptr<const TaskSnapshot> snapshot() const;
+
+    /**
+     * @brief Number of writes so far
+     * @details Lets callers tell whether a snapshot is still current
+     */
+    std::uint64_t version() const {
+        return _version.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @name Mutations (exclusive lock)
+     */
+    ///@{
+    TaskAddResult addTask(const std::string& title, const std::string& description = "");
+    TaskResult removeTask(int id);
+    TaskResult updateTaskStatus(int id, TaskStatus status);
+    TaskResult updateTaskTitle(int id, const std::string& title);
+    TaskResult updateTaskDescription(int id, const std::string& description);
+    TaskResult updateTaskPriority(int id, int priority);
+    TaskResult updateTaskCategory(int id, const std::string& category);
+    BatchResult applyBatch(std::span<const TaskUpdate> updates);
+    JsonResult loadFromJson(const std::string& filename);
+    JsonResult loadFromBinary(const std::string& filename);
+    ///@}
+
+    /**
+     * @name Reads (shared lock, results copied out)
+     */
+    ///@{
+    TaskOptional getTask(int id) const;
+    std::vector<Task> getTasksByStatus(TaskStatus status) const;
+    std::vector<Task> getTasksByPriority(int min_priority, int max_priority) const;
+    std::vector<Task> getTasksByCategory(std::string_view category) const;
+    std::vector<int> findTasks(std::string_view query) const;
+    size_t getTaskCount() const;
+    StatusCounters getCounters() const;
+    double getCompletionRate() const;
+    JsonResult saveToJson(const std::string& filename) const;
+    JsonResult saveToBinary(const std::string& filename) const;
+    ///@}
+
+    /**
+     * @brief Get one page of a sorted view, copied out
+     * @details Takes the exclusive lock: TaskManager fills its sort-order cache
+     *          lazily, so this read is not safe under a shared lock
+     * @param key Sort key
+     * @param offset Number of leading tasks to skip
+     * @param limit Maximum number of tasks to return
+     * @return Tasks on the page, in order
+     */
+    std::vector<Task> getSortedPage(TaskSortKey key, size_t offset, size_t limit) const;
+};
+
+#endif // SHARED_TASK_MANAGER_H
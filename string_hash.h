@@ -0,0 +1,27 @@
+#ifndef STRING_HASH_H
+#define STRING_HASH_H
+
+/**
+ * @file string_hash.h
+ * @brief Transparent string hashing for heterogeneous unordered lookups
+ */
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+/**
+ * @struct TransparentStringHash
+ * @brief String hash enabling heterogeneous lookup with std::string_view keys
+ * @details C++20: is_transparent lets unordered containers be queried without
+ *          constructing a temporary std::string
+ */
+struct TransparentStringHash {
+    using is_transparent = void;
+    
+    size_t operator()(std::string_view str) const noexcept {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+#endif // STRING_HASH_H
@@ -0,0 +1,181 @@
+/**
+ * @file string_search.cpp
+ * @brief Scalar, SSE2 and AVX2 kernels for containsIgnoreCase
+ */
+
+#include "string_search.h"
+#include <cstddef>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TASKTRACKER_HAS_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define TASKTRACKER_HAS_X86_SIMD 0
+#endif
+
+namespace {
+
+inline unsigned char fold(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c | 0x20) : c;
+}
+
+inline bool isAsciiLetter(unsigned char c) {
+    c = fold(c);
+    return c >= 'a' && c <= 'z';
+}
+
+/**
+ * @brief Compare count bytes ignoring ASCII case
+ */
+inline bool equalFolded(const char* a, const char* b, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (fold(static_cast<unsigned char>(a[i])) != fold(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Scalar search over start positions [from, haystack.size() - needle.size()]
+ */
+bool containsScalarFrom(std::string_view haystack, std::string_view needle, size_t from) {
+    const size_t n = needle.size();
+    const unsigned char first = fold(static_cast<unsigned char>(needle[0]));
+    for (size_t i = from; i + n <= haystack.size(); ++i) {
+        if (fold(static_cast<unsigned char>(haystack[i])) == first &&
+            equalFolded(haystack.data() + i + 1, needle.data() + 1, n - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if TASKTRACKER_HAS_X86_SIMD
+
+/*
+ * For a letter, (c | 0x20) equals the lower-case letter exactly when c is that
+ * letter in either case, so OR-ing the haystack with 0x20 folds it for the
+ * comparison. Other bytes are compared unchanged.
+ */
+
+bool containsSse2(std::string_view haystack, std::string_view needle) {
+    const size_t n = needle.size();
+    const auto first = fold(static_cast<unsigned char>(needle[0]));
+    const auto last = fold(static_cast<unsigned char>(needle[n - 1]));
+    const __m128i first_or = _mm_set1_epi8(isAsciiLetter(first) ? 0x20 : 0);
+    const __m128i last_or = _mm_set1_epi8(isAsciiLetter(last) ? 0x20 : 0);
+    const __m128i first_v = _mm_set1_epi8(static_cast<char>(first));
+    const __m128i last_v = _mm_set1_epi8(static_cast<char>(last));
+    const size_t middle = n > 2 ? n - 2 : 0;
+    const size_t starts = haystack.size() - n + 1;
+    const char* data = haystack.data();
+
+    size_t i = 0;
+    for (; i + 16 <= starts; i += 16) {
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + n - 1));
+        __m128i eq_first = _mm_cmpeq_epi8(_mm_or_si128(block_first, first_or), first_v);
+        __m128i eq_last = _mm_cmpeq_epi8(_mm_or_si128(block_last, last_or), last_v);
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(eq_first, eq_last)));
+        while (mask != 0) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (equalFolded(data + i + bit + 1, needle.data() + 1, middle)) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return containsScalarFrom(haystack, needle, i);
+}
+
+__attribute__((target("avx2")))
+bool containsAvx2(std::string_view haystack, std::string_view needle) {
+    const size_t n = needle.size();
+    const auto first = fold(static_cast<unsigned char>(needle[0]));
+    const auto last = fold(static_cast<unsigned char>(needle[n - 1]));
+    const __m256i first_or = _mm256_set1_epi8(isAsciiLetter(first) ? 0x20 : 0);
+    const __m256i last_or = _mm256_set1_epi8(isAsciiLetter(last) ? 0x20 : 0);
+    const __m256i first_v = _mm256_set1_epi8(static_cast<char>(first));
+    const __m256i last_v = _mm256_set1_epi8(static_cast<char>(last));
+    const size_t middle = n > 2 ? n - 2 : 0;
+    const size_t starts = haystack.size() - n + 1;
+    const char* data = haystack.data();
+
+    size_t i = 0;
+    for (; i + 32 <= starts; i += 32) {
+        __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + n - 1));
+        __m256i eq_first = _mm256_cmpeq_epi8(_mm256_or_si256(block_first, first_or), first_v);
+        __m256i eq_last = _mm256_cmpeq_epi8(_mm256_or_si256(block_last, last_or), last_v);
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(eq_first, eq_last)));
+        while (mask != 0) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (equalFolded(data + i + bit + 1, needle.data() + 1, middle)) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+    // Finish the remaining (< 32) start positions 16 at a time where possible
+    std::string_view rest = haystack.substr(i);
+    return rest.size() >= n && containsSse2(rest, needle);
+}
+
+#endif
+
+StringSearchImpl detectImpl() {
+#if TASKTRACKER_HAS_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        return StringSearchImpl::AVX2;
+    }
+    return StringSearchImpl::SSE2;
+#else
+    return StringSearchImpl::Scalar;
+#endif
+}
+
+} // namespace
+
+bool isStringSearchImplSupported(StringSearchImpl impl) {
+    switch (impl) {
+        case StringSearchImpl::Scalar: return true;
+        case StringSearchImpl::SSE2: return TASKTRACKER_HAS_X86_SIMD;
+        case StringSearchImpl::AVX2: return activeStringSearchImpl() == StringSearchImpl::AVX2;
+        default: return false;
+    }
+}
+
+StringSearchImpl activeStringSearchImpl() {
+    static const StringSearchImpl impl = detectImpl();
+    return impl;
+}
+
+std::string_view stringSearchImplName(StringSearchImpl impl) {
+    switch (impl) {
+        case StringSearchImpl::Scalar: return "scalar";
+        case StringSearchImpl::SSE2: return "sse2";
+        case StringSearchImpl::AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+bool containsIgnoreCase(std::string_view haystack, std::string_view needle, StringSearchImpl impl) {
+    if (needle.empty()) return true;
+    if (needle.size() > haystack.size()) return false;
+
+    if (!isStringSearchImplSupported(impl)) {
+        impl = StringSearchImpl::Scalar;
+    }
+    switch (impl) {
+#if TASKTRACKER_HAS_X86_SIMD
+        case StringSearchImpl::AVX2: return containsAvx2(haystack, needle);
+        case StringSearchImpl::SSE2: return containsSse2(haystack, needle);
+#endif
+        default: return containsScalarFrom(haystack, needle, 0);
+    }
+}
+
+bool containsIgnoreCase(std::string_view haystack, std::string_view needle) {
+    return containsIgnoreCase(haystack, needle, activeStringSearchImpl());
+}
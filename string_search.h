@@ -0,0 +1,54 @@
+#ifndef STRING_SEARCH_H
+#define STRING_SEARCH_H
+
+/**
+ * @file string_search.h
+ * @brief ASCII case-insensitive substring search with SIMD kernels
+ * @details Candidate positions are found by comparing the first and last needle
+ *          bytes against 16 (SSE2) or 32 (AVX2) haystack positions at once; only
+ *          candidates are verified byte by byte. The kernel is chosen once at
+ *          runtime from the CPU features. Nothing is copied or allocated.
+ */
+
+#include <string_view>
+
+/**
+ * @enum StringSearchImpl
+ * @brief Available substring search kernels
+ */
+enum class StringSearchImpl {
+    Scalar,     ///< Portable byte loop
+    SSE2,       ///< 16 positions per step (x86-64 baseline)
+    AVX2        ///< 32 positions per step, if the CPU supports it
+};
+
+/**
+ * @brief Check whether haystack contains needle, ignoring ASCII case
+ * @param haystack Text to search
+ * @param needle Text to look for (an empty needle always matches)
+ * @return true if needle occurs in haystack
+ */
+bool containsIgnoreCase(std::string_view haystack, std::string_view needle);
+
+/**
+ * @brief Same as containsIgnoreCase(haystack, needle) with a forced kernel
+ * @details For benchmarks; kernels the CPU or build does not support fall back to Scalar
+ */
+bool containsIgnoreCase(std::string_view haystack, std::string_view needle, StringSearchImpl impl);
+
+/**
+ * @brief Kernel used by containsIgnoreCase(haystack, needle)
+ */
+StringSearchImpl activeStringSearchImpl();
+
+/**
+ * @brief Check whether a kernel can run on this CPU and build
+ */
+bool isStringSearchImplSupported(StringSearchImpl impl);
+
+/**
+ * @brief Name of a kernel for diagnostics
+ */
+std::string_view stringSearchImplName(StringSearchImpl impl);
+
+#endif // STRING_SEARCH_H
@@ -7,9 +7,12 @@
 
 #include "task.h"
 #include "task_manager.h"
+#include "task_json.h"
+#include "timestamp.h"
+#include "perf_counters.h"
 #include <iostream>
-#include <iomanip>
 #include <sstream>
+#include <ctime>
 
 /**
  * @brief Constructs a Task object with specified properties
@@ -23,46 +26,50 @@ Task::Task(int id, std::string title, std::string description, TaskStatus status
     auto now = std::chrono::system_clock::now();
     _metadata.created_at = now;
     _metadata.updated_at = now;
-    _metadata.category = "General";
+    static const InternedString default_category("General");  // Skip the pool lookup per task
+    _metadata.category = default_category;
 }
 
 /**
  * @brief Sets the task's title
  * @param title New title for the task
+ * @param when Modification time
  * @return TaskResult with success or error
  */
-TaskResult Task::setTitle(const std::string& title) {
+TaskResult Task::setTitle(const std::string& title, std::chrono::system_clock::time_point when) {
     if (title.empty()) {
         return std::unexpected(TaskError::EmptyTitle);
     }
     _title = title;
-    _metadata.updated_at = std::chrono::system_clock::now();
+    _metadata.updated_at = when;
     return true;
 }
 
 /**
  * @brief Sets the task's description
  * @param description New description for the task
+ * @param when Modification time
  * @return TaskResult with success
  */
-TaskResult Task::setDescription(const std::string& description) {
+TaskResult Task::setDescription(const std::string& description, std::chrono::system_clock::time_point when) {
     _description = description;
-    _metadata.updated_at = std::chrono::system_clock::now();
+    _metadata.updated_at = when;
     return true;
 }
 
 /**
  * @brief Sets the task's status
  * @param status New status for the task
+ * @param when Modification time
  * @return TaskResult with success
  * @details If status is Completed, also sets the completed_at timestamp
  */
-TaskResult Task::setStatus(TaskStatus status) {
+TaskResult Task::setStatus(TaskStatus status, std::chrono::system_clock::time_point when) {
     _status = status;
-    _metadata.updated_at = std::chrono::system_clock::now();
+    _metadata.updated_at = when;
     
     if (status == TaskStatus::Completed) {
-        _metadata.completed_at = std::chrono::system_clock::now();
+        _metadata.completed_at = when;
     }
     
     return true;
@@ -71,27 +78,29 @@ TaskResult Task::setStatus(TaskStatus status) {
 /**
  * @brief Sets the task's priority
  * @param priority New priority for the task (0-10)
+ * @param when Modification time
  * @return TaskResult with success or error if priority is invalid
  */
-TaskResult Task::setPriority(int priority) {
+TaskResult Task::setPriority(int priority, std::chrono::system_clock::time_point when) {
     // Validate priority range (0-10)
     if (priority < 0 || priority > 10) {
         return std::unexpected(TaskError::InvalidPriority);
     }
     
     _metadata.priority = priority;
-    _metadata.updated_at = std::chrono::system_clock::now();
+    _metadata.updated_at = when;
     return true;
 }
 
 /**
  * @brief Sets the task's category
  * @param category New category for the task
+ * @param when Modification time
  * @return TaskResult with success
  */
-TaskResult Task::setCategory(const std::string& category) {
+TaskResult Task::setCategory(const std::string& category, std::chrono::system_clock::time_point when) {
     _metadata.category = category;
-    _metadata.updated_at = std::chrono::system_clock::now();
+    _metadata.updated_at = when;
     return true;
 }
 
@@ -174,27 +183,7 @@ std::string jsonErrorToString(JsonError error) {
 std::string escapeJsonString(const std::string& str) {
     std::string escaped;
     escaped.reserve(str.size() + 20); // Reserve some extra space for escapes
-    
-    for (unsigned char c : str) {
-        switch (c) {
-            case '"': escaped += "\\\""; break;
-            case '\\': escaped += "\\\\"; break;
-            case '\b': escaped += "\\b"; break;
-            case '\f': escaped += "\\f"; break;
-            case '\n': escaped += "\\n"; break;
-            case '\r': escaped += "\\r"; break;
-            case '\t': escaped += "\\t"; break;
-            default:
-                // Only escape actual control characters (0-31), not UTF-8 bytes
-                if (c < 32) {
-                    escaped += std::format("\\u{:04x}", c);
-                } else {
-                    // For UTF-8 and normal ASCII (32-255), keep as-is
-                    escaped += static_cast<char>(c);
-                }
-                break;
-        }
-    }
+    appendJsonEscaped(escaped, str);
     return escaped;
 }
 
@@ -229,68 +218,33 @@ std::string unescapeJsonString(const std::string& str) {
 /**
  * @brief Convert time_point to ISO 8601 formatted string
  * @param tp The time point to convert
- * @return ISO 8601 formatted string (YYYY-MM-DDTHH:MM:SS.mmm)
+ * @return UTC timestamp (YYYY-MM-DDTHH:MM:SS.mmmZ)
  */
 std::string timePointToIsoString(const std::chrono::system_clock::time_point& tp) {
-    auto time_t = std::chrono::system_clock::to_time_t(tp);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()) % 1000;
-    
-    std::ostringstream oss;
-    // Fix: Use localtime instead of gmtime to show local timezone
-    oss << std::put_time(std::localtime(&time_t), "%Y-%m-%dT%H:%M:%S");
-    oss << std::format(".{:03d}", ms.count()); // Remove Z suffix for local time
-    return oss.str();
+    std::string result;
+    appendIsoTimestamp(result, tp);
+    return result;
 }
 
 /**
  * @brief Parse ISO 8601 formatted string to time_point
  * @param iso_str The ISO 8601 string to parse
- * @return Corresponding time_point
- * @details Handles millisecond precision if present
+ * @return Corresponding time_point, or the epoch if the string is malformed
+ * @details See parseIsoTimestamp for the accepted forms
  */
-std::chrono::system_clock::time_point isoStringToTimePoint(const std::string& iso_str) {
-    std::tm tm = {};
-    std::istringstream ss(iso_str);
-    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
-    
-    auto tp = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-    
-    // Handle milliseconds if present
-    auto dot_pos = iso_str.find('.');
-    if (dot_pos != std::string::npos) {
-        auto ms_str = iso_str.substr(dot_pos + 1, 3);
-        if (!ms_str.empty() && std::isdigit(ms_str[0])) {
-            int ms = std::stoi(ms_str);
-            tp += std::chrono::milliseconds(ms);
-        }
-    }
-    
-    return tp;
+std::chrono::system_clock::time_point isoStringToTimePoint(std::string_view iso_str) {
+    return parseIsoTimestamp(iso_str).value_or(std::chrono::system_clock::time_point{});
 }
 
 /**
  * @brief Convert Task to JSON string representation
  * @return Formatted JSON string with all task properties
- * @details Uses C++23 std::format for string formatting
+ * @details Formats directly into one buffer through TaskJsonWriter
  */
 std::string Task::toJson() const {
-    std::ostringstream json;
-    json << "{\n";
-    json << std::format("  \"id\": {},\n", _id);
-    json << std::format("  \"title\": \"{}\",\n", escapeJsonString(_title));
-    json << std::format("  \"description\": \"{}\",\n", escapeJsonString(_description));
-    json << std::format("  \"status\": \"{}\",\n", taskStatusToString(_status));
-    json << std::format("  \"category\": \"{}\",\n", escapeJsonString(_metadata.category));
-    json << std::format("  \"priority\": {},\n", _metadata.priority);
-    json << std::format("  \"created_at\": \"{}\",\n", timePointToIsoString(_metadata.created_at));
-    json << std::format("  \"updated_at\": \"{}\"", timePointToIsoString(_metadata.updated_at));
-    
-    if (_metadata.completed_at.has_value()) {
-        json << std::format(",\n  \"completed_at\": \"{}\"", timePointToIsoString(*_metadata.completed_at));
-    }
-    
-    json << "\n}";
-    return json.str();
+    TaskJsonWriter writer;
+    writer.writeTask(*this);
+    return writer.take();
 }
 
 /**
@@ -299,90 +253,16 @@ std::string Task::toJson() const {
  * @return Task object if successful, or JsonError if parsing failed
  * @details C++23 Feature: Uses std::expected for error handling
  */
-std::expected<Task, JsonError> Task::fromJson(const std::string& json_str) {
+std::expected<Task, JsonError> Task::fromJson(std::string_view json_str) {
+    PerfScope perf(PerfProbe::TaskFromJson);
+    perf.addBytes(json_str.size());
     try {
-        // Simple JSON parsing - in production, use a proper JSON library
-        auto findValue = [&json_str](const std::string& key) -> std::string {
-            std::string search_key = "\"" + key + "\":";
-            size_t pos = json_str.find(search_key);
-            if (pos == std::string::npos) return "";
-            
-            pos += search_key.length();
-            while (pos < json_str.length() && std::isspace(json_str[pos])) ++pos;
-            
-            if (pos >= json_str.length()) return "";
-            
-            if (json_str[pos] == '"') {
-                // String value
-                ++pos;
-                size_t end_pos = pos;
-                while (end_pos < json_str.length() && json_str[end_pos] != '"') {
-                    if (json_str[end_pos] == '\\') ++end_pos; // Skip escaped characters
-                    ++end_pos;
-                }
-                return unescapeJsonString(json_str.substr(pos, end_pos - pos));
-            } else {
-                // Number or other value
-                size_t end_pos = pos;
-                while (end_pos < json_str.length() && 
-                       json_str[end_pos] != ',' && 
-                       json_str[end_pos] != '}' && 
-                       json_str[end_pos] != '\n' &&
-                       json_str[end_pos] != '\r') {
-                    ++end_pos;
-                }
-                std::string value = json_str.substr(pos, end_pos - pos);
-                // Trim whitespace
-                value.erase(0, value.find_first_not_of(" \t\n\r"));
-                value.erase(value.find_last_not_of(" \t\n\r") + 1);
-                return value;
-            }
-        };
-        
-        std::string id_str = findValue("id");
-        std::string title = findValue("title");
-        std::string description = findValue("description");
-        std::string status_str = findValue("status");
-        std::string category = findValue("category");
-        std::string priority_str = findValue("priority");
-        std::string created_at_str = findValue("created_at");
-        std::string updated_at_str = findValue("updated_at");
-        std::string completed_at_str = findValue("completed_at");
-        
-        if (id_str.empty() || title.empty()) {
-            return std::unexpected(JsonError::InvalidFormat);
-        }
-        
-        int id = std::stoi(id_str);
-        auto status_opt = stringToTaskStatus(status_str);
-        if (!status_opt) {
-            return std::unexpected(JsonError::InvalidFormat);
-        }
-        
-        Task task(id, title, description, *status_opt);
-        
-        if (!category.empty()) {
-            task.setCategory(category);
-        }
-        
-        if (!priority_str.empty()) {
-            int priority = std::stoi(priority_str);
-            task.setPriority(priority);
-        }
-        
-        if (!created_at_str.empty()) {
-            task._metadata.created_at = isoStringToTimePoint(created_at_str);
-        }
-        
-        if (!updated_at_str.empty()) {
-            task._metadata.updated_at = isoStringToTimePoint(updated_at_str);
-        }
-        
-        if (!completed_at_str.empty()) {
-            task._metadata.completed_at = isoStringToTimePoint(completed_at_str);
+        TaskJsonReader reader(json_str);
+        TaskRecord record;
+        if (auto result = reader.readObject(record); !result) {
+            return std::unexpected(result.error().error);
         }
-        
-        return task;
+        return record.toTask();
     } catch (const std::exception&) {
         return std::unexpected(JsonError::ParseError);
     }
@@ -411,7 +291,7 @@ std::string taskStatusToString(TaskStatus status) {
  * @return TaskStatus if valid, nullopt if invalid
  * @details Case-insensitive and handles common status name variations
  */
-std::optional<TaskStatus> stringToTaskStatus(const std::string& str) {
+std::optional<TaskStatus> stringToTaskStatus(std::string_view str) {
     if (str == "pending" || str == "Pending") return TaskStatus::Pending;
     if (str == "progress" || str == "in-progress" || str == "In Progress" || str == "InProgress") return TaskStatus::InProgress;
     if (str == "completed" || str == "Completed") return TaskStatus::Completed;
@@ -23,6 +23,8 @@
 #include <compare>
 #include <fstream>
 #include <sstream>
+#include <string_view>
+#include "interned_string.h"
 
 /**
  * @enum TaskStatus
@@ -116,7 +118,7 @@ struct TaskMetadata {
     std::chrono::system_clock::time_point created_at;    ///< When the task was created
     std::chrono::system_clock::time_point updated_at;    ///< When the task was last updated
     std::optional<std::chrono::system_clock::time_point> completed_at; ///< When the task was completed (if applicable)
-    std::string category;   ///< The task's category
+    InternedString category; ///< The task's category, interned (see interned_string.h)
     int priority = 0;       ///< The task's priority (0-10)
     
     /**
@@ -232,37 +234,42 @@ public:
     /**
      * @brief Set the task's title
      * @param title New title for the task
+     * @param when Modification time (defaults to now; batches pass one shared stamp)
      * @return TaskResult indicating success or the reason for failure
      */
-    TaskResult setTitle(const std::string& title);
+    TaskResult setTitle(const std::string& title, std::chrono::system_clock::time_point when = std::chrono::system_clock::now());
     
     /**
      * @brief Set the task's description
      * @param description New description for the task
+     * @param when Modification time (defaults to now; batches pass one shared stamp)
      * @return TaskResult indicating success or the reason for failure
      */
-    TaskResult setDescription(const std::string& description);
+    TaskResult setDescription(const std::string& description, std::chrono::system_clock::time_point when = std::chrono::system_clock::now());
     
     /**
      * @brief Set the task's status
      * @param status New status for the task
+     * @param when Modification time (defaults to now; batches pass one shared stamp)
      * @return TaskResult indicating success or the reason for failure
      */
-    TaskResult setStatus(TaskStatus status);
+    TaskResult setStatus(TaskStatus status, std::chrono::system_clock::time_point when = std::chrono::system_clock::now());
     
     /**
      * @brief Set the task's priority
      * @param priority New priority for the task (0-10)
+     * @param when Modification time (defaults to now; batches pass one shared stamp)
      * @return TaskResult indicating success or the reason for failure
      */
-    TaskResult setPriority(int priority);
+    TaskResult setPriority(int priority, std::chrono::system_clock::time_point when = std::chrono::system_clock::now());
     
     /**
      * @brief Set the task's category
      * @param category New category for the task
+     * @param when Modification time (defaults to now; batches pass one shared stamp)
      * @return TaskResult indicating success or the reason for failure
      */
-    TaskResult setCategory(const std::string& category);
+    TaskResult setCategory(const std::string& category, std::chrono::system_clock::time_point when = std::chrono::system_clock::now());
     
     /**
      * @brief Get a string representation of the task
@@ -315,10 +322,10 @@ public:
     
     /**
      * @brief Create a Task from a JSON string
-     * @param json_str JSON string to parse
+     * @param json_str JSON object text to parse
      * @return Task object if successful, or JsonError if parsing failed
      */
-    static std::expected<Task, JsonError> fromJson(const std::string& json_str);
+    static std::expected<Task, JsonError> fromJson(std::string_view json_str);
 };
 
 /**
@@ -340,7 +347,7 @@ std::string taskStatusToString(TaskStatus status);
  * @param str The string to convert
  * @return TaskStatus if valid, nullopt if invalid
  */
-std::optional<TaskStatus> stringToTaskStatus(const std::string& str);
+std::optional<TaskStatus> stringToTaskStatus(std::string_view str);
 
 /**
  * @brief Convert a TaskError enum to its string representation
@@ -379,6 +386,28 @@ JsonResult deserializeTaskFromJson(Task& task, const std::string& filePath);
  */
 std::string unescapeJsonString(const std::string& str);
 
+/**
+ * @brief Escape special characters in a string for JSON encoding
+ * @param str The string to escape
+ * @return JSON-safe escaped string
+ */
+std::string escapeJsonString(const std::string& str);
+
+/**
+ * @brief Convert a time_point to a UTC ISO 8601 string (YYYY-MM-DDTHH:MM:SS.mmmZ)
+ * @param tp The time point to convert
+ * @return Formatted timestamp
+ */
+std::string timePointToIsoString(const std::chrono::system_clock::time_point& tp);
+
+/**
+ * @brief Parse an ISO 8601 string into a time_point
+ * @details Timestamps without a zone designator are read as local time
+ * @param iso_str The timestamp to parse
+ * @return Corresponding time_point, or the epoch if malformed
+ */
+std::chrono::system_clock::time_point isoStringToTimePoint(std::string_view iso_str);
+
 /**
  * @brief Validates priority value at compile time
  * @details C++23 Feature: consteval functions for compile-time validation
@@ -0,0 +1,200 @@
+/**
+ * @file task_autosave.cpp
+ * @brief Implementation of TaskAutosave
+ */
+
+#include "task_autosave.h"
+#include "task_journal.h"
+#include "task_json.h"
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace {
+
+/// Segment epoch that no segment has, so the first handoff copies everything
+constexpr auto NEVER_HANDED = std::numeric_limits<std::uint64_t>::max();
+
+} // namespace
+
+TaskAutosave::TaskAutosave(AutosaveOptions options)
+    : _options(std::move(options)), _worker([this] { run(); }) {}
+
+TaskAutosave::~TaskAutosave() {
+    {
+        std::lock_guard lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    _worker.join();
+}
+
+bool TaskAutosave::poll(const TaskManager& manager) {
+    bool retry;
+    {
+        std::lock_guard lock(_mutex);
+        if (_writing) {
+            return false;
+        }
+        retry = _retry;
+    }
+
+    const std::uint64_t changes = manager.getChangeEpoch() - _handed_epoch;
+    if (changes == 0 && !retry) {
+        return false;
+    }
+    const bool enough_changes = _options.changes > 0 && changes >= _options.changes;
+    const bool interval_passed = _options.interval.count() > 0 &&
+                                 std::chrono::steady_clock::now() - _last_handoff_time >= _options.interval;
+    if (!enough_changes && !interval_passed) {
+        return false;
+    }
+    handOff(manager);
+    return true;
+}
+
+bool TaskAutosave::saveNow(const TaskManager& manager) {
+    wait();
+    bool retry;
+    {
+        std::lock_guard lock(_mutex);
+        retry = _retry;
+    }
+    if (manager.getChangeEpoch() == _handed_epoch && !retry) {
+        return false;
+    }
+    handOff(manager);
+    return true;
+}
+
+void TaskAutosave::wait() {
+    std::unique_lock lock(_mutex);
+    _idle.wait(lock, [&] { return !_writing; });
+}
+
+AutosaveStatus TaskAutosave::status() const {
+    std::lock_guard lock(_mutex);
+    AutosaveStatus status = _status;
+    status.writing = _writing;
+    return status;
+}
+
+void TaskAutosave::handOff(const TaskManager& manager) {
+    const auto start = std::chrono::steady_clock::now();
+    Snapshot snapshot{
+        .next_id = manager.getNextId(),
+        .segment_count = manager.getSegmentCount(),
+        .epoch = manager.getChangeEpoch()
+    };
+
+    // Copy-on-write: unchanged segments are already formatted on the worker
+    const auto epochs = manager.getSegmentEpochs();
+    _handed_epochs.resize(snapshot.segment_count, NEVER_HANDED);
+    for (size_t segment = 0; segment < snapshot.segment_count; ++segment) {
+        const std::uint64_t epoch = segment < epochs.size() ? epochs[segment] : 0;
+        if (_handed_epochs[segment] == epoch) {
+            continue;
+        }
+        _handed_epochs[segment] = epoch;
+
+        manager.collectSegmentTasks(segment, _segment_tasks);
+        SegmentCopy copy{.index = segment};
+        copy.tasks.reserve(_segment_tasks.size());
+        for (const Task* task : _segment_tasks) {
+            copy.tasks.push_back(*task);
+        }
+        snapshot.changed.push_back(std::move(copy));
+    }
+    _handed_epoch = snapshot.epoch;
+    _last_handoff_time = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard lock(_mutex);
+        _pending = std::move(snapshot);
+        _writing = true;
+        _status.last_handoff = _last_handoff_time - start;
+    }
+    _wake.notify_one();
+}
+
+void TaskAutosave::run() {
+    std::unique_lock lock(_mutex);
+    while (true) {
+        _wake.wait(lock, [&] { return _pending || _stop; });
+        if (!_pending) {
+            return;  // Stopping with nothing left to write
+        }
+        Snapshot snapshot = std::move(*_pending);
+        _pending.reset();
+        lock.unlock();
+
+        const auto start = std::chrono::steady_clock::now();
+        size_t bytes = 0;
+        auto result = write(snapshot, bytes);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        lock.lock();
+        _writing = false;
+        if (result) {
+            ++_status.saves;
+            _status.saved_epoch = snapshot.epoch;
+            _status.last_write = elapsed;
+            _status.last_bytes = bytes;
+            _status.last_error.reset();
+            _retry = false;
+        } else {
+            ++_status.failures;
+            _status.last_error = result.error();
+            _retry = true;
+        }
+        _idle.notify_all();
+    }
+}
+
+JsonResult TaskAutosave::write(Snapshot& snapshot, size_t& bytes) {
+    // The formatted segments always follow the snapshots, even if a write fails
+    _formatted.resize(snapshot.segment_count);
+    TaskJsonWriter fragment;
+    for (SegmentCopy& copy : snapshot.changed) {
+        fragment.beginFragment();
+        for (const Task& task : copy.tasks) {
+            fragment.writeDocumentTask(task);
+        }
+        _formatted[copy.index] = fragment.take();
+    }
+
+    // Never write the target in place: a crash must leave the previous document intact
+    const std::string temp_path = _options.path + ".tmp";
+    try {
+        std::ofstream file(temp_path, std::ios::binary);
+        if (!file.is_open()) {
+            return std::unexpected(JsonError::FileNotFound);
+        }
+        TaskJsonWriter writer(file);
+        writer.beginDocument(snapshot.next_id);
+        for (const std::string& part : _formatted) {
+            writer.appendDocumentFragment(part);
+        }
+        writer.endDocument();
+        if (!writer.flush()) {
+            return std::unexpected(JsonError::WriteError);
+        }
+        bytes = static_cast<size_t>(file.tellp());
+        file.close();
+        if (file.fail()) {
+            return std::unexpected(JsonError::WriteError);
+        }
+    } catch (const std::exception&) {
+        return std::unexpected(JsonError::WriteError);
+    }
+
+    if (auto synced = syncFileToDisk(temp_path); !synced) {
+        return synced;
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, _options.path, ec);
+    if (ec) {
+        return std::unexpected(JsonError::WriteError);
+    }
+    return true;
+}
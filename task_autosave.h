@@ -0,0 +1,176 @@
+#ifndef TASK_AUTOSAVE_H
+#define TASK_AUTOSAVE_H
+
+/**
+ * @file task_autosave.h
+ * @brief Background autosave of a TaskManager to a JSON file
+ * @details The interactive thread decides when to save (every N changes and/or
+ *          after an interval, checked whenever it polls; for the app that is
+ *          after each command, so changes left at an idle prompt wait for the
+ *          next command or exit) and hands off a snapshot; a worker thread formats
+ *          and writes it. The handoff is copy-on-write per segment (see
+ *          TaskManager::SEGMENT_SIZE): only segments whose change epoch moved
+ *          since the previous handoff are copied, so a save after a few edits
+ *          costs the interactive thread a few segment copies, not a copy of
+ *          every task. The worker keeps each segment's formatted JSON and
+ *          reformats only the copied ones, then writes the document to a
+ *          temporary file, syncs it and renames it over the target, so the
+ *          target is always either the previous or the new complete document.
+ *          Tasks are written in id order.
+ */
+
+#include "task.h"
+#include "task_manager.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct AutosaveOptions
+ * @brief When and where to autosave
+ */
+struct AutosaveOptions {
+    std::string path;                           ///< JSON file to keep up to date
+    std::chrono::seconds interval{30};          ///< Save changes once this old, checked at each poll(); 0 disables
+    std::uint64_t changes = 100;                ///< Save once this many changes accumulated; 0 disables
+};
+
+/**
+ * @struct AutosaveStatus
+ * @brief Progress of the autosave worker
+ */
+struct AutosaveStatus {
+    size_t saves = 0;                           ///< Completed saves
+    size_t failures = 0;                        ///< Failed saves
+    bool writing = false;                       ///< A snapshot is being written
+    std::uint64_t saved_epoch = 0;              ///< Change epoch of the last completed save
+    std::chrono::nanoseconds last_handoff{0};   ///< Interactive-thread time of the last snapshot
+    std::chrono::nanoseconds last_write{0};     ///< Worker time of the last save
+    size_t last_bytes = 0;                      ///< Size of the last file written
+    std::optional<JsonError> last_error;        ///< Error of the last save, if it failed
+};
+
+/**
+ * @class TaskAutosave
+ * @brief Keeps a JSON file up to date from a background thread
+ * @details poll() and saveNow() must be called from the thread that owns the
+ *          TaskManager; the manager is only read during those calls.
+ */
+class TaskAutosave {
+private:
+    /**
+     * @brief Copy of one changed segment, owned by the snapshot
+     */
+    struct SegmentCopy {
+        size_t index = 0;
+        std::vector<Task> tasks;
+    };
+
+    /**
+     * @brief What the worker needs for one save
+     */
+    struct Snapshot {
+        int next_id = 1;
+        size_t segment_count = 0;
+        std::uint64_t epoch = 0;
+        std::vector<SegmentCopy> changed;
+    };
+
+    AutosaveOptions _options;
+
+    // Interactive thread only
+    std::vector<std::uint64_t> _handed_epochs;      ///< Segment epochs as of the last handoff
+    std::uint64_t _handed_epoch = 0;                ///< Change epoch of the last handoff
+    std::chrono::steady_clock::time_point _last_handoff_time = std::chrono::steady_clock::now();
+    std::vector<const Task*> _segment_tasks;        ///< Reused by handOff
+
+    // Shared, guarded by _mutex
+    mutable std::mutex _mutex;
+    std::condition_variable _wake;                  ///< Signals the worker: a snapshot or stop
+    std::condition_variable _idle;                  ///< Signals waiters: the worker went idle
+    std::optional<Snapshot> _pending;
+    bool _writing = false;
+    bool _retry = false;                            ///< The last save failed; write again even without changes
+    bool _stop = false;
+    AutosaveStatus _status;
+
+    // Worker only
+    std::vector<std::string> _formatted;            ///< Tasks array fragment per segment
+
+    std::thread _worker;                            ///< Declared last: started after, joined before the rest
+
+    /**
+     * @brief Copy the changed segments and hand them to the worker
+     * @details Caller holds no lock; the worker must be idle
+     */
+    void handOff(const TaskManager& manager);
+
+    /**
+     * @brief Worker loop
+     */
+    void run();
+
+    /**
+     * @brief Apply a snapshot to the formatted segments and write the document
+     * @param snapshot Snapshot to write
+     * @param bytes Receives the size of the file written
+     */
+    JsonResult write(Snapshot& snapshot, size_t& bytes);
+
+public:
+    /**
+     * @brief Start the worker thread
+     * @param options Target file and schedule
+     */
+    explicit TaskAutosave(AutosaveOptions options);
+
+    TaskAutosave(const TaskAutosave&) = delete;
+    TaskAutosave& operator=(const TaskAutosave&) = delete;
+
+    /**
+     * @brief Finish the save in progress, if any, and stop the worker
+     * @details A handed-off snapshot is always written; call saveNow() first
+     *          to include changes made since
+     */
+    ~TaskAutosave();
+
+    /**
+     * @brief Hand off a snapshot if one is due and the worker is idle
+     * @details Due when the changes since the last handoff reach the change
+     *          threshold, or there are changes and the interval has passed.
+     *          Nothing is saved between polls, however long the interval.
+     *          While the worker is busy nothing is copied; the next poll retries.
+     * @param manager Tasks to save
+     * @return true if a snapshot was handed off
+     */
+    bool poll(const TaskManager& manager);
+
+    /**
+     * @brief Hand off a snapshot of any unsaved changes, waiting for a running save first
+     * @param manager Tasks to save
+     * @return true if a snapshot was handed off, false if everything was saved
+     */
+    bool saveNow(const TaskManager& manager);
+
+    /**
+     * @brief Block until the worker is idle
+     */
+    void wait();
+
+    /**
+     * @brief Current progress of the worker
+     */
+    AutosaveStatus status() const;
+
+    /**
+     * @brief File being kept up to date
+     */
+    const std::string& path() const { return _options.path; }
+};
+
+#endif // TASK_AUTOSAVE_H
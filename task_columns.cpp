@@ -0,0 +1,54 @@
+/**
+ * @file task_columns.cpp
+ * @brief Implementation of TaskColumns
+ */
+
+#include "task_columns.h"
+#include "task_snapshot.h"
+
+void TaskColumns::reserve(size_t count) {
+    id.reserve(count);
+    status.reserve(count);
+    priority.reserve(count);
+    category.reserve(count);
+    created_at.reserve(count);
+    updated_at.reserve(count);
+}
+
+void TaskColumns::push(const Task& task) {
+    const auto& metadata = task.getMetadata();
+    id.push_back(task.getId());
+    status.push_back(static_cast<std::uint8_t>(task.getStatus()));
+    priority.push_back(static_cast<std::uint8_t>(metadata.priority));
+    category.push_back(metadata.category.id());
+    created_at.push_back(timePointToTicks(metadata.created_at));
+    updated_at.push_back(timePointToTicks(metadata.updated_at));
+}
+
+void TaskColumns::assign(size_t slot, const Task& task) {
+    const auto& metadata = task.getMetadata();
+    id[slot] = task.getId();
+    status[slot] = static_cast<std::uint8_t>(task.getStatus());
+    priority[slot] = static_cast<std::uint8_t>(metadata.priority);
+    category[slot] = metadata.category.id();
+    created_at[slot] = timePointToTicks(metadata.created_at);
+    updated_at[slot] = timePointToTicks(metadata.updated_at);
+}
+
+void TaskColumns::erase(size_t slot) {
+    id.erase(id.begin() + slot);
+    status.erase(status.begin() + slot);
+    priority.erase(priority.begin() + slot);
+    category.erase(category.begin() + slot);
+    created_at.erase(created_at.begin() + slot);
+    updated_at.erase(updated_at.begin() + slot);
+}
+
+void TaskColumns::clear() {
+    id.clear();
+    status.clear();
+    priority.clear();
+    category.clear();
+    created_at.clear();
+    updated_at.clear();
+}
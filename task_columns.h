@@ -0,0 +1,67 @@
+#ifndef TASK_COLUMNS_H
+#define TASK_COLUMNS_H
+
+/**
+ * @file task_columns.h
+ * @brief Structure-of-arrays copy of the hot Task fields
+ * @details Scans over status, priority, category or timestamps touch a few bytes
+ *          per task in contiguous arrays instead of pulling whole Task objects
+ *          (three strings plus metadata) through the cache. Titles and
+ *          descriptions stay in the Task objects, which act as the cold store.
+ */
+
+#include "task.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class TaskColumns
+ * @brief Parallel arrays of hot task fields, indexed by TaskManager slot
+ * @details Kept in the same order as TaskManager's task vector, so slot i of
+ *          every column describes the task at slot i
+ */
+class TaskColumns {
+public:
+    std::vector<int> id;                    ///< Task ID
+    std::vector<std::uint8_t> status;       ///< TaskStatus value
+    std::vector<std::uint8_t> priority;     ///< Priority 0-10
+    std::vector<std::uint32_t> category;    ///< InternedString::id() of the category
+    std::vector<std::int64_t> created_at;   ///< Nanoseconds since epoch
+    std::vector<std::int64_t> updated_at;   ///< Nanoseconds since epoch
+
+    /**
+     * @brief Number of rows
+     */
+    size_t size() const { return id.size(); }
+
+    /**
+     * @brief Reserve room for a number of rows in every column
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Append a row for a task
+     * @param task Task to copy the hot fields from
+     */
+    void push(const Task& task);
+
+    /**
+     * @brief Overwrite the row of a task after it changed
+     * @param slot Row index
+     * @param task Task to copy the hot fields from
+     */
+    void assign(size_t slot, const Task& task);
+
+    /**
+     * @brief Remove a row, shifting the rows behind it like std::vector::erase
+     * @param slot Row index
+     */
+    void erase(size_t slot);
+
+    /**
+     * @brief Remove all rows
+     */
+    void clear();
+};
+
+#endif // TASK_COLUMNS_H
@@ -0,0 +1,347 @@
+/**
+ * @file task_journal.cpp
+ * @brief Implementation of the write-ahead journal
+ */
+
+#include "task_journal.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TASKTRACKER_HAS_FSYNC 1
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#define TASKTRACKER_HAS_FSYNC 0
+#endif
+
+namespace {
+
+/**
+ * @brief Size of the fixed part of a record body (op, id, when, value, two lengths)
+ */
+constexpr size_t RECORD_FIXED_BODY = 1 + 4 + 8 + 4 + 4 + 4;
+
+std::uint32_t fnv1a(std::string_view data) {
+    std::uint32_t hash = 2166136261u;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template<typename T>
+void put(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template<typename T>
+T get(std::string_view data, size_t& pos) {
+    T value;
+    std::memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+bool getString(std::string_view body, size_t& pos, std::string& out) {
+    if (pos + 4 > body.size()) return false;
+    auto length = get<std::uint32_t>(body, pos);
+    if (length > body.size() - pos) return false;
+    out.assign(body.substr(pos, length));
+    pos += length;
+    return true;
+}
+
+/**
+ * @brief Append the body of a record: [op][id][when][value][text][extra]
+ */
+void appendBody(std::string& out, const JournalRecord& record) {
+    put<std::uint8_t>(out, static_cast<std::uint8_t>(record.op));
+    put<std::int32_t>(out, record.id);
+    put<std::int64_t>(out, record.when);
+    put<std::int32_t>(out, record.value);
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(record.text.size()));
+    out += record.text;
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(record.extra.size()));
+    out += record.extra;
+}
+
+/**
+ * @brief Decode a record body written by appendBody
+ * @return false if the body is truncated
+ */
+bool decodeBody(std::string_view body, JournalRecord& record) {
+    if (body.size() < RECORD_FIXED_BODY) return false;
+    size_t field = 0;
+    record.op = static_cast<JournalOp>(get<std::uint8_t>(body, field));
+    record.id = get<std::int32_t>(body, field);
+    record.when = get<std::int64_t>(body, field);
+    record.value = get<std::int32_t>(body, field);
+    return getString(body, field, record.text) && getString(body, field, record.extra);
+}
+
+bool syncDescriptor([[maybe_unused]] std::FILE* file) {
+#if TASKTRACKER_HAS_FSYNC
+    return ::fsync(::fileno(file)) == 0;
+#else
+    return true;
+#endif
+}
+
+} // namespace
+
+std::string_view fsyncPolicyToString(FsyncPolicy policy) {
+    switch (policy) {
+        case FsyncPolicy::Always: return "always";
+        case FsyncPolicy::Batch: return "batch";
+        case FsyncPolicy::Never: return "never";
+        default: return "unknown";
+    }
+}
+
+std::optional<FsyncPolicy> stringToFsyncPolicy(std::string_view str) {
+    if (str == "always") return FsyncPolicy::Always;
+    if (str == "batch") return FsyncPolicy::Batch;
+    if (str == "never") return FsyncPolicy::Never;
+    return std::nullopt;
+}
+
+std::expected<size_t, JsonError> readJournal(std::string_view data, std::vector<JournalRecord>& records) {
+    std::string_view magic(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    if (data.size() < magic.size()) {
+        // A crash while creating the file can leave a partial header
+        if (magic.starts_with(data)) return 0uz;
+        return std::unexpected(JsonError::InvalidFormat);
+    }
+    if (!data.starts_with(magic)) {
+        return std::unexpected(JsonError::InvalidFormat);
+    }
+
+    size_t pos = magic.size();
+    while (pos + 4 <= data.size()) {
+        size_t cursor = pos;
+        auto length = get<std::uint32_t>(data, cursor);
+        if (length < RECORD_FIXED_BODY || length + 4uz > data.size() - cursor) break;
+
+        std::string_view body = data.substr(cursor, length);
+        cursor += length;
+        if (get<std::uint32_t>(data, cursor) != fnv1a(body)) break;
+
+        JournalRecord record;
+        if (!decodeBody(body, record)) break;
+
+        records.push_back(std::move(record));
+        pos = cursor;
+    }
+    return pos;
+}
+
+JournalRecord encodeJournalBatch(std::span<const JournalRecord> records, std::int64_t when) {
+    JournalRecord batch{
+        .op = JournalOp::Batch,
+        .when = when,
+        .value = static_cast<int>(records.size())
+    };
+    std::string body;
+    for (const auto& record : records) {
+        body.clear();
+        appendBody(body, record);
+        put<std::uint32_t>(batch.text, static_cast<std::uint32_t>(body.size()));
+        batch.text += body;
+    }
+    return batch;
+}
+
+bool decodeJournalBatch(const JournalRecord& batch, std::vector<JournalRecord>& records) {
+    if (batch.op != JournalOp::Batch || batch.value < 0) return false;
+
+    std::vector<JournalRecord> decoded;
+    std::string_view data = batch.text;
+    size_t pos = 0;
+    while (pos < data.size()) {
+        if (pos + 4 > data.size()) return false;
+        auto length = get<std::uint32_t>(data, pos);
+        if (length > data.size() - pos) return false;
+
+        JournalRecord& record = decoded.emplace_back();
+        if (!decodeBody(data.substr(pos, length), record) || record.op == JournalOp::Batch) return false;
+        pos += length;
+    }
+    if (decoded.size() != static_cast<size_t>(batch.value)) return false;
+
+    std::ranges::move(decoded, std::back_inserter(records));
+    return true;
+}
+
+JsonResult syncFileToDisk([[maybe_unused]] const std::string& filename) {
+#if TASKTRACKER_HAS_FSYNC
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::unexpected(JsonError::WriteError);
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    if (!synced) {
+        return std::unexpected(JsonError::WriteError);
+    }
+#endif
+    return true;
+}
+
+TaskJournal::~TaskJournal() {
+    close();
+}
+
+TaskJournal::TaskJournal(TaskJournal&& other) noexcept
+    : _path(std::move(other._path)),
+      _file(std::exchange(other._file, nullptr)),
+      _options(other._options),
+      _unsynced(std::exchange(other._unsynced, 0)),
+      _record_count(std::exchange(other._record_count, 0)),
+      _size(std::exchange(other._size, 0)),
+      _buffer(std::move(other._buffer)),
+      _recovered(std::move(other._recovered)),
+      _error(std::exchange(other._error, std::nullopt)) {}
+
+TaskJournal& TaskJournal::operator=(TaskJournal&& other) noexcept {
+    if (this != &other) {
+        close();
+        _path = std::move(other._path);
+        _file = std::exchange(other._file, nullptr);
+        _options = other._options;
+        _unsynced = std::exchange(other._unsynced, 0);
+        _record_count = std::exchange(other._record_count, 0);
+        _size = std::exchange(other._size, 0);
+        _buffer = std::move(other._buffer);
+        _recovered = std::move(other._recovered);
+        _error = std::exchange(other._error, std::nullopt);
+    }
+    return *this;
+}
+
+void TaskJournal::close() noexcept {
+    if (!_file) return;
+    if (_unsynced > 0 && _options.fsync != FsyncPolicy::Never) {
+        syncDescriptor(_file);
+    }
+    std::fclose(_file);
+    _file = nullptr;
+    _unsynced = 0;
+}
+
+std::expected<TaskJournal, JsonError> TaskJournal::open(const std::string& path, JournalOptions options) {
+    TaskJournal journal;
+    journal._path = path;
+    journal._options = options;
+
+    size_t valid = 0;
+    size_t file_size = 0;
+    {
+        auto existing = MappedFile::open(path);
+        if (existing) {
+            file_size = existing->size();
+            auto intact = readJournal(existing->view(), journal._recovered);
+            if (!intact) {
+                return std::unexpected(intact.error());
+            }
+            valid = *intact;
+        } else if (existing.error() != JsonError::FileNotFound) {
+            return std::unexpected(existing.error());
+        }
+    }
+
+    // Cut off a torn tail so the next record follows the last intact one
+    if (valid < file_size) {
+        std::error_code ec;
+        std::filesystem::resize_file(path, valid, ec);
+        if (ec) {
+            return std::unexpected(JsonError::WriteError);
+        }
+    }
+
+    journal._file = std::fopen(path.c_str(), "ab");
+    if (!journal._file) {
+        return std::unexpected(JsonError::FileNotFound);
+    }
+
+    if (valid == 0) {
+        if (std::fwrite(JOURNAL_MAGIC, 1, sizeof(JOURNAL_MAGIC), journal._file) != sizeof(JOURNAL_MAGIC) ||
+            std::fflush(journal._file) != 0) {
+            return std::unexpected(JsonError::WriteError);
+        }
+        valid = sizeof(JOURNAL_MAGIC);
+    }
+
+    journal._size = valid;
+    journal._record_count = journal._recovered.size();
+    return journal;
+}
+
+JsonResult TaskJournal::append(const JournalRecord& record) {
+    if (!_file) {
+        return std::unexpected(JsonError::WriteError);
+    }
+
+    // Frame the record in one buffer so it reaches the OS in a single write
+    _buffer.clear();
+    put<std::uint32_t>(_buffer, 0);
+    appendBody(_buffer, record);
+
+    auto body_length = static_cast<std::uint32_t>(_buffer.size() - 4);
+    std::memcpy(_buffer.data(), &body_length, sizeof(body_length));
+    put<std::uint32_t>(_buffer, fnv1a(std::string_view(_buffer).substr(4)));
+
+    if (std::fwrite(_buffer.data(), 1, _buffer.size(), _file) != _buffer.size() ||
+        std::fflush(_file) != 0) {
+        if (!_error) _error = JsonError::WriteError;
+        return std::unexpected(JsonError::WriteError);
+    }
+    _size += _buffer.size();
+    ++_record_count;
+    ++_unsynced;
+
+    bool due = _options.fsync == FsyncPolicy::Always ||
+               (_options.fsync == FsyncPolicy::Batch && _unsynced >= std::max(_options.batch_size, 1uz));
+    if (due) {
+        return sync();
+    }
+    return true;
+}
+
+JsonResult TaskJournal::sync() {
+    if (!_file) {
+        return std::unexpected(JsonError::WriteError);
+    }
+    if (std::fflush(_file) != 0 || !syncDescriptor(_file)) {
+        if (!_error) _error = JsonError::WriteError;
+        return std::unexpected(JsonError::WriteError);
+    }
+    _unsynced = 0;
+    return true;
+}
+
+JsonResult TaskJournal::reset() {
+    if (_file) {
+        std::fclose(_file);
+        _file = nullptr;
+    }
+    _unsynced = 0;
+    _record_count = 0;
+    _size = 0;
+
+    _file = std::fopen(_path.c_str(), "wb");
+    if (!_file) {
+        return std::unexpected(JsonError::WriteError);
+    }
+    if (std::fwrite(JOURNAL_MAGIC, 1, sizeof(JOURNAL_MAGIC), _file) != sizeof(JOURNAL_MAGIC)) {
+        return std::unexpected(JsonError::WriteError);
+    }
+    _size = sizeof(JOURNAL_MAGIC);
+    return sync();
+}
@@ -0,0 +1,221 @@
+#ifndef TASK_JOURNAL_H
+#define TASK_JOURNAL_H
+
+/**
+ * @file task_journal.h
+ * @brief Append-only write-ahead journal of TaskManager mutations
+ * @details Each mutation is appended as one small framed record instead of
+ *          rewriting the whole task file. On startup the journal is replayed on
+ *          top of the last binary snapshot; compaction folds it into a new
+ *          snapshot and truncates it.
+ *
+ *          File layout: JOURNAL_MAGIC, then records of the form
+ *          [u32 body_length][body][u32 checksum], where the body is
+ *          [u8 op][i32 id][i64 when][i32 value][u32 len][text][u32 len][extra]
+ *          and the checksum is FNV-1a over the body. A torn or corrupt tail
+ *          (e.g. after a crash mid-write) ends replay and is cut off on open.
+ *          A Batch record carries several records in its text payload as
+ *          [u32 body_length][body] entries, so a batch is replayed all or nothing.
+ */
+
+#include "task.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <optional>
+#include <expected>
+#include <utility>
+
+/**
+ * @brief Magic bytes at the start of every journal file (includes the format version)
+ */
+inline constexpr char JOURNAL_MAGIC[8] = {'T', 'T', 'W', 'A', 'L', '\0', '\0', '1'};
+
+/**
+ * @enum JournalOp
+ * @brief Kind of mutation stored in a journal record
+ */
+enum class JournalOp : std::uint8_t {
+    AddTask = 1,    ///< text = title, extra = description
+    RemoveTask,     ///< no payload
+    SetStatus,      ///< value = TaskStatus
+    SetPriority,    ///< value = priority
+    SetCategory,    ///< text = category
+    SetTitle,       ///< text = title
+    SetDescription, ///< text = description
+    Batch           ///< value = record count, text = encoded records (see encodeJournalBatch)
+};
+
+/**
+ * @struct JournalRecord
+ * @brief One decoded journal entry
+ */
+struct JournalRecord {
+    JournalOp op = JournalOp::AddTask;  ///< Mutation kind
+    int id = 0;                         ///< Task ID the mutation applies to
+    std::int64_t when = 0;              ///< Mutation time, nanoseconds since epoch
+    int value = 0;                      ///< Integer payload (status, priority)
+    std::string text;                   ///< String payload (title, category, description)
+    std::string extra;                  ///< Second string payload (description)
+};
+
+/**
+ * @enum FsyncPolicy
+ * @brief When appended records are forced to stable storage
+ */
+enum class FsyncPolicy {
+    Always,     ///< fsync after every record
+    Batch,      ///< fsync every JournalOptions::batch_size records and on close
+    Never       ///< Leave flushing to the OS page cache
+};
+
+/**
+ * @brief Convert a fsync policy to its command-line name
+ */
+std::string_view fsyncPolicyToString(FsyncPolicy policy);
+
+/**
+ * @brief Parse a fsync policy from its command-line name (always, batch, never)
+ */
+std::optional<FsyncPolicy> stringToFsyncPolicy(std::string_view str);
+
+/**
+ * @struct JournalOptions
+ * @brief Tunables for a TaskJournal
+ */
+struct JournalOptions {
+    FsyncPolicy fsync = FsyncPolicy::Batch; ///< Durability policy
+    size_t batch_size = 32;                 ///< Records per fsync with FsyncPolicy::Batch
+};
+
+/**
+ * @brief Decode all intact records of a journal
+ * @param data Complete journal contents
+ * @param records Receives the decoded records
+ * @return Number of bytes covered by intact records (including the magic),
+ *         or InvalidFormat if the data is not a journal
+ */
+std::expected<size_t, JsonError> readJournal(std::string_view data, std::vector<JournalRecord>& records);
+
+/**
+ * @brief Pack several records into one Batch record
+ * @param records Records of the batch, in order (must not be batches themselves)
+ * @param when Timestamp of the batch record
+ * @return Batch record
+ */
+JournalRecord encodeJournalBatch(std::span<const JournalRecord> records, std::int64_t when);
+
+/**
+ * @brief Unpack the records of a Batch record
+ * @param batch Record with op Batch
+ * @param records Receives the contained records
+ * @return false if the payload is malformed (nothing is appended then)
+ */
+bool decodeJournalBatch(const JournalRecord& batch, std::vector<JournalRecord>& records);
+
+/**
+ * @brief Force a file that was written through a stream to stable storage
+ * @param filename Path of the file to sync
+ * @return Success, or WriteError if the file cannot be synced
+ */
+JsonResult syncFileToDisk(const std::string& filename);
+
+/**
+ * @class TaskJournal
+ * @brief Move-only appender for a journal file
+ */
+class TaskJournal {
+private:
+    std::string _path;                      ///< Journal file path
+    std::FILE* _file = nullptr;             ///< Open file, positioned at the end
+    JournalOptions _options;                ///< Durability settings
+    size_t _unsynced = 0;                   ///< Records appended since the last fsync
+    size_t _record_count = 0;               ///< Records in the file
+    size_t _size = 0;                       ///< File size in bytes
+    std::string _buffer;                    ///< Reused encoding buffer
+    std::vector<JournalRecord> _recovered;  ///< Records found when the file was opened
+    std::optional<JsonError> _error;        ///< First unreported append failure
+
+    TaskJournal() = default;
+
+    /**
+     * @brief Close the file after syncing pending records
+     */
+    void close() noexcept;
+
+public:
+    ~TaskJournal();
+
+    TaskJournal(const TaskJournal&) = delete;
+    TaskJournal& operator=(const TaskJournal&) = delete;
+
+    TaskJournal(TaskJournal&& other) noexcept;
+    TaskJournal& operator=(TaskJournal&& other) noexcept;
+
+    /**
+     * @brief Open (or create) a journal for appending
+     * @details Existing records are decoded and kept for takeRecoveredRecords();
+     *          a torn tail is truncated so new records follow the last intact one.
+     * @param path Journal file path
+     * @param options Durability settings
+     * @return Journal, FileNotFound if it cannot be opened, InvalidFormat if the
+     *         file exists but is not a journal
+     */
+    static std::expected<TaskJournal, JsonError> open(const std::string& path, JournalOptions options = {});
+
+    /**
+     * @brief Hand over the records that were in the file when it was opened
+     */
+    std::vector<JournalRecord> takeRecoveredRecords() { return std::move(_recovered); }
+
+    /**
+     * @brief Append one record, syncing according to the fsync policy
+     * @param record Record to append
+     * @return Success or WriteError
+     */
+    JsonResult append(const JournalRecord& record);
+
+    /**
+     * @brief Force all appended records to stable storage
+     * @return Success or WriteError
+     */
+    JsonResult sync();
+
+    /**
+     * @brief Drop all records after they were folded into a snapshot
+     * @return Success or WriteError
+     */
+    JsonResult reset();
+
+    /**
+     * @brief Take the first append failure since the last call, if any
+     * @details Mutations are applied in memory even if journaling them fails,
+     *          so callers poll this to warn the user
+     */
+    std::optional<JsonError> takeError() { return std::exchange(_error, std::nullopt); }
+
+    /**
+     * @brief Path of the journal file
+     */
+    const std::string& path() const { return _path; }
+    
+    /**
+     * @brief Durability settings in effect
+     */
+    const JournalOptions& options() const { return _options; }
+    
+    /**
+     * @brief Number of records since the last compaction
+     */
+    size_t recordCount() const { return _record_count; }
+    
+    /**
+     * @brief Current size of the journal file in bytes
+     */
+    size_t sizeBytes() const { return _size; }
+};
+
+#endif // TASK_JOURNAL_H
@@ -0,0 +1,777 @@
+/**
+ * @file task_json.cpp
+ * @brief Implementation of the task JSON reader and writer
+ * @details Every byte of the input is visited once; strings are decoded directly
+ *          into caller-owned buffers and numbers are parsed with std::from_chars.
+ *          Output is formatted in place with std::format_to.
+ */
+
+#include "task_json.h"
+#include "parallel.h"
+#include "timestamp.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <format>
+#include <iterator>
+
+namespace {
+
+/**
+ * @brief Maximum nesting depth accepted when skipping unknown values
+ */
+constexpr int MAX_SKIP_DEPTH = 64;
+
+/**
+ * @brief Smallest number of task objects worth decoding on a separate thread
+ */
+constexpr size_t MIN_PARSE_CHUNK = 1024;
+
+/**
+ * @brief Tasks formatted per thread in each parallel serialization batch
+ * @details Bounds the per-thread buffers for stream-backed writers
+ */
+constexpr size_t WRITE_CHUNK_TASKS = 4096;
+
+/**
+ * @brief Append a Unicode code point to a string as UTF-8
+ * @param out Destination string
+ * @param cp Code point to encode
+ */
+void appendUtf8(std::string& out, std::uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+/**
+ * @brief Decode four hex digits
+ * @param digits View starting at the first digit
+ * @return Decoded value, or nullopt if fewer than four hex digits are present
+ */
+std::optional<std::uint32_t> parseHex4(std::string_view digits) {
+    if (digits.size() < 4) return std::nullopt;
+    std::uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        char c = digits[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= static_cast<std::uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') value |= static_cast<std::uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') value |= static_cast<std::uint32_t>(c - 'A' + 10);
+        else return std::nullopt;
+    }
+    return value;
+}
+
+} // namespace
+
+void TaskRecord::clear() {
+    id.reset();
+    title.clear();
+    description.clear();
+    status.clear();
+    category.clear();
+    priority.reset();
+    created_at.clear();
+    updated_at.clear();
+    completed_at.clear();
+}
+
+std::expected<Task, JsonError> TaskRecord::toTask() const {
+    if (!id || title.empty()) {
+        return std::unexpected(JsonError::InvalidFormat);
+    }
+
+    auto status_opt = stringToTaskStatus(status);
+    if (!status_opt) {
+        return std::unexpected(JsonError::InvalidFormat);
+    }
+
+    Task task(*id, title, description, *status_opt);
+    auto& metadata = task.getMetadata();
+
+    if (!category.empty()) {
+        metadata.category = category;
+    }
+
+    // Out-of-range priorities are ignored, matching Task::setPriority
+    if (priority && *priority >= 0 && *priority <= 10) {
+        metadata.priority = *priority;
+    }
+
+    // Missing or malformed timestamps keep the constructor's value, like priorities
+    if (auto time = parseIsoTimestamp(created_at)) {
+        metadata.created_at = *time;
+    }
+
+    if (auto time = parseIsoTimestamp(updated_at)) {
+        metadata.updated_at = *time;
+    }
+
+    if (auto time = parseIsoTimestamp(completed_at)) {
+        metadata.completed_at = *time;
+    }
+
+    return task;
+}
+
+void TaskJsonReader::skipWhitespace() {
+    while (_pos < _input.size()) {
+        char c = _input[_pos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+        ++_pos;
+    }
+}
+
+bool TaskJsonReader::consume(char c) {
+    skipWhitespace();
+    if (_pos < _input.size() && _input[_pos] == c) {
+        ++_pos;
+        return true;
+    }
+    return false;
+}
+
+JsonParseResult TaskJsonReader::expect(char c) {
+    if (!consume(c)) {
+        return fail(JsonError::InvalidFormat);
+    }
+    return true;
+}
+
+JsonParseResult TaskJsonReader::parseString(std::string& out) {
+    out.clear();
+    if (auto result = expect('"'); !result) return result;
+
+    while (true) {
+        // Copy the longest run without quotes or escapes in one append
+        size_t run_start = _pos;
+        while (_pos < _input.size() && _input[_pos] != '"' && _input[_pos] != '\\') {
+            ++_pos;
+        }
+        out.append(_input.substr(run_start, _pos - run_start));
+
+        if (_pos >= _input.size()) {
+            return fail(JsonError::InvalidFormat); // Unterminated string
+        }
+
+        if (_input[_pos] == '"') {
+            ++_pos;
+            return true;
+        }
+
+        if (_pos + 1 >= _input.size()) {
+            return fail(JsonError::InvalidFormat);
+        }
+
+        char escaped = _input[_pos + 1];
+        _pos += 2;
+        switch (escaped) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                auto cp = parseHex4(_input.substr(_pos));
+                if (!cp) return fail(JsonError::InvalidFormat);
+                _pos += 4;
+
+                // Combine UTF-16 surrogate pairs
+                if (*cp >= 0xD800 && *cp <= 0xDBFF &&
+                    _input.substr(_pos, 2) == "\\u") {
+                    auto low = parseHex4(_input.substr(_pos + 2));
+                    if (low && *low >= 0xDC00 && *low <= 0xDFFF) {
+                        *cp = 0x10000 + ((*cp - 0xD800) << 10) + (*low - 0xDC00);
+                        _pos += 6;
+                    }
+                }
+                appendUtf8(out, *cp);
+                break;
+            }
+            default:
+                // Unknown escape: keep it verbatim like unescapeJsonString does
+                out += '\\';
+                out += escaped;
+                break;
+        }
+    }
+}
+
+JsonParseResult TaskJsonReader::parseInt(int& out) {
+    skipWhitespace();
+    const char* first = _input.data() + _pos;
+    const char* last = _input.data() + _input.size();
+
+    auto [ptr, ec] = std::from_chars(first, last, out);
+    if (ec != std::errc{}) {
+        return fail(JsonError::ParseError);
+    }
+
+    _pos += static_cast<size_t>(ptr - first);
+
+    // Fractions and exponents are not valid for integer fields
+    if (_pos < _input.size() &&
+        (_input[_pos] == '.' || _input[_pos] == 'e' || _input[_pos] == 'E')) {
+        return fail(JsonError::ParseError);
+    }
+    return true;
+}
+
+JsonParseResult TaskJsonReader::skipString() {
+    if (auto result = expect('"'); !result) return result;
+
+    while (_pos < _input.size()) {
+        char c = _input[_pos++];
+        if (c == '"') return true;
+        if (c == '\\') ++_pos;
+    }
+    return fail(JsonError::InvalidFormat);
+}
+
+JsonParseResult TaskJsonReader::skipValue(int depth) {
+    if (depth > MAX_SKIP_DEPTH) {
+        return fail(JsonError::InvalidFormat);
+    }
+
+    skipWhitespace();
+    if (_pos >= _input.size()) {
+        return fail(JsonError::InvalidFormat);
+    }
+
+    char c = _input[_pos];
+    if (c == '"') {
+        return skipString();
+    }
+
+    if (c == '{' || c == '[') {
+        const char close = c == '{' ? '}' : ']';
+        ++_pos;
+        if (consume(close)) return true;
+
+        do {
+            if (close == '}') {
+                if (auto result = skipString(); !result) return result;
+                if (auto result = expect(':'); !result) return result;
+            }
+            if (auto result = skipValue(depth + 1); !result) return result;
+        } while (consume(','));
+
+        return expect(close);
+    }
+
+    for (std::string_view literal : {"true", "false", "null"}) {
+        if (_input.substr(_pos, literal.size()) == literal) {
+            _pos += literal.size();
+            return true;
+        }
+    }
+
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        while (_pos < _input.size()) {
+            c = _input[_pos];
+            if (!(c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' || (c >= '0' && c <= '9'))) {
+                break;
+            }
+            ++_pos;
+        }
+        return true;
+    }
+
+    return fail(JsonError::InvalidFormat);
+}
+
+JsonParseResult TaskJsonReader::parseTaskObject(TaskRecord& record) {
+    record.clear();
+    if (auto result = expect('{'); !result) return result;
+    if (consume('}')) return true;
+
+    // String fields accept null as "absent"
+    auto readText = [this](std::string& out) -> JsonParseResult {
+        skipWhitespace();
+        if (_input.substr(_pos, 4) == "null") {
+            _pos += 4;
+            out.clear();
+            return true;
+        }
+        return parseString(out);
+    };
+
+    do {
+        if (auto result = parseString(_key); !result) return result;
+        if (auto result = expect(':'); !result) return result;
+
+        JsonParseResult result = true;
+        if (_key == "id") {
+            int value = 0;
+            result = parseInt(value);
+            if (result) record.id = value;
+        } else if (_key == "priority") {
+            int value = 0;
+            result = parseInt(value);
+            if (result) record.priority = value;
+        } else if (_key == "title") {
+            result = readText(record.title);
+        } else if (_key == "description") {
+            result = readText(record.description);
+        } else if (_key == "status") {
+            result = readText(record.status);
+        } else if (_key == "category") {
+            result = readText(record.category);
+        } else if (_key == "created_at") {
+            result = readText(record.created_at);
+        } else if (_key == "updated_at") {
+            result = readText(record.updated_at);
+        } else if (_key == "completed_at") {
+            result = readText(record.completed_at);
+        } else {
+            result = skipValue();
+        }
+
+        if (!result) return result;
+    } while (consume(','));
+
+    return expect('}');
+}
+
+JsonParseResult TaskJsonReader::readTopLevelMembers() {
+    do {
+        if (auto result = parseString(_key); !result) return result;
+        if (auto result = expect(':'); !result) return result;
+
+        if (_key == "tasks" && _state == State::Start) {
+            if (auto result = expect('['); !result) return result;
+            _state = State::InTasks;
+            _first_element = true;
+            return true;
+        }
+
+        JsonParseResult result = true;
+        skipWhitespace();
+        if (_key == "version" && _pos < _input.size() && _input[_pos] == '"') {
+            result = parseString(_info.version);
+        } else if (_key == "next_id") {
+            int value = 0;
+            result = parseInt(value);
+            if (result) _info.next_id = value;
+        } else {
+            result = skipValue();
+        }
+
+        if (!result) return result;
+    } while (consume(','));
+
+    if (auto result = expect('}'); !result) return result;
+
+    if (_state == State::Start) {
+        return fail(JsonError::InvalidFormat); // Document has no tasks array
+    }
+
+    _state = State::Done;
+    return true;
+}
+
+JsonParseResult TaskJsonReader::begin() {
+    if (_state != State::Start) {
+        return fail(JsonError::InvalidFormat);
+    }
+
+    if (auto result = expect('{'); !result) return result;
+    if (consume('}')) {
+        return fail(JsonError::InvalidFormat);
+    }
+
+    return readTopLevelMembers();
+}
+
+JsonParseResult TaskJsonReader::next(TaskRecord& record) {
+    if (_state != State::InTasks) {
+        return fail(JsonError::InvalidFormat);
+    }
+
+    if (consume(']')) {
+        _state = State::AfterTasks;
+        return false;
+    }
+
+    if (!_first_element) {
+        if (auto result = expect(','); !result) return result;
+    }
+    _first_element = false;
+
+    if (auto result = parseTaskObject(record); !result) return result;
+    return true;
+}
+
+JsonParseResult TaskJsonReader::skipNext(size_t& begin) {
+    if (_state != State::InTasks) {
+        return fail(JsonError::InvalidFormat);
+    }
+
+    if (consume(']')) {
+        _state = State::AfterTasks;
+        return false;
+    }
+
+    if (!_first_element) {
+        if (auto result = expect(','); !result) return result;
+    }
+    _first_element = false;
+
+    skipWhitespace();
+    if (_pos >= _input.size() || _input[_pos] != '{') {
+        return fail(JsonError::InvalidFormat);
+    }
+    begin = _pos;
+    if (auto result = skipValue(); !result) return result;
+    return true;
+}
+
+JsonParseResult TaskJsonReader::finish() {
+    if (_state != State::AfterTasks) {
+        return fail(JsonError::InvalidFormat);
+    }
+
+    if (consume(',')) {
+        if (auto result = readTopLevelMembers(); !result) return result;
+    } else {
+        if (auto result = expect('}'); !result) return result;
+        _state = State::Done;
+    }
+
+    skipWhitespace();
+    if (_pos != _input.size()) {
+        return fail(JsonError::InvalidFormat); // Trailing data after the document
+    }
+    return true;
+}
+
+JsonParseResult TaskJsonReader::readObject(TaskRecord& record) {
+    if (auto result = parseTaskObject(record); !result) return result;
+
+    skipWhitespace();
+    if (_pos != _input.size()) {
+        return fail(JsonError::InvalidFormat);
+    }
+    return true;
+}
+
+namespace {
+
+/**
+ * @brief Parallel body of parseTaskDocument, after begin() succeeded
+ */
+std::expected<TaskDocumentInfo, JsonParseFailure> parseTaskDocumentParallel(std::string_view input,
+                                                                            TaskJsonReader& reader,
+                                                                            std::vector<Task>& tasks,
+                                                                            unsigned workers) {
+    struct Span {
+        size_t offset;  // Reader offset before the element, reported for invalid tasks
+        size_t begin;   // Opening brace
+        size_t end;     // One past the closing brace
+    };
+
+    // Structural pass: object boundaries only, nothing is decoded
+    std::vector<Span> spans;
+    std::optional<JsonParseFailure> structural_failure;
+    while (true) {
+        size_t object_offset = reader.offset();
+        size_t begin = 0;
+        auto result = reader.skipNext(begin);
+        if (!result) {
+            structural_failure = result.error();
+            break;
+        }
+        if (!*result) break;
+        spans.push_back({object_offset, begin, reader.offset()});
+    }
+    if (!structural_failure) {
+        if (auto result = reader.finish(); !result) {
+            structural_failure = result.error();
+        }
+    }
+
+    const size_t chunks = parallel::chunkCount(spans.size(), workers, MIN_PARSE_CHUNK);
+    std::vector<std::vector<Task>> decoded(chunks);
+    std::vector<std::optional<JsonParseFailure>> failures(chunks);
+
+    parallel::forEachChunk(spans.size(), workers, MIN_PARSE_CHUNK, [&](size_t chunk, size_t first, size_t last) {
+        auto& out = decoded[chunk];
+        out.reserve(last - first);
+        TaskRecord record;
+        for (size_t i = first; i < last; ++i) {
+            const Span& span = spans[i];
+            TaskJsonReader object_reader(input.substr(span.begin, span.end - span.begin));
+            if (auto result = object_reader.readObject(record); !result) {
+                failures[chunk] = JsonParseFailure{result.error().error, span.begin + result.error().offset};
+                return;
+            }
+            auto task = record.toTask();
+            if (!task) {
+                failures[chunk] = JsonParseFailure{task.error(), span.offset};
+                return;
+            }
+            out.push_back(std::move(*task));
+        }
+    });
+
+    // Report what the sequential parser would: the earliest failure in the document
+    for (const auto& failure : failures) {
+        if (failure) return std::unexpected(*failure);
+    }
+    if (structural_failure) {
+        return std::unexpected(*structural_failure);
+    }
+
+    tasks.reserve(tasks.size() + spans.size());
+    for (auto& chunk : decoded) {
+        std::ranges::move(chunk, std::back_inserter(tasks));
+    }
+    return reader.info();
+}
+
+} // namespace
+
+std::expected<TaskDocumentInfo, JsonParseFailure> parseTaskDocument(std::string_view input,
+                                                                    std::vector<Task>& tasks,
+                                                                    unsigned workers) {
+    TaskJsonReader reader(input);
+    if (auto result = reader.begin(); !result) {
+        return std::unexpected(result.error());
+    }
+
+    if (workers > 1) {
+        return parseTaskDocumentParallel(input, reader, tasks, workers);
+    }
+
+    TaskRecord record;
+    while (true) {
+        size_t object_offset = reader.offset();
+        auto result = reader.next(record);
+        if (!result) return std::unexpected(result.error());
+        if (!*result) break;
+
+        auto task = record.toTask();
+        if (!task) {
+            return std::unexpected(JsonParseFailure{task.error(), object_offset});
+        }
+        tasks.push_back(std::move(*task));
+    }
+
+    if (auto result = reader.finish(); !result) {
+        return std::unexpected(result.error());
+    }
+    return reader.info();
+}
+
+void appendJsonEscaped(std::string& out, std::string_view str) {
+    size_t run_start = 0;
+    for (size_t i = 0; i < str.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        // UTF-8 and printable ASCII (other than quote/backslash) pass through unchanged
+        if (c >= 32 && c != '"' && c != '\\') continue;
+
+        out.append(str.substr(run_start, i - run_start));
+        run_start = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                std::format_to(std::back_inserter(out), "\\u{:04x}", c);
+                break;
+        }
+    }
+    out.append(str.substr(run_start));
+}
+
+TaskJsonWriter::TaskJsonWriter(std::ostream& sink, size_t flush_threshold)
+    : _sink(&sink), _flush_threshold(flush_threshold) {
+    _buffer.reserve(flush_threshold + flush_threshold / 4);
+}
+
+void TaskJsonWriter::newline() {
+    _buffer += '\n';
+    _buffer.append(static_cast<size_t>(_depth) * 2, ' ');
+}
+
+void TaskJsonWriter::maybeFlush() {
+    if (_sink && _buffer.size() >= _flush_threshold) {
+        flush();
+    }
+}
+
+bool TaskJsonWriter::flush() {
+    if (!_sink) return true;
+
+    if (!_buffer.empty() && !_failed) {
+        _sink->write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+        _failed = _sink->fail();
+    }
+    _buffer.clear(); // Keeps capacity for the next chunk
+    return !_failed;
+}
+
+void TaskJsonWriter::writeTask(const Task& task) {
+    auto out = std::back_inserter(_buffer);
+    const auto& metadata = task.getMetadata();
+
+    _buffer += '{';
+    ++_depth;
+
+    newline();
+    std::format_to(out, "\"id\": {},", task.getId());
+
+    newline();
+    _buffer += "\"title\": \"";
+    appendJsonEscaped(_buffer, task.getTitle());
+    _buffer += "\",";
+
+    newline();
+    _buffer += "\"description\": \"";
+    appendJsonEscaped(_buffer, task.getDescription());
+    _buffer += "\",";
+
+    newline();
+    std::format_to(out, "\"status\": \"{}\",", taskStatusToString(task.getStatus()));
+
+    newline();
+    _buffer += "\"category\": \"";
+    appendJsonEscaped(_buffer, metadata.category.view());
+    _buffer += "\",";
+
+    newline();
+    std::format_to(out, "\"priority\": {},", metadata.priority);
+
+    newline();
+    _buffer += "\"created_at\": \"";
+    appendIsoTimestamp(_buffer, metadata.created_at);
+    _buffer += "\",";
+
+    newline();
+    _buffer += "\"updated_at\": \"";
+    appendIsoTimestamp(_buffer, metadata.updated_at);
+    _buffer += '"';
+
+    if (metadata.completed_at.has_value()) {
+        _buffer += ',';
+        newline();
+        _buffer += "\"completed_at\": \"";
+        appendIsoTimestamp(_buffer, *metadata.completed_at);
+        _buffer += '"';
+    }
+
+    --_depth;
+    newline();
+    _buffer += '}';
+}
+
+void TaskJsonWriter::beginDocument(int next_id) {
+    auto out = std::back_inserter(_buffer);
+    _tasks_in_document = 0;
+
+    _buffer += '{';
+    ++_depth;
+    newline();
+    _buffer += "\"version\": \"1.0\",";
+    newline();
+    std::format_to(out, "\"next_id\": {},", next_id);
+    newline();
+    _buffer += "\"tasks\": [";
+    ++_depth;
+}
+
+void TaskJsonWriter::writeDocumentTask(const Task& task) {
+    if (_tasks_in_document > 0) {
+        _buffer += ',';
+    }
+    newline();
+    writeTask(task);
+    ++_tasks_in_document;
+    maybeFlush();
+}
+
+void TaskJsonWriter::writeDocumentTasks(std::span<const Task> tasks, unsigned workers) {
+    if (workers <= 1 || tasks.size() < 2 * WRITE_CHUNK_TASKS) {
+        for (const auto& task : tasks) {
+            writeDocumentTask(task);
+        }
+        return;
+    }
+
+    _chunks.resize(workers);
+    const size_t batch = static_cast<size_t>(workers) * WRITE_CHUNK_TASKS;
+    for (size_t start = 0; start < tasks.size(); start += batch) {
+        auto slice = tasks.subspan(start, std::min(batch, tasks.size() - start));
+        const size_t chunks = parallel::chunkCount(slice.size(), workers, WRITE_CHUNK_TASKS);
+        std::vector<size_t> counts(chunks);
+
+        parallel::forEachChunk(slice.size(), workers, WRITE_CHUNK_TASKS, [&](size_t chunk, size_t first, size_t last) {
+            // A detached in-memory writer at the same depth; its first task has no comma
+            TaskJsonWriter part;
+            part._buffer = std::move(_chunks[chunk]);
+            part._buffer.clear();
+            part._depth = _depth;
+            for (size_t i = first; i < last; ++i) {
+                part.writeDocumentTask(slice[i]);
+            }
+            _chunks[chunk] = part.take();
+            counts[chunk] = last - first;
+        });
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            if (_tasks_in_document > 0) {
+                _buffer += ',';
+            }
+            _buffer += _chunks[chunk];
+            _tasks_in_document += counts[chunk];
+        }
+        maybeFlush();
+    }
+}
+
+void TaskJsonWriter::beginFragment() {
+    _buffer.clear();
+    _depth = 2;  // Inside the document object and its tasks array
+    _tasks_in_document = 0;
+}
+
+void TaskJsonWriter::appendDocumentFragment(std::string_view fragment) {
+    if (fragment.empty()) {
+        return;
+    }
+    if (_tasks_in_document > 0) {
+        _buffer += ',';
+    }
+    _buffer += fragment;
+    ++_tasks_in_document;
+    maybeFlush();
+}
+
+void TaskJsonWriter::endDocument() {
+    --_depth;
+    newline();
+    _buffer += ']';
+    --_depth;
+    newline();
+    _buffer += '}';
+}
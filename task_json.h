@@ -0,0 +1,307 @@
+#ifndef TASK_JSON_H
+#define TASK_JSON_H
+
+/**
+ * @file task_json.h
+ * @brief Single-pass JSON reader and direct-to-buffer writer for task documents
+ * @details The reader walks a std::string_view once, decoding fields straight into
+ *          reusable buffers instead of copying each object out with substr. The
+ *          writer formats into one growing buffer that is flushed to a stream in
+ *          large chunks.
+ */
+
+#include "task.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <expected>
+#include <ostream>
+#include <span>
+
+/**
+ * @struct JsonParseFailure
+ * @brief Detailed parse error with the byte offset where parsing stopped
+ */
+struct JsonParseFailure {
+    JsonError error;    ///< Error category
+    size_t offset;      ///< Byte offset into the input
+};
+
+/**
+ * @typedef JsonParseResult
+ * @brief Result type for reader steps: true/false for "got an element", or a failure
+ */
+using JsonParseResult = std::expected<bool, JsonParseFailure>;
+
+/**
+ * @struct TaskRecord
+ * @brief Decoded fields of one task object
+ * @details Reused between objects so its strings keep their capacity and a
+ *          large file is decoded without per-field allocations
+ */
+struct TaskRecord {
+    std::optional<int> id;      ///< Task identifier if present
+    std::string title;          ///< Unescaped title
+    std::string description;    ///< Unescaped description
+    std::string status;         ///< Status name as written in the file
+    std::string category;       ///< Unescaped category
+    std::optional<int> priority; ///< Priority if present
+    std::string created_at;     ///< Raw created_at timestamp
+    std::string updated_at;     ///< Raw updated_at timestamp
+    std::string completed_at;   ///< Raw completed_at timestamp (empty if absent)
+
+    /**
+     * @brief Reset all fields while keeping string capacity
+     */
+    void clear();
+
+    /**
+     * @brief Build a Task from the decoded fields
+     * @return Task object, or JsonError if required fields are missing/invalid
+     */
+    std::expected<Task, JsonError> toTask() const;
+};
+
+/**
+ * @struct TaskDocumentInfo
+ * @brief Top-level members of a task document other than the tasks array
+ */
+struct TaskDocumentInfo {
+    std::string version;            ///< Document version, empty if absent
+    std::optional<int> next_id;     ///< Next task ID, if present
+};
+
+/**
+ * @class TaskJsonReader
+ * @brief Pull-style reader over a task document
+ * @details Usage: begin() positions the reader on the tasks array, next() yields
+ *          one TaskRecord per call until it returns false, and finish() checks
+ *          the remainder of the document. Object keys may appear in any order and
+ *          unknown keys are skipped.
+ */
+class TaskJsonReader {
+private:
+    /**
+     * @enum State
+     * @brief Position of the reader within the document
+     */
+    enum class State {
+        Start,          ///< Nothing consumed yet
+        InTasks,        ///< Inside the tasks array
+        AfterTasks,     ///< Tasks array fully consumed
+        Done            ///< Top-level object closed
+    };
+
+    std::string_view _input;    ///< Document being parsed
+    size_t _pos = 0;            ///< Current byte offset
+    State _state = State::Start; ///< Reader position
+    bool _first_element = true; ///< No array element consumed yet
+    TaskDocumentInfo _info;     ///< Top-level metadata collected so far
+    std::string _key;           ///< Reused buffer for object keys
+
+    std::unexpected<JsonParseFailure> fail(JsonError error) const {
+        return std::unexpected(JsonParseFailure{error, _pos});
+    }
+
+    void skipWhitespace();
+    bool consume(char c);
+    JsonParseResult expect(char c);
+    JsonParseResult parseString(std::string& out);
+    JsonParseResult parseInt(int& out);
+    JsonParseResult skipString();
+    JsonParseResult skipValue(int depth = 0);
+    JsonParseResult parseTaskObject(TaskRecord& record);
+    JsonParseResult readTopLevelMembers();
+
+public:
+    /**
+     * @brief Construct a reader over a document
+     * @param input JSON text; must outlive the reader
+     */
+    explicit TaskJsonReader(std::string_view input) : _input(input) {}
+
+    /**
+     * @brief Parse the top-level object up to the start of the tasks array
+     * @return true on success, or failure if no tasks array was found
+     */
+    JsonParseResult begin();
+
+    /**
+     * @brief Decode the next task object of the tasks array
+     * @param record Receives the decoded fields
+     * @return true if a record was read, false at the end of the array
+     */
+    JsonParseResult next(TaskRecord& record);
+
+    /**
+     * @brief Skip over the next task object of the tasks array without decoding it
+     * @details Used by the parallel parser to find object boundaries; the object
+     *          is then decoded separately with readObject
+     * @param begin Receives the offset of the object's opening brace
+     * @return true if an object was skipped (it ends at offset()), false at the end of the array
+     */
+    JsonParseResult skipNext(size_t& begin);
+
+    /**
+     * @brief Consume the members after the tasks array and check for trailing data
+     * @return true on success
+     */
+    JsonParseResult finish();
+
+    /**
+     * @brief Decode a standalone task object (as produced by Task::toJson)
+     * @param record Receives the decoded fields
+     * @return true on success
+     */
+    JsonParseResult readObject(TaskRecord& record);
+
+    /**
+     * @brief Top-level metadata seen so far
+     * @details next_id is only known after finish() if it follows the tasks array
+     */
+    const TaskDocumentInfo& info() const { return _info; }
+
+    /**
+     * @brief Current byte offset into the input
+     */
+    size_t offset() const { return _pos; }
+};
+
+/**
+ * @brief Parse a complete task document into a vector of tasks
+ * @details With more than one worker, a structural pass first records where each
+ *          task object starts and ends; chunks of objects are then decoded on
+ *          separate threads and appended in document order. The result, including
+ *          which failure is reported, is the same as with one worker.
+ * @param input JSON text
+ * @param tasks Receives the tasks in document order
+ * @param workers Number of threads to decode with (1 = sequential)
+ * @return Document metadata, or the failure with its byte offset
+ */
+std::expected<TaskDocumentInfo, JsonParseFailure> parseTaskDocument(std::string_view input,
+                                                                    std::vector<Task>& tasks,
+                                                                    unsigned workers = 1);
+
+/**
+ * @brief Append a string to a buffer with JSON escaping
+ * @details Runs of characters that need no escaping are appended in one call
+ * @param out Destination buffer
+ * @param str Text to escape
+ */
+void appendJsonEscaped(std::string& out, std::string_view str);
+
+/**
+ * @class TaskJsonWriter
+ * @brief Formats task documents straight into a single output buffer
+ * @details Uses std::format_to with a back_inserter; indentation comes from a depth
+ *          counter instead of re-splitting nested output. When constructed with a
+ *          stream, the buffer is written out and reused whenever it grows past the
+ *          flush threshold, so memory stays bounded regardless of task count.
+ */
+class TaskJsonWriter {
+private:
+    std::string _buffer;                ///< Pending output
+    std::vector<std::string> _chunks;   ///< Per-thread buffers reused by writeDocumentTasks
+    std::ostream* _sink = nullptr;      ///< Destination stream, or nullptr to keep output in memory
+    size_t _flush_threshold = 0;        ///< Buffer size that triggers a flush to _sink
+    int _depth = 0;                     ///< Current indentation level (2 spaces per level)
+    size_t _tasks_in_document = 0;      ///< Tasks written since beginDocument()
+    bool _failed = false;               ///< A write to _sink failed
+
+    /**
+     * @brief Start a new line at the current depth
+     */
+    void newline();
+
+    /**
+     * @brief Flush to the sink if the buffer passed the threshold
+     */
+    void maybeFlush();
+
+public:
+    /**
+     * @brief Default flush threshold for stream-backed writers (1 MiB)
+     */
+    static constexpr size_t DEFAULT_FLUSH_THRESHOLD = 1uz << 20;
+
+    /**
+     * @brief Construct a writer that keeps everything in memory
+     */
+    TaskJsonWriter() = default;
+
+    /**
+     * @brief Construct a writer that streams to an output stream in chunks
+     * @param sink Destination stream
+     * @param flush_threshold Buffer size that triggers a write to the stream
+     */
+    explicit TaskJsonWriter(std::ostream& sink, size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD);
+
+    /**
+     * @brief Write a single task object at the current depth
+     * @param task Task to serialize
+     */
+    void writeTask(const Task& task);
+
+    /**
+     * @brief Write the document header up to the opening of the tasks array
+     * @param next_id Next task ID to record
+     */
+    void beginDocument(int next_id);
+
+    /**
+     * @brief Write one element of the tasks array
+     * @param task Task to serialize
+     */
+    void writeDocumentTask(const Task& task);
+
+    /**
+     * @brief Write several elements of the tasks array
+     * @details With more than one worker, batches of tasks are formatted into
+     *          per-thread buffers in parallel and appended in order; the output is
+     *          byte-identical to calling writeDocumentTask for each task
+     * @param tasks Tasks to serialize
+     * @param workers Number of threads to format with (1 = sequential)
+     */
+    void writeDocumentTasks(std::span<const Task> tasks, unsigned workers = 1);
+
+    /**
+     * @brief Close the tasks array and the document
+     */
+    void endDocument();
+
+    /**
+     * @brief Start a detached run of tasks array elements
+     * @details Tasks written with writeDocumentTask afterwards are formatted as
+     *          they would be inside a document, the first without a leading
+     *          comma; take() returns the run for appendDocumentFragment
+     */
+    void beginFragment();
+
+    /**
+     * @brief Append a run of elements produced by another writer's beginFragment()
+     * @details Adds the separating comma when elements precede it, so a document
+     *          assembled from fragments is byte-identical to one written task by task
+     * @param fragment Elements to append; an empty run adds nothing
+     */
+    void appendDocumentFragment(std::string_view fragment);
+
+    /**
+     * @brief Write any buffered output to the sink
+     * @return false if a write failed (always true for in-memory writers)
+     */
+    bool flush();
+
+    /**
+     * @brief Move the buffered output out of the writer
+     * @return Everything written since construction or the last flush
+     */
+    std::string take() { return std::move(_buffer); }
+
+    /**
+     * @brief Check whether all writes to the sink succeeded so far
+     */
+    bool ok() const { return !_failed; }
+};
+
+#endif // TASK_JSON_H
@@ -1,10 +1,19 @@
 #include "task_manager.h"
+#include "task_json.h"
+#include "mapped_file.h"
+#include "task_snapshot.h"
+#include "string_search.h"
+#include "perf_counters.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <format>
 #include <print>
+#include <filesystem>
+#include <numeric>
+#include <iterator>
+#include <unordered_map>
 
 TaskAddResult TaskManager::addTask(const std::string& title, const std::string& description) {
     if (title.empty()) {
@@ -12,157 +21,784 @@ TaskAddResult TaskManager::addTask(const std::string& title, const std::string&
     }
     
     // Check for duplicate titles
-    auto existing = std::ranges::find_if(_tasks, [&title](const Task& task) {
-        return task.getTitle() == title;
-    });
-    
-    if (existing != _tasks.end()) {
+    if (hasTitle(title)) {
         return std::unexpected(TaskError::DuplicateTask);
     }
     
     int new_id = _next_id++;
     _tasks.emplace_back(new_id, title, description);
+    indexSlot(new_id, _tasks.size() - 1);
+    _titles.insert(title);
+    _counters.add(_tasks.back());
+    _matrix.addTask(_tasks.back());
+    _text_index.add(new_id, title, description);
+    if (_columnar) {
+        _columns.push(_tasks.back());
+    }
+    invalidateSortOrders();
+    recordMutation(JournalOp::AddTask, _tasks.back());
     return new_id;  // C++23: Return the ID of the newly created task
 }
 
 TaskResult TaskManager::removeTask(int id) {
-    auto it = std::ranges::find_if(_tasks, [id](const Task& task) {
-        return task.getId() == id;
-    });
-    
-    if (it == _tasks.end()) {
+    size_t slot = slotOf(id);
+    if (slot == NO_SLOT) {
         return std::unexpected(TaskError::TaskNotFound);
     }
     
-    _tasks.erase(it);
+    recordMutation(JournalOp::RemoveTask, _tasks[slot]);
+    _counters.remove(_tasks[slot]);
+    _matrix.removeTask(_tasks[slot]);
+    _text_index.remove(id, _tasks[slot].getTitle(), _tasks[slot].getDescription());
+    if (_columnar) {
+        _columns.erase(slot);
+    }
+    if (auto title_it = _titles.find(_tasks[slot].getTitle()); title_it != _titles.end()) {
+        _titles.erase(title_it);
+    }
+    eraseSlot(slot);
+    invalidateSortOrders();
     return true;
 }
 
+void TaskManager::eraseSlot(size_t slot) {
+    // Erase keeps insertion order for listing/saving; only the tail slots shift
+    int id = _tasks[slot].getId();
+    _tasks.erase(_tasks.begin() + slot);
+    _slot_by_id[id] = NO_SLOT;
+    for (size_t i = slot; i < _tasks.size(); ++i) {
+        _slot_by_id[_tasks[i].getId()] = i;
+    }
+}
+
 TaskOptional TaskManager::getTask(int id) {
-    auto it = std::ranges::find_if(_tasks, [id](const Task& task) {
-        return task.getId() == id;
-    });
-    
-    if (it == _tasks.end()) {
+    const Task* task = findTask(id);
+    if (!task) {
         return std::unexpected(TaskError::TaskNotFound);
     }
     
-    return *it;
+    return *task;
 }
 
 TaskResult TaskManager::updateTaskStatus(int id, TaskStatus status) {
-    auto it = std::ranges::find_if(_tasks, [id](Task& task) {
-        return task.getId() == id;
+    Task* task = lookupTask(id);
+    if (!task) {
+        return std::unexpected(TaskError::TaskNotFound);
+    }
+    
+    _counters.remove(*task);
+    auto result = task->setStatus(status);
+    _counters.add(*task);
+    if (result) {
+        refreshColumns(*task);
+        recordMutation(JournalOp::SetStatus, *task);
+    }
+    return result;
+}
+
+TaskResult TaskManager::updateTaskTitle(int id, const std::string& title) {
+    Task* task = lookupTask(id);
+    if (!task) {
+        return std::unexpected(TaskError::TaskNotFound);
+    }
+    
+    if (task->getTitle() == title) {
+        return true;
+    }
+    
+    if (hasTitle(title)) {
+        return std::unexpected(TaskError::DuplicateTask);
+    }
+    
+    // Take the old title out by node so its storage is reused for the new one
+    _text_index.remove(id, task->getTitle(), task->getDescription());
+    auto node = _titles.extract(task->getTitle());
+    auto result = task->setTitle(title);
+    _text_index.add(id, task->getTitle(), task->getDescription());
+    if (!result) {
+        if (!node.empty()) _titles.insert(std::move(node));
+        return result;
+    }
+    
+    if (node.empty()) {
+        _titles.insert(title);
+    } else {
+        node.value() = title;
+        _titles.insert(std::move(node));
+    }
+    refreshColumns(*task);
+    invalidateSortOrder(TaskSortKey::Title);
+    recordMutation(JournalOp::SetTitle, *task);
+    return true;
+}
+
+TaskResult TaskManager::updateTaskDescription(int id, const std::string& description) {
+    Task* task = lookupTask(id);
+    if (!task) {
+        return std::unexpected(TaskError::TaskNotFound);
+    }
+    
+    _text_index.remove(id, task->getTitle(), task->getDescription());
+    auto result = task->setDescription(description);
+    _text_index.add(id, task->getTitle(), task->getDescription());
+    if (result) {
+        refreshColumns(*task);
+        recordMutation(JournalOp::SetDescription, *task);
+    }
+    return result;
+}
+
+std::vector<int> TaskManager::findTasks(std::string_view query) const {
+    std::vector<std::string> terms;
+    std::vector<std::string_view> scan_terms;
+    
+    for (auto word : query | std::views::split(' ')) {
+        std::string_view term(word.begin(), word.end());
+        if (term.empty()) continue;
+        
+        size_t before = terms.size();
+        TextIndex::tokenize(term, terms);
+        if (terms.size() == before) {
+            scan_terms.push_back(term);
+        }
+    }
+    
+    if (terms.empty() && scan_terms.empty()) {
+        return {};
+    }
+    
+    std::vector<int> ids;
+    if (!terms.empty()) {
+        ids = _text_index.search(terms);
+    } else {
+        ids.reserve(_tasks.size());
+        for (const auto& task : _tasks) {
+            ids.push_back(task.getId());
+        }
+        std::ranges::sort(ids);
+    }
+    
+    if (!scan_terms.empty()) {
+        std::erase_if(ids, [&](int id) {
+            const Task* task = findTask(id);
+            return !std::ranges::all_of(scan_terms, [task](std::string_view term) {
+                return containsIgnoreCase(task->getTitle(), term) || containsIgnoreCase(task->getDescription(), term);
+            });
+        });
+    }
+    return ids;
+}
+
+namespace {
+
+/**
+ * @brief Index ticks of an optional bound, open bounds mapped to the extremes
+ */
+std::int64_t boundTicks(std::optional<std::chrono::system_clock::time_point> bound, std::int64_t open) {
+    return bound ? timePointToTicks(*bound) : open;
+}
+
+} // namespace
+
+std::vector<const Task*> TaskManager::getTasksInTimeRange(TaskTime time,
+                                                          std::optional<std::chrono::system_clock::time_point> from,
+                                                          std::optional<std::chrono::system_clock::time_point> to,
+                                                          size_t limit) const {
+    std::vector<const Task*> tasks;
+    if (limit == 0) {
+        return tasks;
+    }
+    _time_index.forEach(time, boundTicks(from, TimeIndex::MIN_TICKS), boundTicks(to, TimeIndex::MAX_TICKS),
+                        [&](const TimeIndex::Entry& entry) {
+        tasks.push_back(lookupTask(entry.id));
+        return tasks.size() < limit;
     });
+    return tasks;
+}
+
+size_t TaskManager::countTasksInTimeRange(TaskTime time,
+                                          std::optional<std::chrono::system_clock::time_point> from,
+                                          std::optional<std::chrono::system_clock::time_point> to) const {
+    return _time_index.count(time, boundTicks(from, TimeIndex::MIN_TICKS), boundTicks(to, TimeIndex::MAX_TICKS));
+}
+
+std::vector<size_t> TaskManager::countTasksPerDay(TaskTime time, std::chrono::system_clock::time_point first_day,
+                                                  size_t days) const {
+    std::vector<size_t> counts(days, 0);
+    constexpr std::int64_t DAY_TICKS = std::chrono::nanoseconds(std::chrono::days(1)).count();
+    const std::int64_t from = timePointToTicks(first_day);
+    const std::int64_t to = from + static_cast<std::int64_t>(days) * DAY_TICKS;
+    _time_index.forEach(time, from, to, [&](const TimeIndex::Entry& entry) {
+        ++counts[static_cast<size_t>((entry.ticks - from) / DAY_TICKS)];
+        return true;
+    });
+    return counts;
+}
+
+TaskResult TaskManager::updateTaskPriority(int id, int priority) {
+    Task* task = lookupTask(id);
+    if (!task) {
+        return std::unexpected(TaskError::TaskNotFound);
+    }
     
-    if (it == _tasks.end()) {
+    int old_priority = task->getMetadata().priority;
+    _counters.remove(*task);
+    auto result = task->setPriority(priority);
+    _counters.add(*task);
+    if (result) {
+        _matrix.moveTask(*task, task->getMetadata().category, old_priority);
+        refreshColumns(*task);
+        invalidatePrioritySortOrders();
+        recordMutation(JournalOp::SetPriority, *task);
+    }
+    return result;
+}
+
+TaskResult TaskManager::updateTaskCategory(int id, const std::string& category) {
+    Task* task = lookupTask(id);
+    if (!task) {
         return std::unexpected(TaskError::TaskNotFound);
     }
     
-    return it->setStatus(status);
+    InternedString old_category = task->getMetadata().category;
+    auto result = task->setCategory(category);
+    if (result) {
+        _matrix.moveTask(*task, old_category, task->getMetadata().priority);
+        refreshColumns(*task);
+        recordMutation(JournalOp::SetCategory, *task);
+    }
+    return result;
 }
 
-size_t TaskManager::getCompletedTasksCount() const {
-    return std::ranges::count_if(_tasks, [](const Task& task) {
-        return task.isCompleted();
+JournalRecord TaskManager::journalRecordFor(JournalOp op, const Task& task) {
+    JournalRecord record{
+        .op = op,
+        .id = task.getId(),
+        .when = timePointToTicks(task.getMetadata().updated_at)
+    };
+    switch (op) {
+        case JournalOp::AddTask:
+            record.text = task.getTitle();
+            record.extra = task.getDescription();
+            break;
+        case JournalOp::RemoveTask:
+            record.when = timePointToTicks(std::chrono::system_clock::now());
+            break;
+        case JournalOp::SetStatus:
+            record.value = static_cast<int>(task.getStatus());
+            break;
+        case JournalOp::SetPriority:
+            record.value = task.getMetadata().priority;
+            break;
+        case JournalOp::SetCategory:
+            record.text = task.getMetadata().category.str();
+            break;
+        case JournalOp::SetTitle:
+            record.text = task.getTitle();
+            break;
+        case JournalOp::SetDescription:
+            record.text = task.getDescription();
+            break;
+        case JournalOp::Batch:
+            break;
+    }
+    return record;
+}
+
+void TaskManager::recordMutation(JournalOp op, const Task& task) {
+    if (op == JournalOp::RemoveTask) {
+        _time_index.remove(task.getId());
+    } else {
+        _time_index.update(task);
+    }
+    touchSegment(task.getId());
+    if (!_journal) {
+        return;
+    }
+    
+    // The in-memory change stands either way; failures surface via TaskJournal::takeError()
+    _journal->append(journalRecordFor(op, task));
+}
+
+BatchResult TaskManager::applyBatch(std::span<const TaskUpdate> updates) {
+    BatchResult result;
+    const auto when = std::chrono::system_clock::now();
+    
+    // State of a task before its first update in the batch, for the index updates at the end
+    struct Touched {
+        size_t slot;
+        int priority;
+        InternedString category;
+        bool changed = false;       ///< At least one update succeeded
+        bool text_changed = false;
+        std::string title;
+        std::string description;
+    };
+    std::vector<Touched> touched;
+    std::unordered_map<size_t, size_t> touched_by_slot;
+    touched_by_slot.reserve(updates.size());
+    
+    std::vector<JournalRecord> records;
+    bool priority_changed = false;
+    bool title_changed = false;
+    
+    for (size_t i = 0; i < updates.size(); ++i) {
+        const TaskUpdate& update = updates[i];
+        size_t slot = slotOf(update.id);
+        if (slot == NO_SLOT) {
+            result.failures.emplace_back(i, TaskError::TaskNotFound);
+            continue;
+        }
+        
+        Task& task = _tasks[slot];
+        auto [entry, inserted] = touched_by_slot.try_emplace(slot, touched.size());
+        if (inserted) {
+            touched.push_back({slot, task.getMetadata().priority, task.getMetadata().category});
+            _counters.remove(task);
+        }
+        Touched& before = touched[entry->second];
+        auto saveText = [&] {
+            if (!before.text_changed) {
+                before.text_changed = true;
+                before.title = task.getTitle();
+                before.description = task.getDescription();
+            }
+        };
+        
+        TaskResult applied = true;
+        JournalOp op = JournalOp::SetStatus;
+        switch (update.field) {
+            case TaskUpdate::Field::Status:
+                if (update.value < 0 || update.value > static_cast<int>(TaskStatus::Cancelled)) {
+                    applied = std::unexpected(TaskError::InvalidStatus);
+                    break;
+                }
+                applied = task.setStatus(static_cast<TaskStatus>(update.value), when);
+                break;
+            case TaskUpdate::Field::Priority:
+                op = JournalOp::SetPriority;
+                applied = task.setPriority(update.value, when);
+                priority_changed = priority_changed || applied.has_value();
+                break;
+            case TaskUpdate::Field::Category:
+                op = JournalOp::SetCategory;
+                applied = task.setCategory(update.text, when);
+                break;
+            case TaskUpdate::Field::Title:
+                op = JournalOp::SetTitle;
+                if (update.text.empty()) {
+                    applied = std::unexpected(TaskError::EmptyTitle);
+                } else if (update.text != task.getTitle()) {
+                    if (hasTitle(update.text)) {
+                        applied = std::unexpected(TaskError::DuplicateTask);
+                        break;
+                    }
+                    saveText();
+                    auto node = _titles.extract(task.getTitle());
+                    applied = task.setTitle(update.text, when);
+                    if (node.empty()) {
+                        _titles.insert(update.text);
+                    } else {
+                        node.value() = update.text;
+                        _titles.insert(std::move(node));
+                    }
+                    title_changed = true;
+                }
+                break;
+            case TaskUpdate::Field::Description:
+                op = JournalOp::SetDescription;
+                saveText();
+                applied = task.setDescription(update.text, when);
+                break;
+        }
+        
+        if (!applied) {
+            result.failures.emplace_back(i, applied.error());
+            continue;
+        }
+        ++result.applied;
+        before.changed = true;
+        if (_journal) {
+            records.push_back(journalRecordFor(op, task));
+        }
+    }
+    
+    for (const Touched& before : touched) {
+        const Task& task = _tasks[before.slot];
+        _counters.add(task);
+        if (!before.changed) {
+            continue;  // Every update of this task failed: nothing to re-index or save
+        }
+        touchSegment(task.getId());
+        _time_index.update(task);
+        _matrix.moveTask(task, before.category, before.priority);
+        if (before.text_changed) {
+            _text_index.remove(task.getId(), before.title, before.description);
+            _text_index.add(task.getId(), task.getTitle(), task.getDescription());
+        }
+        refreshColumns(task);
+    }
+    if (priority_changed) invalidatePrioritySortOrders();
+    if (title_changed) invalidateSortOrder(TaskSortKey::Title);
+    
+    if (_journal && !records.empty()) {
+        _journal->append(encodeJournalBatch(records, timePointToTicks(when)));
+    }
+    return result;
+}
+
+bool TaskManager::applyJournalRecord(const JournalRecord& record) {
+    auto when = ticksToTimePoint(record.when);
+    
+    if (record.op == JournalOp::Batch) {
+        std::vector<JournalRecord> batch;
+        if (!decodeJournalBatch(record, batch)) {
+            return false;
+        }
+        bool changed = false;
+        for (const auto& inner : batch) {
+            changed = applyJournalRecord(inner) || changed;
+        }
+        return changed;
+    }
+    
+    if (record.op == JournalOp::AddTask) {
+        // Ids are never reused, so a smaller id is already in the loaded snapshot
+        if (record.id < _next_id || record.text.empty()) {
+            return false;
+        }
+        Task& task = _tasks.emplace_back(record.id, record.text, record.extra);
+        task.getMetadata().created_at = when;
+        task.getMetadata().updated_at = when;
+        _next_id = record.id + 1;
+        indexSlot(record.id, _tasks.size() - 1);
+        touchSegment(record.id);
+        return true;
+    }
+    
+    size_t slot = slotOf(record.id);
+    if (slot == NO_SLOT) {
+        return false;
+    }
+    
+    Task& task = _tasks[slot];
+    switch (record.op) {
+        case JournalOp::RemoveTask:
+            eraseSlot(slot);
+            touchSegment(record.id);
+            return true;
+        case JournalOp::SetStatus:
+            if (record.value < 0 || record.value > static_cast<int>(TaskStatus::Cancelled)) {
+                return false;
+            }
+            task.setStatus(static_cast<TaskStatus>(record.value), when);
+            break;
+        case JournalOp::SetPriority:
+            if (!task.setPriority(record.value)) {
+                return false;
+            }
+            break;
+        case JournalOp::SetCategory:
+            task.setCategory(record.text);
+            break;
+        case JournalOp::SetTitle:
+            if (!task.setTitle(record.text)) {
+                return false;
+            }
+            break;
+        case JournalOp::SetDescription:
+            task.setDescription(record.text);
+            break;
+        default:
+            return false;
+    }
+    task.getMetadata().updated_at = when;
+    touchSegment(record.id);
+    return true;
+}
+
+size_t TaskManager::replayJournal(std::span<const JournalRecord> records) {
+    // Replayed records are already in the journal; do not append them again
+    TaskJournal* journal = std::exchange(_journal, nullptr);
+    
+    size_t applied = 0;
+    for (const auto& record : records) {
+        if (applyJournalRecord(record)) {
+            ++applied;
+        }
+    }
+    
+    // Titles are only indexed for the final state; intermediate renames may overlap
+    rebuildIndexes();
+    _journal = journal;
+    return applied;
+}
+
+JsonResult TaskManager::compactJournal(const std::string& snapshot_path) {
+    std::string temp_path = snapshot_path + ".tmp";
+    if (auto result = saveToBinary(temp_path); !result) {
+        return result;
+    }
+    if (auto result = syncFileToDisk(temp_path); !result) {
+        return result;
+    }
+    
+    std::error_code ec;
+    std::filesystem::rename(temp_path, snapshot_path, ec);
+    if (ec) {
+        return std::unexpected(JsonError::WriteError);
+    }
+    
+    // Only now is it safe to drop the records the snapshot contains
+    if (_journal) {
+        return _journal->reset();
+    }
+    return true;
+}
+
+size_t TaskManager::slotOf(int id) const {
+    if (id <= 0 || static_cast<size_t>(id) >= _slot_by_id.size()) {
+        return NO_SLOT;
+    }
+    return _slot_by_id[id];
+}
+
+void TaskManager::indexSlot(int id, size_t slot) {
+    if (id <= 0) {
+        return;
+    }
+    if (static_cast<size_t>(id) >= _slot_by_id.size()) {
+        _slot_by_id.resize(static_cast<size_t>(id) + 1, NO_SLOT);
+    }
+    _slot_by_id[id] = slot;
+}
+
+JsonResult TaskManager::adoptTasks(std::vector<Task>&& tasks, int next_id) {
+    // Ids the id index cannot reach, or that leave no room for max_id + 1, fail the load
+    int max_id = 0;
+    for (const auto& task : tasks) {
+        if (task.getId() <= 0 || task.getId() == std::numeric_limits<int>::max()) {
+            return std::unexpected(JsonError::InvalidFormat);
+        }
+        max_id = std::max(max_id, task.getId());
+    }
+    
+    // The id index (and the time index and segments after it) is dense in ids: a file whose
+    // ids or next_id run far past its task count would allocate for every id in between
+    const size_t id_range = static_cast<size_t>(std::max({next_id, max_id + 1, 1}));
+    if (id_range > std::max(tasks.size() * MAX_IDS_PER_TASK, MIN_DENSE_IDS)) {
+        return std::unexpected(JsonError::InvalidFormat);
+    }
+    
+    // A repeated id would leave all but one copy unreachable through the id index
+    std::vector<bool> seen(id_range);
+    for (const auto& task : tasks) {
+        if (seen[static_cast<size_t>(task.getId())]) {
+            return std::unexpected(JsonError::InvalidFormat);
+        }
+        seen[static_cast<size_t>(task.getId())] = true;
+    }
+    
+    // Never hand out an id that is already used, even if next_id is stale
+    _next_id = std::max(next_id, max_id + 1);
+    _tasks = std::move(tasks);
+    rebuildIndexes();
+    
+    // Every segment changed; no segment directory describes the new tasks until one is saved or loaded
+    _segment_epochs.assign(getSegmentCount(), ++_change_epoch);
+    _saved_segment_epochs.clear();
+    _segment_directory.clear();
+    return true;
+}
+
+void TaskManager::rebuildIndexes() {
+    PerfScope perf(PerfProbe::RebuildIndexes);
+    _slot_by_id.assign(static_cast<size_t>(std::max(_next_id, 1)), NO_SLOT);
+    _titles.clear();
+    _titles.reserve(_tasks.size());
+    _counters = {};
+    _matrix.clear();
+    _text_index.clear();
+    for (size_t i = 0; i < _tasks.size(); ++i) {
+        indexSlot(_tasks[i].getId(), i);
+        _titles.insert(_tasks[i].getTitle());
+        _counters.add(_tasks[i]);
+        _matrix.addTask(_tasks[i]);
+        _text_index.add(_tasks[i].getId(), _tasks[i].getTitle(), _tasks[i].getDescription());
+    }
+    _time_index.rebuild(_tasks);
+    rebuildColumns();
+    invalidateSortOrders();
+}
+
+void TaskManager::rebuildColumns() {
+    _columns.clear();
+    if (!_columnar) {
+        return;
+    }
+    
+    _columns.reserve(_tasks.size());
+    for (const auto& task : _tasks) {
+        _columns.push(task);
+    }
+}
+
+void TaskManager::refreshColumns(const Task& task) {
+    if (!_columnar) {
+        return;
+    }
+    size_t slot = slotOf(task.getId());
+    _columns.assign(slot, task);
+}
+
+void TaskManager::setColumnarScans(bool enabled) {
+    if (_columnar == enabled) {
+        return;
+    }
+    _columnar = enabled;
+    rebuildColumns();
+    if (!enabled) {
+        _columns = {};
+    }
+}
+
+void TaskManager::prepareSortOrder(TaskSortKey key, size_t count) const {
+    SortOrder& order = _sort_orders[static_cast<size_t>(key)];
+    if (order.ready >= count) {
+        return;
+    }
+    
+    const size_t total = _tasks.size();
+    order.slots.resize(total);
+    std::iota(order.slots.begin(), order.slots.end(), 0uz);
+    
+    // A page near the front only needs its prefix ordered: O(n log k) instead of O(n log n)
+    const bool partial = count < total / 4;
+    const TaskRows rows{_tasks, _columnar ? &_columns : nullptr};
+    withSortOrder(key, [&]<typename Order>(Order) {
+        auto less = Order::slotOrder(rows);
+        if (partial) {
+            std::partial_sort(order.slots.begin(), order.slots.begin() + count, order.slots.end(), less);
+            return;
+        }
+        if constexpr (Order::packable) {
+            if (total >= RADIX_SORT_MIN && radixSortSlots<Order>(rows, order.slots)) {
+                return;
+            }
+        }
+        parallel::sort(order.slots.begin(), order.slots.end(), less, _workers);
     });
+    order.ready = partial ? count : total;
+}
+
+SortedPage TaskManager::getSortedPage(TaskSortKey key, size_t offset, size_t limit) const {
+    SortedPage page{.offset = offset, .total = _tasks.size()};
+    if (offset >= page.total || limit == 0) {
+        return page;
+    }
+    
+    size_t end = offset + std::min(limit, page.total - offset);
+    prepareSortOrder(key, end);
+    
+    const auto& slots = _sort_orders[static_cast<size_t>(key)].slots;
+    page.tasks.reserve(end - offset);
+    for (size_t i = offset; i < end; ++i) {
+        page.tasks.push_back(&_tasks[slots[i]]);
+    }
+    return page;
+}
+
+size_t TaskManager::getCompletedTasksCount() const {
+    return getTaskCountByStatus(TaskStatus::Completed);
 }
 
 size_t TaskManager::getPendingTasksCount() const {
-    return std::ranges::count_if(_tasks, [](const Task& task) {
-        return task.getStatus() == TaskStatus::Pending;
-    });
+    return getTaskCountByStatus(TaskStatus::Pending);
 }
 
 double TaskManager::getCompletionRate() const {
     if (_tasks.empty()) return 0.0;
-    return static_cast<double>(getCompletedTasksCount()) / _tasks.size() * 100.0;
+    return static_cast<double>(getTaskCountByStatus(TaskStatus::Completed)) / _tasks.size() * 100.0;
 }
 
 void TaskManager::listTasks() const {
+    std::string out;
+    listTasks(out);
+    std::print("{}", out);
+}
+
+void TaskManager::listTasks(std::string& out) const {
+    auto it = std::back_inserter(out);
     if (_tasks.empty()) {
-        std::print("No tasks available.\n");
+        out += "No tasks available.\n";
         return;
     }
     
-    std::print("=== Task List ({} tasks) ===\n", _tasks.size());
+    std::format_to(it, "=== Task List ({} tasks) ===\n", _tasks.size());
     for (const auto& task : _tasks) {
-        std::print("[{}] {} - {} (Priority: {}, Category: {})\n",
-                    task.getId(),
-                    task.getTitle(),
-                    taskStatusToString(task.getStatus()),
-                    task.getMetadata().priority,
-                    task.getMetadata().category);
+        std::format_to(it, "[{}] {} - {} (Priority: {}, Category: {})\n",
+                       task.getId(),
+                       task.getTitle(),
+                       taskStatusToString(task.getStatus()),
+                       task.getMetadata().priority,
+                       task.getMetadata().category);
     }
-    std::print("Completion Rate: {:.1f}%\n", getCompletionRate());
+    std::format_to(it, "Completion Rate: {:.1f}%\n", getCompletionRate());
 }
 
 void TaskManager::listTasksByStatus(TaskStatus status) const {
-    auto filtered_tasks = getTasksByStatus(status);
-    auto task_vector = std::vector<Task>(filtered_tasks.begin(), filtered_tasks.end());
-    
-    if (task_vector.empty()) {
-        std::print("No tasks with status: {}\n", taskStatusToString(status));
+    std::string out;
+    listTasksByStatus(status, out);
+    std::print("{}", out);
+}
+
+void TaskManager::listTasksByStatus(TaskStatus status, std::string& out) const {
+    auto it = std::back_inserter(out);
+    size_t count = getTaskCountByStatus(status);
+    if (count == 0) {
+        std::format_to(it, "No tasks with status: {}\n", taskStatusToString(status));
         return;
     }
     
-    std::print("=== {} Tasks ({} tasks) ===\n", 
-                taskStatusToString(status), task_vector.size());
-    
-    for (const auto& task : task_vector) {
-        std::print("[{}] {} (Priority: {}, Category: {})\n",
-                    task.getId(),
-                    task.getTitle(),
-                    taskStatusToString(task.getStatus()),
-                    task.getMetadata().priority,
-                    task.getMetadata().category);
+    std::format_to(it, "=== {} Tasks ({} tasks) ===\n", taskStatusToString(status), count);
+    for (const Task& task : getTasksByStatus(status)) {
+        std::format_to(it, "[{}] {} (Priority: {}, Category: {})\n",
+                       task.getId(),
+                       task.getTitle(),
+                       task.getMetadata().priority,
+                       task.getMetadata().category);
     }
 }
 
+void TaskManager::writeJson(TaskJsonWriter& writer) const {
+    writer.beginDocument(_next_id);
+    writer.writeDocumentTasks(_tasks, _workers);
+    writer.endDocument();
+}
+
 std::string TaskManager::toJsonString() const {
-    std::ostringstream json;
-    json << "{\n";
-    json << std::format("  \"version\": \"1.0\",\n");
-    json << std::format("  \"next_id\": {},\n", _next_id);
-    json << "  \"tasks\": [\n";
-    
-    for (size_t i = 0; i < _tasks.size(); ++i) {
-        std::string task_json = _tasks[i].toJson();
-        // Indent the task JSON
-        std::istringstream task_stream(task_json);
-        std::string line;
-        bool first_line = true;
-        while (std::getline(task_stream, line)) {
-            if (!first_line) json << "\n";
-            json << "    " << line;
-            first_line = false;
-        }
-        
-        if (i < _tasks.size() - 1) {
-            json << ",";
-        }
-        json << "\n";
-    }
-    
-    json << "  ]\n";
-    json << "}";
-    return json.str();
+    TaskJsonWriter writer;
+    writeJson(writer);
+    return writer.take();
 }
 
 JsonResult TaskManager::saveToJson(const std::string& filename) const {
+    PerfScope perf(PerfProbe::SaveJson);
     try {
-        std::ofstream file(filename);
+        std::ofstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             return std::unexpected(JsonError::FileNotFound);
         }
         
-        std::string json_content = toJsonString();
-        file << json_content;
+        // Stream in chunks: memory stays bounded by the writer's flush threshold
+        TaskJsonWriter writer(file);
+        writeJson(writer);
         
-        if (file.fail()) {
+        if (!writer.flush() || file.fail()) {
             return std::unexpected(JsonError::WriteError);
         }
         
+        perf.addBytes(static_cast<uint64_t>(file.tellp()));
         return true;
     } catch (const std::exception&) {
         return std::unexpected(JsonError::WriteError);
@@ -170,116 +806,205 @@ JsonResult TaskManager::saveToJson(const std::string& filename) const {
 }
 
 JsonResult TaskManager::loadFromJson(const std::string& filename) {
+    PerfScope perf(PerfProbe::LoadJson);
+    _last_json_error_offset.reset();
     try {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            return std::unexpected(JsonError::FileNotFound);
+        // Parse straight from the mapping; no std::string copy of the file
+        auto file = MappedFile::open(filename);
+        if (!file) {
+            return std::unexpected(file.error());
         }
         
-        std::ostringstream buffer;
-        buffer << file.rdbuf();
-        std::string json_content = buffer.str();
-        
-        return fromJsonString(json_content);
+        perf.addBytes(file->view().size());
+        return fromJsonString(file->view());
     } catch (const std::exception&) {
         return std::unexpected(JsonError::ParseError);
     }
 }
 
-JsonResult TaskManager::fromJsonString(const std::string& json_str) {
+JsonResult TaskManager::saveToBinary(const std::string& filename) const {
+    return writeTaskSnapshot(filename, _tasks, _next_id);
+}
+
+JsonResult TaskManager::loadFromBinary(const std::string& filename) {
+    _last_json_error_offset.reset();
     try {
-        // Simple JSON parsing - extract next_id and tasks array
-        auto findValue = [&json_str](const std::string& key) -> std::string {
-            std::string search_key = "\"" + key + "\":";
-            size_t pos = json_str.find(search_key);
-            if (pos == std::string::npos) return "";
-            
-            pos += search_key.length();
-            while (pos < json_str.length() && std::isspace(json_str[pos])) ++pos;
-            
-            if (pos >= json_str.length()) return "";
-            
-            if (json_str[pos] == '"') {
-                // String value
-                ++pos;
-                size_t end_pos = pos;
-                while (end_pos < json_str.length() && json_str[end_pos] != '"') {
-                    if (json_str[end_pos] == '\\') ++end_pos; // Skip escaped characters
-                    ++end_pos;
-                }
-                return json_str.substr(pos, end_pos - pos);
-            } else {
-                // Number or other value
-                size_t end_pos = pos;
-                while (end_pos < json_str.length() && 
-                       json_str[end_pos] != ',' && 
-                       json_str[end_pos] != '}' && 
-                       json_str[end_pos] != '\n' &&
-                       json_str[end_pos] != '\r') {
-                    ++end_pos;
-                }
-                std::string value = json_str.substr(pos, end_pos - pos);
-                // Trim whitespace
-                value.erase(0, value.find_first_not_of(" \t\n\r"));
-                value.erase(value.find_last_not_of(" \t\n\r") + 1);
-                return value;
-            }
-        };
-        
-        std::string next_id_str = findValue("next_id");
-        if (!next_id_str.empty()) {
-            _next_id = std::stoi(next_id_str);
+        auto file = MappedFile::open(filename);
+        if (!file) {
+            return std::unexpected(file.error());
         }
         
-        // Find tasks array
-        size_t tasks_pos = json_str.find("\"tasks\":");
-        if (tasks_pos == std::string::npos) {
-            return std::unexpected(JsonError::InvalidFormat);
+        std::vector<Task> loaded_tasks;
+        auto next_id = readTaskSnapshot(file->view(), loaded_tasks);
+        if (!next_id) {
+            return std::unexpected(next_id.error());
         }
         
-        size_t array_start = json_str.find("[", tasks_pos);
-        if (array_start == std::string::npos) {
-            return std::unexpected(JsonError::InvalidFormat);
+        return adoptTasks(std::move(loaded_tasks), *next_id);
+    } catch (const std::exception&) {
+        return std::unexpected(JsonError::ParseError);
+    }
+}
+
+std::expected<SegmentSaveStats, JsonError> TaskManager::saveToSegments(const std::string& directory) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        return std::unexpected(JsonError::FileNotFound);
+    }
+    
+    // The files the current manifest lists stay untouched until the new manifest replaces it
+    auto previous = readSegmentManifest(directory);
+    // Another directory, or a missing or foreign manifest, gets every segment
+    const bool full = directory != _segment_directory || !previous || previous->segment_size != SEGMENT_SIZE;
+    const size_t segment_count = getSegmentCount();
+    SegmentManifest manifest{.next_id = _next_id, .segment_size = SEGMENT_SIZE,
+                             .generation = previous ? previous->generation + 1 : 1};
+    SegmentSaveStats stats;
+    std::vector<const Task*> segment_tasks;
+    segment_tasks.reserve(SEGMENT_SIZE);
+    
+    size_t listed = 0;  // Next entry of the previous manifest
+    for (size_t segment = 0; segment < segment_count; ++segment) {
+        collectSegmentTasks(segment, segment_tasks);
+        const SegmentEntry* old = nullptr;
+        if (previous) {
+            while (listed < previous->segments.size() && previous->segments[listed].index < segment) {
+                ++listed;
+            }
+            if (listed < previous->segments.size() && previous->segments[listed].index == segment) {
+                old = &previous->segments[listed];
+            }
+        }
+        if (segment_tasks.empty()) {
+            continue;
         }
         
-        size_t array_end = json_str.find("]", array_start);
-        if (array_end == std::string::npos) {
-            return std::unexpected(JsonError::InvalidFormat);
+        if (!full && !segmentDirty(segment) && old && old->tasks == segment_tasks.size()) {
+            manifest.segments.push_back(*old);
+            continue;
+        }
+        if (auto result = writeSegmentFile(directory, segment, manifest.generation, segment_tasks, _next_id); !result) {
+            return std::unexpected(result.error());
+        }
+        manifest.segments.push_back({.index = segment, .tasks = segment_tasks.size(), .generation = manifest.generation});
+        ++stats.written;
+    }
+    stats.segments = manifest.segments.size();
+    
+    // Without writes every entry was kept from the previous manifest; the same count means nothing changed
+    if (full || stats.written > 0 || manifest.segments.size() != previous->segments.size()) {
+        if (auto result = writeSegmentManifest(directory, manifest); !result) {
+            return std::unexpected(result.error());
         }
         
-        // Parse individual task objects
-        _tasks.clear();
-        size_t pos = array_start + 1;
+        // Old files go only once the new manifest is durable: a crash before that may bring
+        // back the previous manifest, which still needs them
+        if (syncFileToDisk(directory)) {
+            std::unordered_set<std::string> keep;
+            keep.reserve(manifest.segments.size());
+            for (const SegmentEntry& entry : manifest.segments) {
+                keep.insert(segmentFileName(entry.index, entry.generation));
+            }
+            std::vector<fs::path> stale;
+            for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+                const std::string name = it->path().filename().string();
+                if (isSegmentFileName(name) && !keep.contains(name)) {
+                    stale.push_back(it->path());
+                }
+            }
+            for (const fs::path& path : stale) {
+                if (fs::remove(path, ec)) {
+                    ++stats.removed;
+                }
+            }
+        }
+    }
+    
+    _saved_segment_epochs = _segment_epochs;
+    _segment_directory = directory;
+    return stats;
+}
+
+void TaskManager::collectSegmentTasks(size_t segment, std::vector<const Task*>& tasks) const {
+    // The id index lists a segment's tasks in id order without touching the others
+    tasks.clear();
+    const size_t first_id = segment * SEGMENT_SIZE;
+    const size_t end_id = std::min(first_id + SEGMENT_SIZE, _slot_by_id.size());
+    for (size_t id = first_id; id < end_id; ++id) {
+        if (_slot_by_id[id] != NO_SLOT) {
+            tasks.push_back(&_tasks[_slot_by_id[id]]);
+        }
+    }
+}
+
+JsonResult TaskManager::loadFromSegments(const std::string& directory) {
+    PerfScope perf(PerfProbe::LoadJson);
+    _last_json_error_offset.reset();
+    try {
+        auto manifest = readSegmentManifest(directory);
+        if (!manifest) {
+            return std::unexpected(manifest.error());
+        }
         
-        while (pos < array_end) {
-            // Find next task object
-            size_t obj_start = json_str.find("{", pos);
-            if (obj_start >= array_end) break;
+        std::vector<Task> loaded_tasks;
+        for (const SegmentEntry& entry : manifest->segments) {
+            auto file = MappedFile::open((std::filesystem::path(directory) / segmentFileName(entry.index, entry.generation)).string());
+            if (!file) {
+                return std::unexpected(file.error());
+            }
+            perf.addBytes(file->view().size());
             
-            // Find matching closing brace
-            size_t obj_end = obj_start + 1;
-            int brace_count = 1;
-            while (obj_end < array_end && brace_count > 0) {
-                if (json_str[obj_end] == '{') ++brace_count;
-                else if (json_str[obj_end] == '}') --brace_count;
-                ++obj_end;
+            const size_t first = loaded_tasks.size();
+            loaded_tasks.reserve(first + entry.tasks);
+            if (auto info = parseTaskDocument(file->view(), loaded_tasks, _workers); !info) {
+                _last_json_error_offset = info.error().offset;
+                return std::unexpected(info.error().error);
             }
             
-            if (brace_count == 0) {
-                std::string task_json = json_str.substr(obj_start, obj_end - obj_start);
-                auto task_result = Task::fromJson(task_json);
-                if (task_result) {
-                    _tasks.push_back(*task_result);
-                } else {
-                    return std::unexpected(task_result.error());
+            // A segment from another save (one interrupted between its renames and the
+            // manifest) disagrees with the manifest on its count or its id range
+            if (loaded_tasks.size() - first != entry.tasks) {
+                return std::unexpected(JsonError::InvalidFormat);
+            }
+            const size_t first_id = entry.index * manifest->segment_size;
+            const size_t end_id = first_id + manifest->segment_size;
+            for (size_t i = first; i < loaded_tasks.size(); ++i) {
+                const int id = loaded_tasks[i].getId();
+                if (id < 0 || static_cast<size_t>(id) < first_id || static_cast<size_t>(id) >= end_id) {
+                    return std::unexpected(JsonError::InvalidFormat);
                 }
             }
-            
-            pos = obj_end;
         }
         
+        if (auto adopted = adoptTasks(std::move(loaded_tasks), manifest->next_id); !adopted) {
+            return adopted;
+        }
+        // Segments of another size cannot be patched in place; the next save rewrites them
+        if (manifest->segment_size == SEGMENT_SIZE) {
+            _saved_segment_epochs = _segment_epochs;
+            _segment_directory = directory;
+        }
         return true;
     } catch (const std::exception&) {
         return std::unexpected(JsonError::ParseError);
     }
 }
+
+JsonResult TaskManager::fromJsonString(std::string_view json_str) {
+    _last_json_error_offset.reset();
+    try {
+        // Parse into a local vector; the store is only replaced on success
+        std::vector<Task> loaded_tasks;
+        auto info = parseTaskDocument(json_str, loaded_tasks, _workers);
+        if (!info) {
+            _last_json_error_offset = info.error().offset;
+            return std::unexpected(info.error().error);
+        }
+        
+        return adoptTasks(std::move(loaded_tasks), info->next_id.value_or(_next_id));
+    } catch (const std::exception&) {
+        return std::unexpected(JsonError::ParseError);
+    }
+}
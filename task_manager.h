@@ -2,22 +2,342 @@
 #define TASK_MANAGER_H
 
 #include "task.h"
+#include "task_json.h"
+#include "task_journal.h"
+#include "task_matrix.h"
+#include "task_columns.h"
+#include "task_sort.h"
+#include "task_segments.h"
+#include "string_hash.h"
+#include "text_index.h"
+#include "time_index.h"
+#include "parallel.h"
 #include <vector>
 #include <ranges>
 #include <algorithm>
 #include <string>
 #include <expected>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <optional>
+#include <span>
+#include <array>
+#include <utility>
+
+/**
+ * @struct StatusCounters
+ * @brief Running task counts per status and per priority
+ * @details Maintained incrementally by TaskManager so statistics are O(1)
+ */
+struct StatusCounters {
+    static constexpr auto STATUS_COUNT = 4uz;      ///< Number of TaskStatus values
+    static constexpr auto PRIORITY_LEVELS = 11uz;  ///< Priorities 0-10
+    
+    std::array<size_t, STATUS_COUNT> by_status{};       ///< Count per TaskStatus
+    std::array<size_t, PRIORITY_LEVELS> by_priority{};  ///< Count per priority level
+    
+    /**
+     * @brief Count a task that joined the collection
+     */
+    void add(const Task& task) {
+        ++by_status[static_cast<size_t>(task.getStatus())];
+        ++by_priority[static_cast<size_t>(task.getMetadata().priority)];
+    }
+    
+    /**
+     * @brief Stop counting a task that left the collection
+     */
+    void remove(const Task& task) {
+        --by_status[static_cast<size_t>(task.getStatus())];
+        --by_priority[static_cast<size_t>(task.getMetadata().priority)];
+    }
+};
+
+/**
+ * @struct SortedPage
+ * @brief One page of a sorted view
+ * @details The pointers are invalidated by addTask, removeTask and loading
+ */
+struct SortedPage {
+    std::vector<const Task*> tasks;  ///< Tasks on the page, in order
+    size_t offset = 0;               ///< Position of the first task in the full order
+    size_t total = 0;                ///< Number of tasks in the full order
+};
+
+/**
+ * @struct TaskUpdate
+ * @brief One field change applied by TaskManager::applyBatch
+ */
+struct TaskUpdate {
+    /**
+     * @enum Field
+     * @brief Task field an update replaces
+     */
+    enum class Field { Status, Priority, Category, Title, Description };
+    
+    int id = 0;                     ///< Task to update
+    Field field = Field::Status;    ///< Field to replace
+    int value = 0;                  ///< New TaskStatus (as int) or priority
+    std::string text;               ///< New category, title or description
+    
+    static TaskUpdate status(int id, TaskStatus status) {
+        return {.id = id, .field = Field::Status, .value = static_cast<int>(status)};
+    }
+    static TaskUpdate priority(int id, int priority) {
+        return {.id = id, .field = Field::Priority, .value = priority};
+    }
+    static TaskUpdate category(int id, std::string category) {
+        return {.id = id, .field = Field::Category, .text = std::move(category)};
+    }
+    static TaskUpdate title(int id, std::string title) {
+        return {.id = id, .field = Field::Title, .text = std::move(title)};
+    }
+    static TaskUpdate description(int id, std::string description) {
+        return {.id = id, .field = Field::Description, .text = std::move(description)};
+    }
+};
+
+/**
+ * @struct BatchResult
+ * @brief Outcome of TaskManager::applyBatch
+ */
+struct BatchResult {
+    size_t applied = 0;                                 ///< Updates that took effect
+    std::vector<std::pair<size_t, TaskError>> failures; ///< Index of each rejected update and why
+};
 
 /**
  * @class TaskManager
  * @brief Manages a collection of tasks with various operations
- * @details Provides methods for adding, removing, updating, and querying tasks
+ * @details Provides methods for adding, removing, updating, and querying tasks.
+ *          Not synchronized; share one between threads through SharedTaskManager.
  */
 class TaskManager {
 private:
     std::vector<Task> _tasks;     /**< Collection of all tasks */
     int _next_id = 1;            /**< Next available task ID */
     
+    /**
+     * @brief Marker for ids that do not map to a slot in _tasks
+     */
+    static constexpr auto NO_SLOT = std::numeric_limits<size_t>::max();
+    
+    /**
+     * @brief Dense id -> slot index into _tasks
+     * @details Ids are handed out sequentially by _next_id, so a vector indexed
+     *          by id is both smaller and faster than a hash map
+     */
+    std::vector<size_t> _slot_by_id;
+    
+    static constexpr auto MAX_IDS_PER_TASK = 16uz;     ///< Loaded id range allowed per task (deleted ids leave gaps)
+    static constexpr auto MIN_DENSE_IDS = 1uz << 20;   ///< Loaded id range allowed however few tasks there are
+    
+    /**
+     * @brief Set of all task titles for constant-time duplicate checks
+     * @details Owns its strings because _tasks may reallocate and move titles
+     */
+    std::unordered_set<std::string, TransparentStringHash, std::equal_to<>> _titles;
+    
+    std::optional<size_t> _last_json_error_offset; /**< Byte offset of the last parse failure */
+    
+    TaskJournal* _journal = nullptr; /**< Journal receiving every mutation (not owned) */
+    
+    StatusCounters _counters;    /**< Per-status and per-priority task counts */
+    
+    TaskMatrix _matrix;          /**< Live category x priority index of task ids */
+    
+    bool _columnar = true;       /**< Whether the hot columns below are maintained */
+    TaskColumns _columns;        /**< Hot fields per slot, parallel to _tasks */
+    
+    TextIndex _text_index;       /**< Token index over titles and descriptions for findTasks */
+    
+    TimeIndex _time_index;       /**< Tasks ordered by creation, update and completion time */
+    
+    unsigned _workers = 1;       /**< Threads used by the bulk paths (1 = sequential) */
+    
+    /**
+     * @brief Change counter: bumped by every mutation and every load
+     */
+    std::uint64_t _change_epoch = 0;
+    
+    /**
+     * @brief Per segment: _change_epoch of its last change (0 = never changed)
+     * @details Consumers remember the epochs they wrote and compare, so the
+     *          segmented save and an autosave can each tell what changed since
+     *          their own last write
+     */
+    std::vector<std::uint64_t> _segment_epochs;
+    std::vector<std::uint64_t> _saved_segment_epochs;  /**< _segment_epochs as of the last segmented save or load */
+    std::string _segment_directory;  /**< Directory whose files match the tasks except dirty segments; empty if none */
+    
+    static constexpr auto SORT_KEY_COUNT = 4uz;  ///< Number of TaskSortKey values
+    static constexpr auto RADIX_SORT_MIN = 4096uz; ///< Full sorts at least this large use packed keys
+    
+    /**
+     * @struct SortOrder
+     * @brief Cached slot order for one TaskSortKey
+     * @details Only the first `ready` entries are in final order; the rest are
+     *          unordered leftovers of a partial sort. ready == 0 means stale.
+     */
+    struct SortOrder {
+        std::vector<size_t> slots;
+        size_t ready = 0;
+    };
+    
+    /**
+     * @brief Sort order cache per TaskSortKey
+     * @details Filled lazily by the const getSortedPage, hence mutable, which makes
+     *          getSortedPage unsafe even for concurrent readers
+     */
+    mutable std::array<SortOrder, SORT_KEY_COUNT> _sort_orders;
+    
+    /**
+     * @brief Find a task by its ID without copying it
+     * @details C++23: Uses deducing this - returns Task* or const Task* depending
+     *          on the constness of the manager. O(1) through the id index.
+     *          Private so that every mutation goes through a TaskManager method
+     *          that keeps the indexes, counters and journal in sync.
+     * @tparam Self Deduced self type (const or non-const)
+     * @param id The ID of the task to find
+     * @return Pointer to the task, or nullptr if not found
+     */
+    template<typename Self>
+    auto lookupTask(this Self&& self, int id) -> decltype(std::addressof(self._tasks.front())) {
+        size_t slot = self.slotOf(id);
+        if (slot == NO_SLOT) {
+            return nullptr;
+        }
+        return std::addressof(self._tasks[slot]);
+    }
+    
+    /**
+     * @brief Look up the slot of a task in _tasks
+     * @param id The task ID
+     * @return Slot index, or NO_SLOT if no task has this ID
+     */
+    size_t slotOf(int id) const;
+    
+    /**
+     * @brief Record the slot of a task in the id index
+     * @param id The task ID
+     * @param slot Position of the task in _tasks
+     */
+    void indexSlot(int id, size_t slot);
+    
+    /**
+     * @brief Rebuild the indexes, counters and matrix from scratch after _tasks was replaced
+     */
+    void rebuildIndexes();
+    
+    /**
+     * @brief Replace the whole task table with freshly loaded tasks
+     * @details Rejects tables with an id that is not positive, repeats or leaves
+     *          no room for the next id (INT_MAX), and tables whose id range
+     *          (next_id or the largest id) exceeds max(MAX_IDS_PER_TASK per task,
+     *          MIN_DENSE_IDS); the current tasks are kept then
+     * @param tasks Loaded tasks
+     * @param next_id Next id stored alongside them (raised above the largest id)
+     * @return Success, or InvalidFormat if the ids are invalid or too sparse for the dense indexes
+     */
+    JsonResult adoptTasks(std::vector<Task>&& tasks, int next_id);
+    
+    /**
+     * @brief Refill the hot columns from _tasks
+     */
+    void rebuildColumns();
+    
+    /**
+     * @brief Copy the hot fields of one task into its column row after a change
+     * @param task The changed task
+     */
+    void refreshColumns(const Task& task);
+    
+    /**
+     * @brief Drop the cached order for one sort key
+     */
+    void invalidateSortOrder(TaskSortKey key) {
+        _sort_orders[static_cast<size_t>(key)].ready = 0;
+    }
+    
+    /**
+     * @brief Drop the cached orders that depend on priority
+     */
+    void invalidatePrioritySortOrders() {
+        invalidateSortOrder(TaskSortKey::Priority);
+        invalidateSortOrder(TaskSortKey::PriorityCreated);
+    }
+    
+    /**
+     * @brief Drop every cached sort order (set of slots changed)
+     */
+    void invalidateSortOrders() {
+        for (auto& order : _sort_orders) {
+            order.ready = 0;
+        }
+    }
+    
+    /**
+     * @brief Make at least the first count slots of a sort order final
+     * @details Runs partial_sort when count is small against the task count and
+     *          keeps only that prefix; otherwise sorts everything, by radix sort
+     *          on packed keys when the order allows it and the set is large
+     * @param key Sort key
+     * @param count Number of leading positions needed
+     */
+    void prepareSortOrder(TaskSortKey key, size_t count) const;
+    
+    /**
+     * @brief Remove the task in a slot and re-slot the tasks behind it
+     * @param slot Position of the task in _tasks
+     */
+    void eraseSlot(size_t slot);
+    
+    /**
+     * @brief Build the journal record describing a mutation of a task
+     * @param op Mutation kind
+     * @param task Task after the mutation (supplies id, payload and timestamp)
+     */
+    static JournalRecord journalRecordFor(JournalOp op, const Task& task);
+    
+    /**
+     * @brief Record a mutation of a task: refile it in the time index, note the
+     *        change to its segment and append it to the attached journal, if any
+     * @param op Mutation kind
+     * @param task Task after the mutation (supplies id, payload and timestamp)
+     */
+    void recordMutation(JournalOp op, const Task& task);
+    
+    /**
+     * @brief Record a change to the segment holding an id
+     */
+    void touchSegment(int id) {
+        if (id <= 0) return;
+        size_t segment = static_cast<size_t>(id) / SEGMENT_SIZE;
+        if (segment >= _segment_epochs.size()) {
+            _segment_epochs.resize(segment + 1, 0);
+        }
+        _segment_epochs[segment] = ++_change_epoch;
+    }
+    
+    /**
+     * @brief Whether a segment changed since the last segmented save or load
+     */
+    bool segmentDirty(size_t segment) const {
+        std::uint64_t current = segment < _segment_epochs.size() ? _segment_epochs[segment] : 0;
+        std::uint64_t saved = segment < _saved_segment_epochs.size() ? _saved_segment_epochs[segment] : 0;
+        return current != saved;
+    }
+    
+    /**
+     * @brief Apply one journal record without journaling it again
+     * @details Marks the segment of every task it changes, batch members included
+     * @param record Record to apply
+     * @return true if the record changed the task table
+     */
+    bool applyJournalRecord(const JournalRecord& record);
+    
 public:
     /**
      * @brief Add a new task to the collection
@@ -41,6 +361,18 @@ public:
      */
     TaskOptional getTask(int id);
     
+    /**
+     * @brief Find a task by its ID without copying it
+     * @details O(1) through the id index. Read-only: use the updateTask* methods
+     *          to change a task. The pointer is invalidated by addTask, removeTask
+     *          and loading.
+     * @param id The ID of the task to find
+     * @return Pointer to the task, or nullptr if not found
+     */
+    const Task* findTask(int id) const {
+        return lookupTask(id);
+    }
+    
     /**
      * @brief Update the status of a task
      * @param id The ID of the task to update
@@ -49,6 +381,106 @@ public:
      */
     TaskResult updateTaskStatus(int id, TaskStatus status);
     
+    /**
+     * @brief Rename a task, keeping titles unique
+     * @details Use this instead of Task::setTitle so the title index stays in sync
+     * @param id The ID of the task to rename
+     * @param title The new title
+     * @return Success or error code
+     */
+    TaskResult updateTaskTitle(int id, const std::string& title);
+    
+    /**
+     * @brief Replace the description of a task
+     * @param id The ID of the task to update
+     * @param description New description
+     * @return Success or error code
+     */
+    TaskResult updateTaskDescription(int id, const std::string& description);
+    
+    /**
+     * @brief Apply many field updates in one pass
+     * @details Every update is stamped with one shared timestamp and its id is
+     *          resolved once. Counters, the matrix, the text index, the columns and
+     *          the sort caches are brought up to date once per touched task at the
+     *          end, and the whole batch becomes a single journal record. Updates
+     *          are applied in order; rejected ones are skipped and reported, and
+     *          later updates see the effect of earlier ones.
+     * @param updates Updates to apply
+     * @return Count of applied updates and the rejected ones
+     */
+    BatchResult applyBatch(std::span<const TaskUpdate> updates);
+    
+    /**
+     * @brief Find tasks whose title or description matches a query
+     * @details Whitespace-separated terms are ANDed; each term matches words it
+     *          is a case-insensitive prefix of, through the inverted index. Terms
+     *          without letters or digits (e.g. "#") fall back to a SIMD substring
+     *          scan (containsIgnoreCase).
+     * @param query Search query
+     * @return Ids of matching tasks in ascending order
+     */
+    std::vector<int> findTasks(std::string_view query) const;
+    
+    /**
+     * @brief Tasks with a timestamp in [from, to), oldest first
+     * @details O(log n + k) through the time index. The pointers are
+     *          invalidated by addTask, removeTask and loading.
+     * @param time Timestamp to select on
+     * @param from First time included; std::nullopt for no lower bound
+     * @param to First time excluded; std::nullopt for no upper bound
+     * @param limit Stop after this many tasks
+     * @return Matching tasks, ordered by the timestamp, then id
+     */
+    std::vector<const Task*> getTasksInTimeRange(TaskTime time,
+                                                 std::optional<std::chrono::system_clock::time_point> from,
+                                                 std::optional<std::chrono::system_clock::time_point> to = std::nullopt,
+                                                 size_t limit = std::numeric_limits<size_t>::max()) const;
+    
+    /**
+     * @brief Count tasks with a timestamp in [from, to) without listing them
+     * @details O(log n) plus one step per index block in the range
+     */
+    size_t countTasksInTimeRange(TaskTime time,
+                                 std::optional<std::chrono::system_clock::time_point> from,
+                                 std::optional<std::chrono::system_clock::time_point> to = std::nullopt) const;
+    
+    /**
+     * @brief Tasks per consecutive day by one timestamp, e.g. completions per day
+     * @details One walk over the index range of all the days: O(log n + k)
+     * @param time Timestamp to count
+     * @param first_day Start of the first day
+     * @param days Number of 24-hour days
+     * @return One count per day
+     */
+    std::vector<size_t> countTasksPerDay(TaskTime time, std::chrono::system_clock::time_point first_day,
+                                         size_t days) const;
+    
+    /**
+     * @brief Set the priority of a task
+     * @param id The ID of the task to update
+     * @param priority New priority (0-10)
+     * @return Success or error code
+     */
+    TaskResult updateTaskPriority(int id, int priority);
+    
+    /**
+     * @brief Set the category of a task
+     * @param id The ID of the task to update
+     * @param category New category
+     * @return Success or error code
+     */
+    TaskResult updateTaskCategory(int id, const std::string& category);
+    
+    /**
+     * @brief Check whether a task with the given title exists
+     * @param title Title to look up
+     * @return true if a task already uses this title
+     */
+    bool hasTitle(std::string_view title) const {
+        return _titles.contains(title);
+    }
+    
     /**
      * @brief Filter tasks using a predicate
      * @tparam Predicate Function type that takes a Task and returns bool
@@ -60,32 +492,102 @@ public:
         return _tasks | std::views::filter(std::forward<Predicate>(pred));
     }
     
+    /**
+     * @brief Filter tasks by a predicate on their slot
+     * @details The predicate sees only the slot index, so it can test the hot
+     *          columns without touching the Task object; matching slots are then
+     *          mapped back to const Task&
+     * @tparam SlotPredicate Function type that takes a slot and returns bool
+     * @param pred Predicate over slots
+     * @return Range of tasks whose slot satisfies the predicate
+     */
+    template<std::predicate<size_t> SlotPredicate>
+    auto filterSlots(SlotPredicate pred) const {
+        return std::views::iota(0uz, _tasks.size())
+             | std::views::filter(std::move(pred))
+             | std::views::transform([this](size_t slot) -> const Task& { return _tasks[slot]; });
+    }
+    
     /**
      * @brief Get tasks filtered by status
+     * @details Reads the status column when columnar scans are enabled
      * @param status Status to filter by
      * @return Range of tasks with the specified status
      */
     auto getTasksByStatus(TaskStatus status) const {
-        return filterTasks([status](const Task& task) {
-            return task.getStatus() == status;
+        return filterSlots([this, status](size_t slot) {
+            return _columnar ? _columns.status[slot] == static_cast<std::uint8_t>(status)
+                             : _tasks[slot].getStatus() == status;
         });
     }
     
     /**
      * @brief Get tasks filtered by priority range
+     * @details Reads the priority column when columnar scans are enabled
      * @param min_priority Minimum priority (inclusive)
      * @param max_priority Maximum priority (inclusive)
      * @return Range of tasks within the priority range
      */
     auto getTasksByPriority(int min_priority, int max_priority) const {
-        return filterTasks([min_priority, max_priority](const Task& task) {
-            int priority = task.getMetadata().priority;
+        return filterSlots([this, min_priority, max_priority](size_t slot) {
+            int priority = _columnar ? _columns.priority[slot] : _tasks[slot].getMetadata().priority;
             return priority >= min_priority && priority <= max_priority;
         });
     }
     
+    /**
+     * @brief Get tasks filtered by category
+     * @details Categories are interned, so the name is looked up once and each task
+     *          costs an id compare (from the category column when columnar scans
+     *          are enabled). A name that was never interned matches no task.
+     * @param category Category to filter by
+     * @return Range of tasks in the category
+     */
+    auto getTasksByCategory(std::string_view category) const {
+        auto interned = InternedString::find(category);
+        return filterSlots([this, interned](size_t slot) {
+            if (!interned) {
+                return false;
+            }
+            if (_columnar) {
+                return _columns.category[slot] == interned->id();
+            }
+            return _tasks[slot].getMetadata().category == *interned;
+        });
+    }
+    
+    /**
+     * @brief Collect the tasks that satisfy a predicate
+     * @details Materialized counterpart of filterTasks. With more than one worker
+     *          the predicate runs on chunks of the collection concurrently, so it
+     *          must be safe to call from several threads; results keep
+     *          collection order.
+     * @tparam Predicate Function type that takes a Task and returns bool
+     * @param pred Predicate function for filtering
+     * @return Pointers to matching tasks, invalidated by addTask, removeTask and loading
+     */
+    template<std::predicate<const Task&> Predicate>
+    std::vector<const Task*> collectTasks(Predicate pred) const {
+        constexpr size_t MIN_FILTER_CHUNK = 1uz << 14;
+        std::vector<std::vector<const Task*>> parts(parallel::chunkCount(_tasks.size(), _workers, MIN_FILTER_CHUNK));
+        parallel::forEachChunk(_tasks.size(), _workers, MIN_FILTER_CHUNK, [&](size_t chunk, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                if (pred(_tasks[i])) parts[chunk].push_back(&_tasks[i]);
+            }
+        });
+        
+        std::vector<const Task*> matches;
+        for (auto& part : parts) {
+            matches.insert(matches.end(), part.begin(), part.end());
+        }
+        return matches;
+    }
+    
     /**
      * @brief Get tasks sorted by custom criteria
+     * @details Sorts on the configured number of workers (setWorkerCount).
+     *          A SortBy from task_sort.h is a valid comparator, e.g.
+     *          getSortedTasks(SortBy<TaskField::Status, SortDir::Asc, TaskField::Priority, SortDir::Desc>{})
      * @tparam Compare Comparison function type
      * @param comp Comparison function for sorting
      * @return Vector of tasks sorted according to comparator
@@ -94,10 +596,45 @@ public:
     requires std::strict_weak_order<Compare, Task, Task>
     std::vector<Task> getSortedTasks(Compare&& comp) const {
         auto sorted_tasks = _tasks;
-        std::ranges::sort(sorted_tasks, std::forward<Compare>(comp));
+        if (_workers > 1) {
+            parallel::sort(sorted_tasks.begin(), sorted_tasks.end(), comp, _workers);
+        } else {
+            std::ranges::sort(sorted_tasks, std::forward<Compare>(comp));
+        }
         return sorted_tasks;
     }
     
+    /**
+     * @brief Set the number of threads used by the bulk paths
+     * @details Applies to JSON load and save, getSortedTasks, getSortedPage full
+     *          sorts and collectTasks. Single-task operations stay on the caller.
+     * @param workers Thread count, 0 for one per hardware thread, 1 to disable
+     */
+    void setWorkerCount(unsigned workers) {
+        _workers = parallel::resolveWorkerCount(workers);
+    }
+    
+    /**
+     * @brief Get the number of threads used by the bulk paths
+     */
+    unsigned getWorkerCount() const {
+        return _workers;
+    }
+    
+    /**
+     * @brief Get one page of the tasks in a fixed order, without copying them
+     * @details Orders are cached per key and only invalidated when that key's
+     *          field changes (priority, title) or tasks are added, removed or
+     *          loaded. Without a cached order, a small page is served by
+     *          partial_sort of offset + limit slots, O(n log k). Ties are broken by id.
+     * @param key Sort key
+     * @param offset Number of leading tasks to skip
+     * @param limit Maximum number of tasks to return
+     * @return Page of tasks plus the total count
+     */
+    SortedPage getSortedPage(TaskSortKey key, size_t offset = 0,
+                             size_t limit = std::numeric_limits<size_t>::max()) const;
+    
     /**
      * @brief Get the number of tasks in the collection
      * @details C++23: Uses deducing this for const/non-const resolution
@@ -111,29 +648,24 @@ public:
     
     /**
      * @brief Get all tasks in the collection
-     * @details C++23: Uses deducing this for const/non-const resolution
-     * @tparam Self Deduced self type (const or non-const)
+     * @details Read-only so that counters and indexes cannot be bypassed
      * @return Reference to the tasks vector
      */
-    template<typename Self>
-    auto getAllTasks(this Self&& self) -> decltype(auto) { 
-        return (std::forward<Self>(self)._tasks);
+    const std::vector<Task>& getAllTasks() const { 
+        return _tasks;
     }
     
     /**
      * @brief Access a task by its index in the collection
-     * @details C++23: Uses deducing this for const/non-const resolution
-     * @tparam Self Deduced self type (const or non-const)
      * @param index Position of the task in the collection
      * @return Reference to the task
      * @throws std::out_of_range if index is out of bounds
      */
-    template<typename Self>
-    auto getTaskByIndex(this Self&& self, size_t index) -> decltype(auto) {
-        if (index >= self._tasks.size()) {
+    const Task& getTaskByIndex(size_t index) const {
+        if (index >= _tasks.size()) {
             throw std::out_of_range("Task index out of range");
         }
-        return (std::forward<Self>(self)._tasks[index]);
+        return _tasks[index];
     }
     
     /**
@@ -143,21 +675,83 @@ public:
     ///@{
     /**
      * @brief Count completed tasks
-     * @return Number of completed tasks
+     * @return Number of completed tasks (O(1))
      */
     size_t getCompletedTasksCount() const;
     
     /**
      * @brief Count pending tasks
-     * @return Number of pending tasks
+     * @return Number of pending tasks (O(1))
      */
     size_t getPendingTasksCount() const;
     
     /**
      * @brief Calculate task completion rate
-     * @return Percentage of completed tasks
+     * @return Percentage of completed tasks (O(1))
      */
     double getCompletionRate() const;
+    
+    /**
+     * @brief Count tasks with a given status
+     * @param status Status to count
+     * @return Number of tasks (O(1))
+     */
+    size_t getTaskCountByStatus(TaskStatus status) const {
+        return _counters.by_status[static_cast<size_t>(status)];
+    }
+    
+    /**
+     * @brief Count tasks with a given priority
+     * @param priority Priority level (0-10)
+     * @return Number of tasks, 0 for priorities outside the valid range (O(1))
+     */
+    size_t getTaskCountByPriority(int priority) const {
+        if (priority < 0 || static_cast<size_t>(priority) >= StatusCounters::PRIORITY_LEVELS) {
+            return 0;
+        }
+        return _counters.by_priority[static_cast<size_t>(priority)];
+    }
+    
+    /**
+     * @brief Get all running counters at once
+     * @return Per-status and per-priority counts
+     */
+    const StatusCounters& getCounters() const {
+        return _counters;
+    }
+    
+    /**
+     * @brief Enable or disable the columnar hot storage
+     * @details Enabled by default. When disabled, the columns are released and
+     *          scans read the Task objects directly.
+     * @param enabled true to maintain the columns
+     */
+    void setColumnarScans(bool enabled);
+    
+    /**
+     * @brief Check whether scans use the columnar hot storage
+     */
+    bool hasColumnarScans() const {
+        return _columnar;
+    }
+    
+    /**
+     * @brief Get the hot columns (empty when columnar scans are disabled)
+     * @return Columns parallel to getAllTasks()
+     */
+    const TaskColumns& getColumns() const {
+        return _columns;
+    }
+    
+    /**
+     * @brief Get the category x priority index
+     * @details Kept up to date by addTask, removeTask, updateTaskPriority and
+     *          updateTaskCategory; buckets hold task ids for findTask()
+     * @return Reference to the live matrix
+     */
+    const TaskMatrix& getMatrix() const {
+        return _matrix;
+    }
     ///@}
     
     /**
@@ -170,13 +764,31 @@ public:
      */
     void listTasks() const;
     
+    /**
+     * @brief Format the task list into a buffer instead of printing it
+     * @param out Buffer to append to
+     */
+    void listTasks(std::string& out) const;
+    
     /**
      * @brief Display tasks filtered by status
      * @param status Status to filter by
      */
     void listTasksByStatus(TaskStatus status) const;
+    
+    /**
+     * @brief Format the tasks with a status into a buffer instead of printing them
+     * @param status Status to filter by
+     * @param out Buffer to append to
+     */
+    void listTasksByStatus(TaskStatus status, std::string& out) const;
     ///@}
     
+    /**
+     * @brief Task ids per segment of the segmented layout (see task_segments.h)
+     */
+    static constexpr auto SEGMENT_SIZE = 1024uz;
+    
     /**
      * @name JSON Serialization Methods
      * @brief Methods for JSON persistence
@@ -191,23 +803,172 @@ public:
     
     /**
      * @brief Load tasks from a JSON file
+     * @details The file is memory-mapped (or read once as a fallback) and parsed in place
      * @param filename Path to the input file
      * @return Success or error code
      */
     JsonResult loadFromJson(const std::string& filename);
     
+    /**
+     * @brief Save tasks to a binary snapshot file
+     * @details Fixed-width records with int64 timestamps and a deduplicated string
+     *          table; see task_snapshot.h. Much faster to reload than JSON.
+     * @param filename Path to the output file
+     * @return Success or error code
+     */
+    JsonResult saveToBinary(const std::string& filename) const;
+    
+    /**
+     * @brief Load tasks from a binary snapshot file
+     * @param filename Path to the input file
+     * @return Success or error code; the current tasks are kept on failure
+     */
+    JsonResult loadFromBinary(const std::string& filename);
+    
+    /**
+     * @brief Save tasks to a segment directory, rewriting only what changed
+     * @details Segments are id ranges of SEGMENT_SIZE ids. When the directory
+     *          is the one last saved to or loaded from, only segments with
+     *          added, removed or modified tasks are rewritten (tasks in id
+     *          order) and the manifest is updated; otherwise every segment is
+     *          written. A save with no changes writes nothing. Segments are
+     *          written under a new generation's file names and the manifest
+     *          rename commits the save; only then are the files it no longer
+     *          lists deleted, so an interrupted save leaves the previous one.
+     * @param directory Segment directory, created if missing
+     * @return Counts of files written and removed, or error code
+     */
+    std::expected<SegmentSaveStats, JsonError> saveToSegments(const std::string& directory);
+    
+    /**
+     * @brief Load tasks from a segment directory
+     * @details Segments are read in index order; the current tasks are kept on failure.
+     *          A segment whose task count differs from the manifest, or holding ids
+     *          outside its range, fails the load with InvalidFormat.
+     * @param directory Segment directory written by saveToSegments
+     * @return Success or error code
+     */
+    JsonResult loadFromSegments(const std::string& directory);
+    
+    /**
+     * @brief Number of segments changed since the last segmented save or load
+     * @return Dirty segments, or nullopt if no segment directory matches the tasks
+     */
+    std::optional<size_t> getDirtySegmentCount() const {
+        if (_segment_directory.empty()) return std::nullopt;
+        size_t dirty = 0;
+        for (size_t segment = 0; segment < getSegmentCount(); ++segment) {
+            dirty += segmentDirty(segment);
+        }
+        return dirty;
+    }
+    
+    /**
+     * @brief Number of segments spanned by the ids handed out so far
+     */
+    size_t getSegmentCount() const {
+        return static_cast<size_t>(std::max(_next_id, 1) - 1) / SEGMENT_SIZE + 1;
+    }
+    
+    /**
+     * @brief Counter bumped by every mutation and every load
+     * @details The difference between two readings bounds the number of
+     *          task changes in between
+     */
+    std::uint64_t getChangeEpoch() const {
+        return _change_epoch;
+    }
+    
+    /**
+     * @brief Change epoch of each segment's last change
+     * @details Segments past the end of the span never changed (epoch 0)
+     */
+    std::span<const std::uint64_t> getSegmentEpochs() const {
+        return _segment_epochs;
+    }
+    
+    /**
+     * @brief List the tasks of one segment in id order, without copying them
+     * @param segment Segment number
+     * @param tasks Receives pointers to the tasks (cleared first)
+     */
+    void collectSegmentTasks(size_t segment, std::vector<const Task*>& tasks) const;
+    
+    /**
+     * @brief Get the id the next added task will receive
+     */
+    int getNextId() const {
+        return _next_id;
+    }
+    
     /**
      * @brief Convert tasks to JSON string
      * @return JSON representation of all tasks
      */
     std::string toJsonString() const;
     
+    /**
+     * @brief Write the full task document to a writer
+     * @param writer Destination writer (in-memory or stream-backed)
+     */
+    void writeJson(TaskJsonWriter& writer) const;
+    
     /**
      * @brief Parse tasks from JSON string
+     * @details Single pass over the input; on failure the current tasks are kept
+     *          and the byte offset is available from getLastJsonErrorOffset()
      * @param json_str JSON string to parse
      * @return Success or error code
      */
-    JsonResult fromJsonString(const std::string& json_str);
+    JsonResult fromJsonString(std::string_view json_str);
+    
+    /**
+     * @brief Byte offset of the last JSON parse failure
+     * @return Offset into the input, or nullopt if the last parse succeeded
+     */
+    std::optional<size_t> getLastJsonErrorOffset() const {
+        return _last_json_error_offset;
+    }
+    ///@}
+    
+    /**
+     * @name Journal Methods
+     * @brief Incremental persistence through a write-ahead journal
+     */
+    ///@{
+    /**
+     * @brief Attach a journal that receives every subsequent mutation
+     * @details Covers addTask, removeTask and the updateTask* methods. The journal
+     *          must outlive the manager or be detached with nullptr first.
+     * @param journal Journal to append to, or nullptr to stop journaling
+     */
+    void attachJournal(TaskJournal* journal) { _journal = journal; }
+    
+    /**
+     * @brief Get the attached journal
+     * @return Journal, or nullptr if journaling is off
+     */
+    TaskJournal* getJournal() const { return _journal; }
+    
+    /**
+     * @brief Replay journal records on top of the current tasks
+     * @details Records keep their original ids and timestamps. Adds with an id
+     *          below the current next id are already part of the loaded snapshot
+     *          and are skipped, as are records for tasks that no longer exist.
+     * @param records Records in journal order
+     * @return Number of records applied
+     */
+    size_t replayJournal(std::span<const JournalRecord> records);
+    
+    /**
+     * @brief Fold the journal into a new binary snapshot
+     * @details The snapshot is written to a temporary file, synced and renamed
+     *          over snapshot_path before the attached journal is truncated, so a
+     *          crash at any point leaves a snapshot plus a replayable journal.
+     * @param snapshot_path Snapshot to replace
+     * @return Success or error code
+     */
+    JsonResult compactJournal(const std::string& snapshot_path);
     ///@}
 };
 
@@ -5,40 +5,85 @@
  */
 
 #include "task_matrix.h"
+#include "task_manager.h"
 #include <print>
+#include <format>
+#include <iterator>
 #include <algorithm>
 
+InternedString TaskMatrix::bucketCategory(const InternedString& category) {
+    static const InternedString default_category("Default");
+    return category.empty() ? default_category : category;
+}
+
 /**
  * @brief Add a task to the matrix in its appropriate category and priority
  * @param task The task to add
+ * @details Ids are handed out in increasing order, so the common case is an append
  */
 void TaskMatrix::addTask(const Task& task) {
-    const std::string& category = task.getMetadata().category.empty() ? 
-        "Default" : task.getMetadata().category;
-    int priority = task.getMetadata().priority;
+    auto& ids = matrix[bucketCategory(task.getMetadata().category)][task.getMetadata().priority];
+    int id = task.getId();
     
-    matrix[category][priority].push_back(task);
+    if (ids.empty() || ids.back() < id) {
+        ids.push_back(id);
+    } else {
+        auto it = std::ranges::lower_bound(ids, id);
+        if (it != ids.end() && *it == id) return;
+        ids.insert(it, id);
+    }
+    ++_total;
+}
+
+bool TaskMatrix::eraseId(int task_id, const InternedString& category, int priority) {
+    auto cat_it = matrix.find(category);
+    if (cat_it == matrix.end()) return false;
+    
+    auto& priority_map = cat_it->second;
+    auto prio_it = priority_map.find(priority);
+    if (prio_it == priority_map.end()) return false;
+    
+    auto& ids = prio_it->second;
+    auto it = std::ranges::lower_bound(ids, task_id);
+    if (it == ids.end() || *it != task_id) return false;
+    
+    ids.erase(it);
+    --_total;
+    
+    // Prune empty buckets so 'matrix' only lists categories that are in use
+    if (ids.empty()) {
+        priority_map.erase(prio_it);
+        if (priority_map.empty()) {
+            matrix.erase(cat_it);
+        }
+    }
+    return true;
 }
 
 /**
- * @brief Remove a task from the matrix by its ID
- * @param task_id ID of the task to remove
+ * @brief Remove a task from the bucket of its current category and priority
+ * @param task The task to remove
  * @return true if task was found and removed, false otherwise
  */
-bool TaskMatrix::removeTask(int task_id) {
-    for (auto it = matrix.begin(); it != matrix.end(); ++it) {
-        auto& priority_map = it->second;
-        for (auto pit = priority_map.begin(); pit != priority_map.end(); ++pit) {
-            auto& tasks = pit->second;
-            auto task_it = std::find_if(tasks.begin(), tasks.end(),
-                [task_id](const Task& t) { return t.getId() == task_id; });
-            if (task_it != tasks.end()) {
-                tasks.erase(task_it);
-                return true;
-            }
-        }
+bool TaskMatrix::removeTask(const Task& task) {
+    return eraseId(task.getId(), bucketCategory(task.getMetadata().category), task.getMetadata().priority);
+}
+
+/**
+ * @brief Move a task after its category or priority changed
+ * @param task The task, already carrying its new category and priority
+ * @param old_category Category before the change
+ * @param old_priority Priority before the change
+ */
+void TaskMatrix::moveTask(const Task& task, const InternedString& old_category, int old_priority) {
+    InternedString new_category = bucketCategory(task.getMetadata().category);
+    if (bucketCategory(old_category) == new_category && old_priority == task.getMetadata().priority) {
+        return;
+    }
+    
+    if (eraseId(task.getId(), bucketCategory(old_category), old_priority)) {
+        addTask(task);
     }
-    return false;
 }
 
 /**
@@ -47,8 +92,9 @@ bool TaskMatrix::removeTask(int task_id) {
  */
 std::vector<std::string> TaskMatrix::getCategories() const {
     std::vector<std::string> categories;
+    categories.reserve(matrix.size());
     for (auto it = matrix.begin(); it != matrix.end(); ++it) {
-        categories.push_back(it->first);
+        categories.push_back(it->first.str());
     }
     return categories;
 }
@@ -58,7 +104,7 @@ std::vector<std::string> TaskMatrix::getCategories() const {
  * @param category The category name to look up
  * @return Vector of priority levels
  */
-std::vector<int> TaskMatrix::getPriorities(const std::string& category) const {
+std::vector<int> TaskMatrix::getPriorities(std::string_view category) const {
     std::vector<int> priorities;
     auto it = matrix.find(category);
     if (it != matrix.end()) {
@@ -72,21 +118,36 @@ std::vector<int> TaskMatrix::getPriorities(const std::string& category) const {
 /**
  * @brief Display matrix structure
  * @details Outputs a hierarchical view of categories, priorities, and tasks
+ * @param manager Manager owning the tasks, used to resolve ids to titles
+ */
+void TaskMatrix::displayMatrix(const TaskManager& manager) const {
+    std::string out;
+    displayMatrix(manager, out);
+    std::print("{}", out);
+}
+
+/**
+ * @brief Format the matrix structure into a buffer instead of printing it
+ * @param manager Manager owning the tasks, used to resolve ids to titles
+ * @param out Buffer to append to
  */
-void TaskMatrix::displayMatrix() const {
-    std::print("\n📊 Task Matrix Structure:\n");
-    std::print("=========================\n");
+void TaskMatrix::displayMatrix(const TaskManager& manager, std::string& out) const {
+    auto it_out = std::back_inserter(out);
+    out += "\n📊 Task Matrix Structure:\n";
+    out += "=========================\n";
     
     for (auto it = matrix.begin(); it != matrix.end(); ++it) {
         const auto& category = it->first;
         const auto& priority_map = it->second;
-        std::print("📂 Category: {}\n", category);
+        std::format_to(it_out, "📂 Category: {}\n", category);
         for (auto pit = priority_map.begin(); pit != priority_map.end(); ++pit) {
             const auto& priority = pit->first;
-            const auto& tasks = pit->second;
-            std::print("  🎯 Priority {}: {} task(s)\n", priority, tasks.size());
-            for (const auto& task : tasks) {
-                std::print("    [{}] {}\n", task.getId(), task.getTitle());
+            const auto& ids = pit->second;
+            std::format_to(it_out, "  🎯 Priority {}: {} task(s)\n", priority, ids.size());
+            for (int id : ids) {
+                if (const Task* task = manager.findTask(id)) {
+                    std::format_to(it_out, "    [{}] {}\n", id, task->getTitle());
+                }
             }
         }
     }
@@ -98,4 +159,5 @@ void TaskMatrix::displayMatrix() const {
  */
 void TaskMatrix::clear() {
     matrix.clear();
+    _total = 0uz;
 }
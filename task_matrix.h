@@ -4,68 +4,81 @@
 /**
  * @file task_matrix.h
  * @brief Defines the TaskMatrix class for organizing tasks by category and priority
- * @details Uses C++23 features like flat_map, deducing this, and multidimensional subscript operators
+ * @details Uses C++23 features like flat_map and multidimensional subscript operators
  */
 
 #include "task.h"
 #include <flat_map>         // C++23: std::flat_map for better cache locality
-#include <unordered_map>    // Keep as fallback/comparison
 #include <vector>
 #include <string>
+#include <string_view>
+
+class TaskManager;
 
 /**
  * @class TaskMatrix
- * @brief Matrix for organizing tasks by category and priority
+ * @brief Live secondary index of task ids by category and priority
  * @details C++23 Feature: Multidimensional Subscript Operator with flat_map optimization
- *          for better cache locality and performance
+ *          for better cache locality and performance. Owned by TaskManager and updated
+ *          on add, remove and category/priority changes; stores ids, never Task copies.
  */
 class TaskMatrix {
 private:
     /**
-     * @brief Two-dimensional map of tasks organized by category and priority
-     * @details C++23: Uses flat_map for better cache locality and iteration performance
+     * @brief Two-dimensional map of task ids organized by category and priority
+     * @details C++23: Uses flat_map for better cache locality and iteration performance.
+     *          Keyed by interned category (one pointer per key, looked up by name
+     *          through the transparent comparator). Each bucket is sorted by id;
+     *          empty buckets are removed.
+     */
+    std::flat_map<InternedString, std::flat_map<int, std::vector<int>>, InternedStringLess> matrix;
+    
+    size_t _total = 0uz;    ///< Number of ids across all buckets
+    
+    /**
+     * @brief Category under which a task is filed
+     * @param category The task's category
+     * @return The category, or "Default" if it is empty
+     */
+    static InternedString bucketCategory(const InternedString& category);
+    
+    /**
+     * @brief Remove an id from one bucket, pruning the bucket if it becomes empty
+     * @param task_id ID to remove
+     * @param category Bucket category
+     * @param priority Bucket priority
+     * @return true if the id was found and removed
      */
-    std::flat_map<std::string, std::flat_map<int, std::vector<Task>>> matrix;
+    bool eraseId(int task_id, const InternedString& category, int priority);
     
 public:
     /**
-     * @brief Multidimensional subscript operator for accessing tasks by category and priority
-     * @details C++23: Uses deducing this to handle both const and non-const access
-     * 
-     * @tparam Self Deduced self type (const or non-const)
+     * @brief Multidimensional subscript operator for accessing task ids by category and priority
+     * @details C++23: Multidimensional subscript. Read-only; TaskManager maintains the buckets.
      * @param category The category name
      * @param priority The priority level
-     * @return Reference to vector of tasks (creates if non-const, returns empty if const and not found)
-     */
-    template<typename Self>
-    decltype(auto) operator[](this Self&& self, const std::string& category, int priority) {
-        if constexpr (std::is_const_v<std::remove_reference_t<Self>>) {
-            // Const version - return empty if not found
-            static const std::vector<Task> empty;
-            auto cat_it = self.matrix.find(category);
-            if (cat_it == self.matrix.end()) return empty;
-            
-            auto prio_it = cat_it->second.find(priority);
-            if (prio_it == cat_it->second.end()) return empty;
-            
-            return prio_it->second;
-        } else {
-            // Non-const version - create if not exists
-            return (std::forward<Self>(self).matrix[category][priority]);
-        }
+     * @return Sorted ids in the bucket (empty if the bucket does not exist)
+     */
+    const std::vector<int>& operator[](std::string_view category, int priority) const {
+        static const std::vector<int> empty;
+        auto cat_it = matrix.find(category);
+        if (cat_it == matrix.end()) return empty;
+        
+        auto prio_it = cat_it->second.find(priority);
+        if (prio_it == cat_it->second.end()) return empty;
+        
+        return prio_it->second;
     }
     
     /**
      * @brief Traditional single-dimension access operator (by category)
-     * @details C++23: Uses deducing this to handle both const and non-const access
-     * 
-     * @tparam Self Deduced self type (const or non-const)
      * @param category The category name
-     * @return Reference to category's priority map
+     * @return Priority map of the category (empty if the category does not exist)
      */
-    template<typename Self>
-    decltype(auto) operator[](this Self&& self, const std::string& category) {
-        return (std::forward<Self>(self).matrix[category]);
+    const std::flat_map<int, std::vector<int>>& operator[](std::string_view category) const {
+        static const std::flat_map<int, std::vector<int>> empty;
+        auto cat_it = matrix.find(category);
+        return cat_it == matrix.end() ? empty : cat_it->second;
     }
     
     /**
@@ -75,11 +88,19 @@ public:
     void addTask(const Task& task);
     
     /**
-     * @brief Remove a task from the matrix by its ID
-     * @param task_id ID of the task to remove
+     * @brief Remove a task from the bucket of its current category and priority
+     * @param task The task to remove
      * @return true if task was found and removed, false otherwise
      */
-    bool removeTask(int task_id);
+    bool removeTask(const Task& task);
+    
+    /**
+     * @brief Move a task after its category or priority changed
+     * @param task The task, already carrying its new category and priority
+     * @param old_category Category before the change
+     * @param old_priority Priority before the change
+     */
+    void moveTask(const Task& task, const InternedString& old_category, int old_priority);
     
     /**
      * @brief Get a list of all categories in the matrix
@@ -92,30 +113,31 @@ public:
      * @param category The category name to look up
      * @return Vector of priority levels
      */
-    std::vector<int> getPriorities(const std::string& category) const;
-    
-    // Get task count for [category, priority] with deducing this
-    template<typename Self>
-    auto getTaskCount(this Self&& self, const std::string& category, int priority) -> size_t {
-        if constexpr (std::is_const_v<std::remove_reference_t<Self>>) {
-            // Const version - return 0 if not found
-            auto cat_it = self.matrix.find(category);
-            if (cat_it == self.matrix.end()) return 0;
-            
-            auto prio_it = cat_it->second.find(priority);
-            if (prio_it == cat_it->second.end()) return 0;
-            
-            return prio_it->second.size();
-        } else {
-            return self[category, priority].size();
-        }
+    std::vector<int> getPriorities(std::string_view category) const;
+    
+    /**
+     * @brief Get task count for [category, priority]
+     * @param category The category name
+     * @param priority The priority level
+     * @return Number of tasks in the bucket
+     */
+    size_t getTaskCount(std::string_view category, int priority) const {
+        return (*this)[category, priority].size();
     }
     
     /**
      * @brief Display matrix structure
      * @details Outputs a hierarchical view of categories, priorities, and tasks
+     * @param manager Manager owning the tasks, used to resolve ids to titles
+     */
+    void displayMatrix(const TaskManager& manager) const;
+    
+    /**
+     * @brief Format the matrix structure into a buffer instead of printing it
+     * @param manager Manager owning the tasks, used to resolve ids to titles
+     * @param out Buffer to append to
      */
-    void displayMatrix() const;
+    void displayMatrix(const TaskManager& manager, std::string& out) const;
     
     /**
      * @brief Clear the matrix
@@ -123,28 +145,21 @@ public:
      */
     void clear();
     
-    // Check if category exists with deducing this
-    template<typename Self>
-    auto hasCategory(this Self&& self, const std::string& category) -> bool {
-        return self.matrix.contains(category);  
+    /**
+     * @brief Check if a category has any tasks
+     * @param category The category name
+     * @return true if at least one task uses the category
+     */
+    bool hasCategory(std::string_view category) const {
+        return matrix.contains(category);  
     }
     
-    // Get total task count with deducing this
     /**
      * @brief Get total number of tasks across all categories and priorities
-     * @details C++23: Uses deducing this for both const and non-const access
-     * @tparam Self Deduced self type (const or non-const)
-     * @return Total number of tasks in the matrix
-     */
-    template<typename Self>
-    auto getTotalTaskCount(this Self&& self) -> size_t {
-        size_t total = 0uz; 
-        for (auto it = self.matrix.begin(); it != self.matrix.end(); ++it) {
-            for (auto pit = it->second.begin(); pit != it->second.end(); ++pit) {
-                total += pit->second.size();
-            }
-        }
-        return total;
+     * @return Total number of tasks in the matrix (O(1))
+     */
+    size_t getTotalTaskCount() const {
+        return _total;
     }
 };
 
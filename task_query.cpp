@@ -0,0 +1,324 @@
+/**
+ * @file task_query.cpp
+ * @brief Parser and planner for TaskQuery
+ */
+
+#include "task_query.h"
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <iterator>
+
+namespace {
+
+std::optional<int> parseNumber(std::string_view text) {
+    int value = 0;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || ptr != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/**
+ * @brief Collects matches into a page, or all of them when they must be sorted
+ */
+class MatchSink {
+private:
+    const TaskQuery& _query;
+    QueryResult& _result;
+
+public:
+    MatchSink(const TaskQuery& query, QueryResult& result) : _query(query), _result(result) {}
+
+    void add(const Task& task) {
+        size_t index = _result.total++;
+        // Unsorted matches arrive in final order: keep only the page
+        if (_query.sort || (index >= _query.offset && index - _query.offset < _query.limit)) {
+            _result.tasks.push_back(&task);
+        }
+    }
+
+    void finish() {
+        if (!_query.sort) {
+            return;
+        }
+        auto& tasks = _result.tasks;
+        if (_query.offset >= tasks.size() || _query.limit == 0) {
+            tasks.clear();
+            return;
+        }
+        size_t end = _query.offset + std::min(_query.limit, tasks.size() - _query.offset);
+        withSortOrder(*_query.sort, [&](auto order) {
+            auto less = [order](const Task* a, const Task* b) { return order(*a, *b); };
+            std::partial_sort(tasks.begin(), tasks.begin() + end, tasks.end(), less);
+        });
+        tasks.erase(tasks.begin() + end, tasks.end());
+        tasks.erase(tasks.begin(), tasks.begin() + _query.offset);
+    }
+};
+
+/// The matrix drives a query only if its candidates are at most this fraction of the tasks
+constexpr size_t MATRIX_SCAN_FRACTION = 8;
+
+/**
+ * @brief Call fn(id) for the ids of several ascending runs, in ascending order
+ */
+template<typename Fn>
+void forEachMergedId(std::span<const std::span<const int>> runs, Fn&& fn) {
+    if (runs.size() == 1) {
+        for (int id : runs.front()) fn(id);
+        return;
+    }
+    // Min-heap of (next id, run, position); there are at most PRIORITY_LEVELS runs
+    struct Cursor {
+        int id;
+        size_t run;
+        size_t next;
+    };
+    auto after = [](const Cursor& a, const Cursor& b) { return a.id > b.id; };
+    std::vector<Cursor> heap;
+    heap.reserve(runs.size());
+    for (size_t run = 0; run < runs.size(); ++run) {
+        if (!runs[run].empty()) heap.push_back({runs[run].front(), run, 1});
+    }
+    std::ranges::make_heap(heap, after);
+    while (!heap.empty()) {
+        std::ranges::pop_heap(heap, after);
+        Cursor& cursor = heap.back();
+        fn(cursor.id);
+        if (cursor.next < runs[cursor.run].size()) {
+            cursor.id = runs[cursor.run][cursor.next++];
+            std::ranges::push_heap(heap, after);
+        } else {
+            heap.pop_back();
+        }
+    }
+}
+
+} // namespace
+
+std::expected<TaskQuery, std::string> parseTaskQuery(std::span<const std::string_view> terms) {
+    TaskQuery query;
+    auto invalid = [](std::string_view what, std::string_view term) {
+        return std::unexpected(std::format("Invalid {}: {}", what, term));
+    };
+
+    for (std::string_view term : terms) {
+        if (term.starts_with("text~")) {
+            if (term.size() == 5) return invalid("text filter", term);
+            if (!query.text.empty()) query.text += ' ';
+            query.text += term.substr(5);
+            continue;
+        }
+
+        // key, operator and value: the operator is the first run of = < >
+        size_t op_begin = term.find_first_of("=<>");
+        if (op_begin == std::string_view::npos || op_begin == 0) {
+            return invalid("query term", term);
+        }
+        size_t op_end = term.find_first_not_of("=<>", op_begin);
+        if (op_end == std::string_view::npos || op_end == term.size()) {
+            return invalid("query term", term);
+        }
+        std::string_view key = term.substr(0, op_begin);
+        std::string_view op = term.substr(op_begin, op_end - op_begin);
+        std::string_view value = term.substr(op_end);
+
+        if (key == "priority") {
+            // Priorities are 0-10, as Task::setPriority enforces; this also keeps +1 / -1 below from overflowing
+            auto priority = parseNumber(value);
+            if (!priority || *priority < 0 || *priority >= static_cast<int>(StatusCounters::PRIORITY_LEVELS)) {
+                return invalid("priority (0-10)", term);
+            }
+            if (op == "=") {
+                query.min_priority = std::max(query.min_priority, *priority);
+                query.max_priority = std::min(query.max_priority, *priority);
+            } else if (op == ">=") {
+                query.min_priority = std::max(query.min_priority, *priority);
+            } else if (op == ">") {
+                query.min_priority = std::max(query.min_priority, *priority + 1);
+            } else if (op == "<=") {
+                query.max_priority = std::min(query.max_priority, *priority);
+            } else if (op == "<") {
+                query.max_priority = std::min(query.max_priority, *priority - 1);
+            } else {
+                return invalid("priority comparison", term);
+            }
+            continue;
+        }
+
+        if (op != "=") {
+            return invalid("query term (only priority supports < and >)", term);
+        }
+        if (key == "id") {
+            auto id = parseNumber(value);
+            if (!id || query.id) return invalid("id", term);
+            query.id = *id;
+        } else if (key == "status") {
+            auto status = stringToTaskStatus(value);
+            if (!status || query.status) return invalid("status", term);
+            query.status = *status;
+        } else if (key == "category") {
+            if (query.category) return invalid("category", term);
+            query.category = std::string(value);
+        } else if (key == "sort") {
+            query.sort = stringToTaskSortKey(value);
+            if (!query.sort) return invalid("sort key", term);
+        } else if (key == "limit" || key == "offset") {
+            auto count = parseNumber(value);
+            if (!count || *count < 0) return invalid(key, term);
+            (key == "limit" ? query.limit : query.offset) = static_cast<size_t>(*count);
+        } else {
+            return invalid("query key", term);
+        }
+    }
+    return query;
+}
+
+QueryResult runTaskQuery(const TaskManager& manager, const TaskQuery& query) {
+    QueryResult result{.offset = query.offset};
+    MatchSink sink(query, result);
+
+    const int min_priority = std::max(query.min_priority, 0);
+    const int max_priority = std::min(query.max_priority, static_cast<int>(StatusCounters::PRIORITY_LEVELS) - 1);
+
+    // Counters and the category pool answer "nothing matches" in O(1)
+    const StatusCounters& counters = manager.getCounters();
+    size_t status_count = query.status ? counters.by_status[static_cast<size_t>(*query.status)]
+                                       : manager.getTaskCount();
+    size_t priority_count = 0;
+    for (int priority = min_priority; priority <= max_priority; ++priority) {
+        priority_count += counters.by_priority[static_cast<size_t>(priority)];
+    }
+    std::optional<InternedString> category;
+    if (query.category) {
+        category = InternedString::find(*query.category);
+    }
+    if (status_count == 0 || priority_count == 0 || (query.category && !category)) {
+        result.source = QuerySource::Counters;
+        return result;
+    }
+
+    auto matchesFields = [&](const Task& task) {
+        int priority = task.getMetadata().priority;
+        return (!query.status || task.getStatus() == *query.status) &&
+               priority >= min_priority && priority <= max_priority &&
+               (!category || task.getMetadata().category == *category);
+    };
+
+    auto visitId = [&](int id) {
+        const Task* task = manager.findTask(id);
+        if (!task) return;
+        ++result.candidates;
+        if (matchesFields(*task)) sink.add(*task);
+    };
+
+    if (query.id) {
+        result.source = QuerySource::Id;
+        visitId(*query.id);
+        sink.finish();
+        return result;
+    }
+
+    // Candidate counts of the id sources; status has no id list, its counter only bounds the matches
+    std::optional<std::vector<int>> text_ids;
+    if (!query.text.empty()) {
+        text_ids = manager.findTasks(query.text);
+        if (text_ids->empty()) {
+            result.source = QuerySource::TextIndex;
+            return result;
+        }
+    }
+    // The matrix files empty categories under "Default", so it cannot answer that one exactly
+    const bool matrix_usable = category && category->view() != "Default";
+    size_t matrix_count = 0;
+    if (matrix_usable) {
+        for (int priority = min_priority; priority <= max_priority; ++priority) {
+            matrix_count += manager.getMatrix().getTaskCount(category->view(), priority);
+        }
+    }
+    if (matrix_usable && matrix_count == 0) {
+        result.source = QuerySource::Counters;
+        return result;
+    }
+
+    // Drive from the smallest source and leave the other filters to each candidate. The text
+    // index is the only way to check text, so with a text term the matrix drives only when
+    // it is smaller and the text ids become a membership test. Without one, a matrix lookup
+    // per candidate beats the column scan only while the category is a small part of the tasks.
+    const bool matrix_drives = matrix_usable &&
+        (text_ids ? matrix_count < text_ids->size()
+                  : matrix_count <= manager.getTaskCount() / MATRIX_SCAN_FRACTION);
+    if (text_ids && !matrix_drives) {
+        result.source = QuerySource::TextIndex;
+        for (int id : *text_ids) {
+            visitId(id);
+        }
+        sink.finish();
+        return result;
+    }
+    if (matrix_drives) {
+        result.source = text_ids ? QuerySource::TextAndMatrix : QuerySource::Matrix;
+        // Buckets of the priority range, each sorted by id: merged, not re-sorted
+        std::vector<std::span<const int>> buckets;
+        for (const auto& [priority, bucket] : manager.getMatrix()[category->view()]) {
+            if (priority >= min_priority && priority <= max_priority && !bucket.empty()) {
+                buckets.emplace_back(bucket);
+            }
+        }
+        forEachMergedId(buckets, [&](int id) {
+            if (!text_ids || std::ranges::binary_search(*text_ids, id)) {
+                visitId(id);
+            }
+        });
+        sink.finish();
+        return result;
+    }
+
+    // No id source is small enough: one pass over the columns, most selective filter first
+    result.source = QuerySource::Scan;
+    const auto& tasks = manager.getAllTasks();
+    result.candidates = tasks.size();
+    if (!manager.hasColumnarScans()) {
+        for (const Task& task : tasks) {
+            if (matchesFields(task)) sink.add(task);
+        }
+        sink.finish();
+        return result;
+    }
+
+    const TaskColumns& columns = manager.getColumns();
+    const TaskRows rows{tasks, &columns};
+    const bool status_first = status_count <= priority_count;
+    const bool category_first = matrix_usable && matrix_count < std::min(status_count, priority_count);
+    FieldInRange<TaskField::Status> status_range;
+    if (query.status) {
+        status_range.min = status_range.max = static_cast<std::int64_t>(*query.status);
+    }
+    const FieldInRange<TaskField::Priority> priority_range{.min = min_priority, .max = max_priority};
+    auto statusOk = [&](size_t slot) { return status_range(rows, slot); };
+    auto priorityOk = [&](size_t slot) { return priority_range(rows, slot); };
+    auto categoryOk = [&](size_t slot) {
+        return !category || columns.category[slot] == category->id();
+    };
+    for (size_t slot = 0; slot < tasks.size(); ++slot) {
+        if (category_first && !categoryOk(slot)) continue;
+        bool match = status_first ? statusOk(slot) && priorityOk(slot) : priorityOk(slot) && statusOk(slot);
+        if (match && (category_first || categoryOk(slot))) sink.add(tasks[slot]);
+    }
+    sink.finish();
+    return result;
+}
+
+std::string_view querySourceName(QuerySource source) {
+    switch (source) {
+        case QuerySource::Counters:      return "counters";
+        case QuerySource::Id:            return "id index";
+        case QuerySource::TextIndex:     return "text index";
+        case QuerySource::Matrix:        return "matrix";
+        case QuerySource::TextAndMatrix: return "text index ∩ matrix";
+        case QuerySource::Scan:          return "column scan";
+    }
+    return "unknown";
+}
@@ -0,0 +1,98 @@
+#ifndef TASK_QUERY_H
+#define TASK_QUERY_H
+
+/**
+ * @file task_query.h
+ * @brief Composable filters over a TaskManager, answered from its indexes
+ * @details A query is a conjunction of filters written as terms such as
+ *          `status=pending priority>=7 category=Work text~deploy sort=created
+ *          limit=20`. The planner uses the running counters to answer queries
+ *          that cannot match anything without touching a task, then takes its
+ *          candidates from the most selective id source available (the id
+ *          index, the text index and the category x priority matrix,
+ *          intersected when several apply) and falls back to one pass over the
+ *          hot columns. The remaining filters are checked per candidate.
+ *          Results are pointers into the manager; no Task is copied.
+ */
+
+#include "task.h"
+#include "task_manager.h"
+#include <expected>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @struct TaskQuery
+ * @brief Filters, order and page of a query; unset filters match every task
+ */
+struct TaskQuery {
+    std::optional<int> id;                  ///< Exact task id
+    std::optional<TaskStatus> status;       ///< Exact status
+    int min_priority = 0;                   ///< Lowest priority (inclusive)
+    int max_priority = 10;                  ///< Highest priority (inclusive)
+    std::optional<std::string> category;    ///< Exact category
+    std::string text;                       ///< findTasks query: terms are ANDed word prefixes
+    std::optional<TaskSortKey> sort;        ///< Order; collection order if unset
+    size_t offset = 0;                      ///< Matches to skip
+    size_t limit = std::numeric_limits<size_t>::max(); ///< Maximum matches to return
+};
+
+/**
+ * @enum QuerySource
+ * @brief Where a query took its candidate tasks from
+ */
+enum class QuerySource {
+    Counters,       ///< Counters showed nothing can match
+    Id,             ///< The id index (id=N)
+    TextIndex,      ///< The inverted text index
+    Matrix,         ///< The category x priority matrix
+    TextAndMatrix,  ///< Matrix buckets, kept if in the (larger) text index result
+    Scan            ///< One pass over the hot columns
+};
+
+/**
+ * @struct QueryResult
+ * @brief One page of query matches
+ * @details The pointers are invalidated by addTask, removeTask and loading
+ */
+struct QueryResult {
+    std::vector<const Task*> tasks;         ///< Matches on the page, in order
+    size_t offset = 0;                      ///< Position of the first match on the page
+    size_t total = 0;                       ///< Number of matches overall
+    QuerySource source = QuerySource::Scan; ///< Candidate source the planner chose
+    size_t candidates = 0;                  ///< Tasks the filters were checked on
+};
+
+/**
+ * @brief Parse query terms
+ * @details Terms: id=N, status=S, priority=N / >=N / <=N / >N / <N with N in 0-10,
+ *          category=C, text~words (repeatable, ANDed), sort=priority|created|title|priority,created,
+ *          limit=N, offset=N
+ * @param terms One term per element
+ * @return Query, or a message describing the first invalid term
+ */
+std::expected<TaskQuery, std::string> parseTaskQuery(std::span<const std::string_view> terms);
+
+/**
+ * @brief Run a query
+ * @details Candidates come from the smallest id source, sized in O(buckets)
+ *          without listing it: the id index, the text index or the matrix
+ *          buckets of the category. A category covering more than 1/8 of the
+ *          tasks is scanned over the columns instead; every other filter is
+ *          checked on each candidate.
+ * @param manager Tasks to query
+ * @param query Filters, order and page
+ * @return Matches on the requested page plus the total count and plan
+ */
+QueryResult runTaskQuery(const TaskManager& manager, const TaskQuery& query);
+
+/**
+ * @brief Name of a candidate source for diagnostics
+ */
+std::string_view querySourceName(QuerySource source);
+
+#endif // TASK_QUERY_H
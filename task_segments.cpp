@@ -0,0 +1,161 @@
+/**
+ * @file task_segments.cpp
+ * @brief Segment and manifest files of the segmented layout
+ */
+
+#include "task_segments.h"
+#include "task_json.h"
+#include "task_journal.h"
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+namespace {
+
+/**
+ * @brief Write a file under a temporary name, sync it, then rename it over the target
+ * @tparam Fn Callable taking std::ostream&, returning false on failure
+ */
+template<typename Fn>
+JsonResult replaceFile(const std::filesystem::path& target, Fn&& write) {
+    std::filesystem::path temp = target;
+    temp += ".tmp";
+    try {
+        std::ofstream file(temp, std::ios::binary);
+        if (!file.is_open()) {
+            return std::unexpected(JsonError::FileNotFound);
+        }
+        bool ok = write(file);
+        file.close();
+        if (!ok || file.fail()) {
+            std::error_code ec;
+            std::filesystem::remove(temp, ec);
+            return std::unexpected(JsonError::WriteError);
+        }
+    } catch (const std::exception&) {
+        std::error_code ec;
+        std::filesystem::remove(temp, ec);
+        return std::unexpected(JsonError::WriteError);
+    }
+
+    // On disk before it takes the target's name, so the target is never a partial file
+    std::error_code ec;
+    if (auto synced = syncFileToDisk(temp.string()); !synced) {
+        std::filesystem::remove(temp, ec);
+        return synced;
+    }
+    std::filesystem::rename(temp, target, ec);
+    if (ec) {
+        return std::unexpected(JsonError::WriteError);
+    }
+    return true;
+}
+
+template<typename T>
+bool parseField(std::string_view text, T& value) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc{} && ptr == text.data() + text.size();
+}
+
+/**
+ * @brief Split "key value [value]" at single spaces
+ */
+std::string_view nextWord(std::string_view& line) {
+    size_t space = line.find(' ');
+    std::string_view word = line.substr(0, space);
+    line = space == std::string_view::npos ? std::string_view{} : line.substr(space + 1);
+    return word;
+}
+
+} // namespace
+
+std::string segmentFileName(size_t index, std::uint64_t generation) {
+    if (generation == 0) {
+        return std::format("segment-{:06}.json", index);
+    }
+    return std::format("segment-{:06}.{:06}.json", index, generation);
+}
+
+bool isSegmentFileName(std::string_view name) {
+    return name.starts_with("segment-") && (name.ends_with(".json") || name.ends_with(".json.tmp"));
+}
+
+JsonResult writeSegmentFile(const std::filesystem::path& directory, size_t index, std::uint64_t generation,
+                            std::span<const Task* const> tasks, int next_id) {
+    return replaceFile(directory / segmentFileName(index, generation), [&](std::ostream& file) {
+        TaskJsonWriter writer(file);
+        writer.beginDocument(next_id);
+        for (const Task* task : tasks) {
+            writer.writeDocumentTask(*task);
+        }
+        writer.endDocument();
+        return writer.flush();
+    });
+}
+
+JsonResult writeSegmentManifest(const std::filesystem::path& directory, const SegmentManifest& manifest) {
+    std::string text = std::format("tasktracker-segments 2\nnext_id {}\nsegment_size {}\ngeneration {}\n",
+                                   manifest.next_id, manifest.segment_size, manifest.generation);
+    for (const SegmentEntry& entry : manifest.segments) {
+        std::format_to(std::back_inserter(text), "segment {} {} {}\n", entry.index, entry.tasks, entry.generation);
+    }
+    return replaceFile(directory / SEGMENT_MANIFEST_NAME, [&](std::ostream& file) {
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return file.good();
+    });
+}
+
+std::expected<SegmentManifest, JsonError> readSegmentManifest(const std::filesystem::path& directory) {
+    std::ifstream file(directory / SEGMENT_MANIFEST_NAME, std::ios::binary);
+    if (!file.is_open()) {
+        return std::unexpected(JsonError::FileNotFound);
+    }
+
+    SegmentManifest manifest;
+    std::string line;
+    if (!std::getline(file, line) || (line != "tasktracker-segments 1" && line != "tasktracker-segments 2")) {
+        return std::unexpected(JsonError::InvalidFormat);
+    }
+    const bool versioned = line.back() == '2';
+    bool has_next_id = false;
+    bool has_generation = !versioned;
+    while (std::getline(file, line)) {
+        std::string_view rest = line;
+        std::string_view key = nextWord(rest);
+        bool ok;
+        if (key == "next_id") {
+            ok = parseField(rest, manifest.next_id);
+            has_next_id = true;
+        } else if (key == "segment_size") {
+            ok = parseField(rest, manifest.segment_size) && manifest.segment_size > 0;
+        } else if (key == "generation" && versioned) {
+            ok = parseField(rest, manifest.generation);
+            has_generation = true;
+        } else if (key == "segment") {
+            // Version 2 adds the generation that names the file
+            SegmentEntry entry;
+            ok = parseField(nextWord(rest), entry.index) &&
+                 parseField(versioned ? nextWord(rest) : rest, entry.tasks) &&
+                 (!versioned || (parseField(rest, entry.generation) && entry.generation > 0)) &&
+                 (manifest.segments.empty() || entry.index > manifest.segments.back().index);
+            manifest.segments.push_back(entry);
+        } else {
+            ok = key.empty();
+        }
+        if (!ok) {
+            return std::unexpected(JsonError::InvalidFormat);
+        }
+    }
+    if (!has_next_id || !has_generation || manifest.segment_size == 0) {
+        return std::unexpected(JsonError::InvalidFormat);
+    }
+    // A later save names its files after generation + 1; no listed file may use that name
+    for (const SegmentEntry& entry : manifest.segments) {
+        if (entry.generation > manifest.generation) {
+            return std::unexpected(JsonError::InvalidFormat);
+        }
+    }
+    return manifest;
+}
@@ -0,0 +1,115 @@
+#ifndef TASK_SEGMENTS_H
+#define TASK_SEGMENTS_H
+
+/**
+ * @file task_segments.h
+ * @brief Segmented on-disk layout: tasks sharded by id range plus a manifest
+ * @details A segment directory holds one JSON task document per id range
+ *          (`segment-000042.000007.json` holds ids [42 * size, 43 * size) as
+ *          written by save 7) and a text manifest listing the segments, their
+ *          task counts and the save that wrote each, plus the segment size, the
+ *          next id and the number of the last save:
+ *
+ *              tasktracker-segments 2
+ *              next_id 1000001
+ *              segment_size 1024
+ *              generation 7
+ *              segment 0 1023 7
+ *              segment 1 1024 3
+ *
+ *          Each segment is a complete task document, so `view` and `load` read
+ *          it directly. TaskManager tracks which segments changed since the
+ *          directory was last written and rewrites only those. A save never
+ *          overwrites a file the manifest lists: it writes its segments under
+ *          its own generation, then renames the new manifest into place, which
+ *          is the commit point, and only then deletes the files the manifest no
+ *          longer lists. A crash at any point leaves the previous save intact.
+ *          Version 1 manifests (no generations, `segment-000042.json`) still load.
+ */
+
+#include "task.h"
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Name of the manifest file inside a segment directory
+ */
+inline constexpr std::string_view SEGMENT_MANIFEST_NAME = "manifest";
+
+/**
+ * @struct SegmentEntry
+ * @brief One segment listed in the manifest
+ */
+struct SegmentEntry {
+    size_t index = 0;               ///< Segment number: ids [index * segment_size, (index + 1) * segment_size)
+    size_t tasks = 0;               ///< Number of tasks in the segment file
+    std::uint64_t generation = 0;   ///< Save that wrote the file; 0 for a version 1 file name
+};
+
+/**
+ * @struct SegmentManifest
+ * @brief Contents of a segment directory's manifest
+ */
+struct SegmentManifest {
+    int next_id = 1;                        ///< Next task id of the store
+    size_t segment_size = 0;                ///< Ids per segment
+    std::uint64_t generation = 0;           ///< Number of the save that wrote the manifest
+    std::vector<SegmentEntry> segments;     ///< Non-empty segments, ascending index
+};
+
+/**
+ * @struct SegmentSaveStats
+ * @brief What TaskManager::saveToSegments wrote
+ */
+struct SegmentSaveStats {
+    size_t written = 0;     ///< Segment files rewritten
+    size_t removed = 0;     ///< Files deleted after the manifest stopped listing them (replaced or emptied)
+    size_t segments = 0;    ///< Non-empty segments in the manifest
+};
+
+/**
+ * @brief File name of a segment
+ * @param index Segment number
+ * @param generation Save that wrote it
+ * @return e.g. "segment-000042.000007.json", or "segment-000042.json" for generation 0
+ */
+std::string segmentFileName(size_t index, std::uint64_t generation);
+
+/**
+ * @brief Whether a file name is one a segment directory's segments or their temporaries use
+ */
+bool isSegmentFileName(std::string_view name);
+
+/**
+ * @brief Write one segment as a task document under its generation's name
+ * @param directory Segment directory
+ * @param index Segment number
+ * @param generation Save writing it (SegmentManifest::generation of the new manifest)
+ * @param tasks Tasks of the segment, in the order to store them
+ * @param next_id Next id of the store, recorded in the document
+ * @return Success or error code
+ */
+JsonResult writeSegmentFile(const std::filesystem::path& directory, size_t index, std::uint64_t generation,
+                            std::span<const Task* const> tasks, int next_id);
+
+/**
+ * @brief Write the manifest, replacing the file atomically
+ * @param directory Segment directory
+ * @param manifest Manifest to write
+ * @return Success or error code
+ */
+JsonResult writeSegmentManifest(const std::filesystem::path& directory, const SegmentManifest& manifest);
+
+/**
+ * @brief Read the manifest of a segment directory
+ * @param directory Segment directory
+ * @return Manifest, FileNotFound if there is none, or InvalidFormat
+ */
+std::expected<SegmentManifest, JsonError> readSegmentManifest(const std::filesystem::path& directory);
+
+#endif // TASK_SEGMENTS_H
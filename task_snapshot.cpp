@@ -0,0 +1,174 @@
+/**
+ * @file task_snapshot.cpp
+ * @brief Implementation of the binary snapshot reader and writer
+ */
+
+#include "task_snapshot.h"
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+static_assert(std::is_trivially_copyable_v<SnapshotTaskRecord>);
+static_assert(std::is_trivially_copyable_v<SnapshotStringRef>);
+
+/**
+ * @class StringTable
+ * @brief Deduplicating string table used while writing a snapshot
+ * @details Views point into the tasks being saved, which stay alive for the write
+ */
+class StringTable {
+private:
+    std::unordered_map<std::string_view, std::uint32_t> _index;
+    std::vector<SnapshotStringRef> _refs;
+    std::uint64_t _blob_size = 0;
+    std::vector<std::string_view> _strings;
+
+public:
+    std::uint32_t intern(std::string_view str) {
+        auto [it, inserted] = _index.try_emplace(str, static_cast<std::uint32_t>(_refs.size()));
+        if (inserted) {
+            _refs.push_back({static_cast<std::uint32_t>(_blob_size), static_cast<std::uint32_t>(str.size())});
+            _strings.push_back(str);
+            _blob_size += str.size();
+        }
+        return it->second;
+    }
+
+    const std::vector<SnapshotStringRef>& refs() const { return _refs; }
+    const std::vector<std::string_view>& strings() const { return _strings; }
+    std::uint64_t blobSize() const { return _blob_size; }
+};
+
+template<typename T>
+void writeBytes(std::ofstream& file, const T* data, size_t count) {
+    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(sizeof(T) * count));
+}
+
+} // namespace
+
+JsonResult writeTaskSnapshot(const std::string& filename, std::span<const Task> tasks, int next_id) {
+    try {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return std::unexpected(JsonError::FileNotFound);
+        }
+
+        StringTable strings;
+        std::vector<SnapshotTaskRecord> records;
+        records.reserve(tasks.size());
+
+        for (const auto& task : tasks) {
+            const auto& metadata = task.getMetadata();
+            SnapshotTaskRecord record{};
+            record.id = task.getId();
+            record.status = static_cast<std::uint8_t>(task.getStatus());
+            record.priority = static_cast<std::uint8_t>(metadata.priority);
+            record.has_completed_at = metadata.completed_at.has_value() ? 1 : 0;
+            record.title = strings.intern(task.getTitle());
+            record.description = strings.intern(task.getDescription());
+            record.category = strings.intern(metadata.category.view());
+            record.created_at = timePointToTicks(metadata.created_at);
+            record.updated_at = timePointToTicks(metadata.updated_at);
+            record.completed_at = metadata.completed_at ? timePointToTicks(*metadata.completed_at) : 0;
+            records.push_back(record);
+        }
+
+        // Offsets are 32-bit; refuse to write a snapshot that cannot be read back
+        if (strings.blobSize() > UINT32_MAX || tasks.size() > UINT32_MAX) {
+            return std::unexpected(JsonError::WriteError);
+        }
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.endian_marker = SNAPSHOT_ENDIAN_MARKER;
+        header.next_id = next_id;
+        header.task_count = static_cast<std::uint32_t>(records.size());
+        header.string_count = static_cast<std::uint32_t>(strings.refs().size());
+        header.blob_size = strings.blobSize();
+
+        writeBytes(file, &header, 1);
+        writeBytes(file, records.data(), records.size());
+        writeBytes(file, strings.refs().data(), strings.refs().size());
+        for (auto str : strings.strings()) {
+            file.write(str.data(), static_cast<std::streamsize>(str.size()));
+        }
+
+        file.flush();
+        if (file.fail()) {
+            return std::unexpected(JsonError::WriteError);
+        }
+        return true;
+    } catch (const std::exception&) {
+        return std::unexpected(JsonError::WriteError);
+    }
+}
+
+std::expected<int, JsonError> readTaskSnapshot(std::string_view data, std::vector<Task>& tasks) {
+    SnapshotHeader header;
+    if (data.size() < sizeof(header)) {
+        return std::unexpected(JsonError::InvalidFormat);
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SNAPSHOT_VERSION ||
+        header.endian_marker != SNAPSHOT_ENDIAN_MARKER) {
+        return std::unexpected(JsonError::InvalidFormat);
+    }
+
+    const std::uint64_t records_offset = sizeof(SnapshotHeader);
+    const std::uint64_t refs_offset = records_offset + std::uint64_t{header.task_count} * sizeof(SnapshotTaskRecord);
+    const std::uint64_t blob_offset = refs_offset + std::uint64_t{header.string_count} * sizeof(SnapshotStringRef);
+    if (blob_offset + header.blob_size != data.size()) {
+        return std::unexpected(JsonError::InvalidFormat);
+    }
+
+    // Resolve the string table once; records then refer to it by index
+    std::string_view blob = data.substr(blob_offset);
+    std::vector<std::string_view> strings(header.string_count);
+    for (std::uint32_t i = 0; i < header.string_count; ++i) {
+        SnapshotStringRef ref;
+        std::memcpy(&ref, data.data() + refs_offset + i * sizeof(SnapshotStringRef), sizeof(ref));
+        if (std::uint64_t{ref.offset} + ref.length > blob.size()) {
+            return std::unexpected(JsonError::InvalidFormat);
+        }
+        strings[i] = blob.substr(ref.offset, ref.length);
+    }
+
+    tasks.reserve(tasks.size() + header.task_count);
+    for (std::uint32_t i = 0; i < header.task_count; ++i) {
+        SnapshotTaskRecord record;
+        std::memcpy(&record, data.data() + records_offset + i * sizeof(SnapshotTaskRecord), sizeof(record));
+
+        if (record.status > static_cast<std::uint8_t>(TaskStatus::Cancelled) ||
+            record.priority > 10 ||
+            record.title >= strings.size() ||
+            record.description >= strings.size() ||
+            record.category >= strings.size()) {
+            return std::unexpected(JsonError::InvalidFormat);
+        }
+
+        Task task(record.id,
+                  std::string(strings[record.title]),
+                  std::string(strings[record.description]),
+                  static_cast<TaskStatus>(record.status));
+
+        auto& metadata = task.getMetadata();
+        metadata.category = strings[record.category];
+        metadata.priority = record.priority;
+        metadata.created_at = ticksToTimePoint(record.created_at);
+        metadata.updated_at = ticksToTimePoint(record.updated_at);
+        if (record.has_completed_at) {
+            metadata.completed_at = ticksToTimePoint(record.completed_at);
+        }
+
+        tasks.push_back(std::move(task));
+    }
+
+    return header.next_id;
+}
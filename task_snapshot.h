@@ -0,0 +1,120 @@
+#ifndef TASK_SNAPSHOT_H
+#define TASK_SNAPSHOT_H
+
+/**
+ * @file task_snapshot.h
+ * @brief Versioned binary snapshot format for fast cold starts
+ * @details Layout (all integers little-endian, native width):
+ *          - SnapshotHeader
+ *          - task_count fixed-width SnapshotTaskRecord entries
+ *          - string_count SnapshotStringRef entries (offset, length into the blob)
+ *          - the string blob (titles, descriptions and categories, deduplicated)
+ *          Timestamps are stored as int64 nanoseconds since the Unix epoch, so
+ *          loading never touches the calendar/locale machinery. JSON remains the
+ *          interchange format; snapshots are a cache for restarts.
+ */
+
+#include "task.h"
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <expected>
+
+/**
+ * @brief Magic bytes at the start of every snapshot file
+ */
+inline constexpr char SNAPSHOT_MAGIC[8] = {'T', 'T', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+/**
+ * @brief Current snapshot format version
+ */
+inline constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+
+/**
+ * @brief Marker written in native byte order to detect endianness mismatches
+ */
+inline constexpr std::uint32_t SNAPSHOT_ENDIAN_MARKER = 0x01020304u;
+
+/**
+ * @struct SnapshotHeader
+ * @brief Fixed-size file header
+ */
+struct SnapshotHeader {
+    char magic[8];                  ///< SNAPSHOT_MAGIC
+    std::uint32_t version;          ///< SNAPSHOT_VERSION
+    std::uint32_t endian_marker;    ///< SNAPSHOT_ENDIAN_MARKER
+    std::int32_t next_id;           ///< TaskManager next id
+    std::uint32_t task_count;       ///< Number of task records
+    std::uint32_t string_count;     ///< Number of string table entries
+    std::uint32_t reserved;         ///< Always 0
+    std::uint64_t blob_size;        ///< Size of the string blob in bytes
+};
+
+/**
+ * @struct SnapshotTaskRecord
+ * @brief Fixed-width on-disk representation of one task
+ */
+struct SnapshotTaskRecord {
+    std::int32_t id;                ///< Task ID
+    std::uint8_t status;            ///< TaskStatus value
+    std::uint8_t priority;          ///< Priority 0-10
+    std::uint8_t has_completed_at;  ///< 1 if completed_at is valid
+    std::uint8_t reserved;          ///< Always 0
+    std::uint32_t title;            ///< String table index
+    std::uint32_t description;      ///< String table index
+    std::uint32_t category;         ///< String table index
+    std::uint32_t padding;          ///< Always 0
+    std::int64_t created_at;        ///< Nanoseconds since epoch
+    std::int64_t updated_at;        ///< Nanoseconds since epoch
+    std::int64_t completed_at;      ///< Nanoseconds since epoch (0 if absent)
+};
+
+/**
+ * @struct SnapshotStringRef
+ * @brief Location of one string inside the blob
+ */
+struct SnapshotStringRef {
+    std::uint32_t offset;   ///< Byte offset into the blob
+    std::uint32_t length;   ///< Length in bytes
+};
+
+static_assert(sizeof(SnapshotHeader) == 40, "SnapshotHeader layout changed");
+static_assert(sizeof(SnapshotTaskRecord) == 48, "SnapshotTaskRecord layout changed");
+static_assert(sizeof(SnapshotStringRef) == 8, "SnapshotStringRef layout changed");
+
+/**
+ * @brief Convert a time point to the on-disk tick count (nanoseconds since epoch)
+ */
+inline std::int64_t timePointToTicks(std::chrono::system_clock::time_point tp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+/**
+ * @brief Convert an on-disk tick count back to a time point
+ */
+inline std::chrono::system_clock::time_point ticksToTimePoint(std::int64_t ticks) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ticks)));
+}
+
+/**
+ * @brief Write tasks to a binary snapshot file
+ * @param filename Path of the file to write
+ * @param tasks Tasks to store
+ * @param next_id Next task ID to record
+ * @return Success, FileNotFound if the file cannot be created, WriteError otherwise
+ */
+JsonResult writeTaskSnapshot(const std::string& filename, std::span<const Task> tasks, int next_id);
+
+/**
+ * @brief Decode a binary snapshot
+ * @param data Complete snapshot contents
+ * @param tasks Receives the decoded tasks
+ * @return The stored next_id, or InvalidFormat if the data is malformed
+ */
+std::expected<int, JsonError> readTaskSnapshot(std::string_view data, std::vector<Task>& tasks);
+
+#endif // TASK_SNAPSHOT_H
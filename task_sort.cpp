@@ -0,0 +1,60 @@
+/**
+ * @file task_sort.cpp
+ * @brief Radix sort behind radixSortSlots, and sort key names
+ */
+
+#include "task_sort.h"
+#include <array>
+
+namespace task_sort_detail {
+
+void radixSortPacked(std::span<size_t> slots, std::span<std::uint64_t> keys, unsigned key_bits) {
+    constexpr unsigned DIGIT_BITS = 8;
+    constexpr size_t BUCKETS = 1uz << DIGIT_BITS;
+
+    const size_t count = slots.size();
+    std::vector<size_t> slot_buffer(count);
+    std::vector<std::uint64_t> key_buffer(count);
+    std::span<size_t> slots_in = slots, slots_out = slot_buffer;
+    std::span<std::uint64_t> keys_in = keys, keys_out = key_buffer;
+
+    for (unsigned shift = 0; shift < key_bits; shift += DIGIT_BITS) {
+        std::array<size_t, BUCKETS> offsets{};
+        for (std::uint64_t key : keys_in) {
+            ++offsets[(key >> shift) & (BUCKETS - 1)];
+        }
+        // Every key shares this digit: the pass would not move anything
+        if (std::ranges::find(offsets, count) != offsets.end()) {
+            continue;
+        }
+        size_t position = 0;
+        for (size_t& offset : offsets) {
+            size_t bucket_size = offset;
+            offset = position;
+            position += bucket_size;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            size_t target = offsets[(keys_in[i] >> shift) & (BUCKETS - 1)]++;
+            slots_out[target] = slots_in[i];
+            keys_out[target] = keys_in[i];
+        }
+        std::swap(slots_in, slots_out);
+        std::swap(keys_in, keys_out);
+    }
+
+    // An odd number of passes left the result in the buffers
+    if (slots_in.data() != slots.data()) {
+        std::ranges::copy(slots_in, slots.begin());
+        std::ranges::copy(keys_in, keys.begin());
+    }
+}
+
+} // namespace task_sort_detail
+
+std::optional<TaskSortKey> stringToTaskSortKey(std::string_view text) {
+    if (text == "priority") return TaskSortKey::Priority;
+    if (text == "created") return TaskSortKey::Created;
+    if (text == "title") return TaskSortKey::Title;
+    if (text == "priority,created") return TaskSortKey::PriorityCreated;
+    return std::nullopt;
+}
@@ -0,0 +1,413 @@
+#ifndef TASK_SORT_H
+#define TASK_SORT_H
+
+/**
+ * @file task_sort.h
+ * @brief Compile-time composed comparators and predicates over task fields
+ * @details An order such as `SortBy<TaskField::Priority, SortDir::Desc,
+ *          TaskField::Created, SortDir::Desc>` is a type: its comparison is
+ *          instantiated per field list, so there is no runtime dispatch on the
+ *          criteria, and consecutive numeric keys fold into one sign without
+ *          branching. The same order compares Task objects or TaskManager
+ *          slots, reading slots from the hot columns when they exist.
+ *          Orders over numeric fields can also be packed into one 64-bit key
+ *          per slot and radix sorted, which beats comparison sorting on large
+ *          sets.
+ */
+
+#include "task.h"
+#include "task_columns.h"
+#include "task_snapshot.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @enum TaskSortKey
+ * @brief Orders offered by TaskManager::getSortedPage
+ */
+enum class TaskSortKey {
+    Priority,           ///< Highest priority first
+    Created,            ///< Newest first
+    Title,              ///< Alphabetical
+    PriorityCreated     ///< Highest priority first, newest first within a priority
+};
+
+/**
+ * @enum TaskField
+ * @brief Task fields that orders and predicates can be built over
+ */
+enum class TaskField {
+    Id,
+    Status,
+    Priority,
+    Created,
+    Updated,
+    Title
+};
+
+/**
+ * @enum SortDir
+ * @brief Direction of one sort key
+ */
+enum class SortDir {
+    Asc,
+    Desc
+};
+
+/**
+ * @struct TaskRows
+ * @brief Tasks addressed by TaskManager slot, with their hot columns if maintained
+ */
+struct TaskRows {
+    std::span<const Task> tasks;            ///< Tasks by slot
+    const TaskColumns* columns = nullptr;   ///< Hot columns parallel to tasks, or nullptr
+};
+
+/**
+ * @brief Per-field access for orders and predicates
+ * @details value() reads a Task, column() reads a slot of the hot columns.
+ *          bits is the width of the field in a packed key; 0 means the width
+ *          depends on the range of values (ids, timestamps). packable is false for
+ *          fields that cannot go in a packed key.
+ */
+template<TaskField F>
+struct TaskFieldTraits;
+
+template<>
+struct TaskFieldTraits<TaskField::Id> {
+    static constexpr bool columnar = true;
+    static constexpr bool packable = true;
+    static constexpr unsigned bits = 0;
+    static std::int64_t value(const Task& task) { return task.getId(); }
+    static std::int64_t column(const TaskColumns& columns, size_t slot) { return columns.id[slot]; }
+};
+
+template<>
+struct TaskFieldTraits<TaskField::Status> {
+    static constexpr bool columnar = true;
+    static constexpr bool packable = true;
+    static constexpr unsigned bits = 2;
+    static std::int64_t value(const Task& task) { return static_cast<std::int64_t>(task.getStatus()); }
+    static std::int64_t column(const TaskColumns& columns, size_t slot) { return columns.status[slot]; }
+};
+
+template<>
+struct TaskFieldTraits<TaskField::Priority> {
+    static constexpr bool columnar = true;
+    static constexpr bool packable = true;
+    static constexpr unsigned bits = 4;
+    static std::int64_t value(const Task& task) { return task.getMetadata().priority; }
+    static std::int64_t column(const TaskColumns& columns, size_t slot) { return columns.priority[slot]; }
+};
+
+template<>
+struct TaskFieldTraits<TaskField::Created> {
+    static constexpr bool columnar = true;
+    static constexpr bool packable = true;
+    static constexpr unsigned bits = 0;
+    static std::int64_t value(const Task& task) { return timePointToTicks(task.getMetadata().created_at); }
+    static std::int64_t column(const TaskColumns& columns, size_t slot) { return columns.created_at[slot]; }
+};
+
+template<>
+struct TaskFieldTraits<TaskField::Updated> {
+    static constexpr bool columnar = true;
+    static constexpr bool packable = true;
+    static constexpr unsigned bits = 0;
+    static std::int64_t value(const Task& task) { return timePointToTicks(task.getMetadata().updated_at); }
+    static std::int64_t column(const TaskColumns& columns, size_t slot) { return columns.updated_at[slot]; }
+};
+
+template<>
+struct TaskFieldTraits<TaskField::Title> {
+    static constexpr bool columnar = false;
+    static constexpr bool packable = false;
+    static constexpr unsigned bits = 0;
+    static std::string_view value(const Task& task) { return task.getTitle(); }
+};
+
+/**
+ * @brief Value of a field in a slot, from the hot columns when possible
+ */
+template<TaskField F>
+auto fieldAt(const TaskRows& rows, size_t slot) {
+    if constexpr (TaskFieldTraits<F>::columnar) {
+        if (rows.columns) {
+            return TaskFieldTraits<F>::column(*rows.columns, slot);
+        }
+    }
+    return TaskFieldTraits<F>::value(rows.tasks[slot]);
+}
+
+namespace task_sort_detail {
+
+/**
+ * @brief Three-way sign of one key: -1, 0 or 1, negated for descending keys
+ */
+template<SortDir D, typename T>
+int compareValues(const T& a, const T& b) {
+    int sign;
+    if constexpr (std::is_same_v<T, std::string_view>) {
+        int c = a.compare(b);
+        sign = (c > 0) - (c < 0);
+    } else {
+        sign = (a > b) - (a < b);
+    }
+    return D == SortDir::Asc ? sign : -sign;
+}
+
+/**
+ * @brief Lexicographic combination of a leading sign and the sign of the rest
+ */
+inline int combine(int first, int rest) {
+    int r = 2 * first + rest;
+    return (r > 0) - (r < 0);
+}
+
+/**
+ * @brief Map a value to an unsigned key whose ascending order matches the key direction
+ */
+template<SortDir D>
+std::uint64_t orderedBits(std::uint64_t offset, std::uint64_t range) {
+    return D == SortDir::Asc ? offset : range - offset;
+}
+
+/**
+ * @brief Radix sort slots by packed keys, carrying the keys along
+ * @details LSD, 8 bits per pass over the low key_bits bits; passes in which
+ *          every key has the same digit are skipped. Stable.
+ * @param slots Slots to reorder
+ * @param keys Packed key of each entry of slots, reordered with it
+ * @param key_bits Number of significant low bits in the keys
+ */
+void radixSortPacked(std::span<size_t> slots, std::span<std::uint64_t> keys, unsigned key_bits);
+
+} // namespace task_sort_detail
+
+/**
+ * @brief An order over task fields: pairs of TaskField and SortDir, most significant first
+ * @details Ties on every key are broken by id, so each order is total and
+ *          matches between whichever path (Task, columns, packed key) sorts.
+ *          Example: SortBy<TaskField::Priority, SortDir::Desc, TaskField::Title, SortDir::Asc>
+ */
+template<auto... Spec>
+struct SortBy;
+
+template<>
+struct SortBy<> {
+    static constexpr size_t key_count = 0;
+    static constexpr bool numeric = true;
+    static constexpr bool packable = true;
+    static constexpr bool ends_with_id = false;
+
+    static int compare(const Task&, const Task&) { return 0; }
+    static int compare(const TaskRows&, size_t, size_t) { return 0; }
+};
+
+template<TaskField F, SortDir D, auto... Rest>
+struct SortBy<F, D, Rest...> {
+private:
+    using Traits = TaskFieldTraits<F>;
+    using Next = SortBy<Rest...>;
+
+public:
+    static constexpr size_t key_count = 1 + Next::key_count;
+    /// Every key is a number, so all keys are compared without branching
+    static constexpr bool numeric = F != TaskField::Title && Next::numeric;
+    /// Every key fits in a packed key (whether they fit together is checked at runtime)
+    static constexpr bool packable = Traits::packable && Next::packable;
+    /// The last key is the id, so the order needs no tie-break
+    static constexpr bool ends_with_id = key_count == 1 ? F == TaskField::Id : Next::ends_with_id;
+
+    /**
+     * @brief Three-way comparison of two tasks on the keys, without the id tie-break
+     */
+    static int compare(const Task& a, const Task& b) {
+        int first = task_sort_detail::compareValues<D>(Traits::value(a), Traits::value(b));
+        if constexpr (numeric) {
+            return task_sort_detail::combine(first, Next::compare(a, b));
+        } else {
+            return first != 0 ? first : Next::compare(a, b);
+        }
+    }
+
+    /**
+     * @brief Three-way comparison of two slots on the keys, without the id tie-break
+     */
+    static int compare(const TaskRows& rows, size_t a, size_t b) {
+        int first = task_sort_detail::compareValues<D>(fieldAt<F>(rows, a), fieldAt<F>(rows, b));
+        if constexpr (numeric) {
+            return task_sort_detail::combine(first, Next::compare(rows, a, b));
+        } else {
+            return first != 0 ? first : Next::compare(rows, a, b);
+        }
+    }
+
+    /**
+     * @brief Strict weak order on tasks, ties broken by id
+     */
+    bool operator()(const Task& a, const Task& b) const {
+        return task_sort_detail::combine(compare(a, b), (a.getId() > b.getId()) - (a.getId() < b.getId())) < 0;
+    }
+
+    /**
+     * @brief Strict weak order on the slots of rows, ties broken by id
+     */
+    static auto slotOrder(const TaskRows& rows) {
+        return [rows](size_t a, size_t b) {
+            int ids = task_sort_detail::compareValues<SortDir::Asc>(
+                fieldAt<TaskField::Id>(rows, a), fieldAt<TaskField::Id>(rows, b));
+            return task_sort_detail::combine(compare(rows, a, b), ids) < 0;
+        };
+    }
+
+    /**
+     * @brief Pack the keys of slots into one unsigned integer per slot
+     * @details Fixed-width fields keep their width; ids and timestamps take
+     *          the bit width of their range over the slots. Descending keys
+     *          are complemented within their range, so ascending key order is
+     *          the order of this SortBy.
+     * @param rows Tasks and columns
+     * @param slots Slots to pack
+     * @param keys Receives one key per slot
+     * @return Number of significant low bits, or nullopt if the keys do not fit in 64 bits
+     */
+    static std::optional<unsigned> packKeys(const TaskRows& rows, std::span<const size_t> slots,
+                                            std::vector<std::uint64_t>& keys)
+        requires packable
+    {
+        keys.assign(slots.size(), 0);
+        return packInto(rows, slots, keys, 0);
+    }
+
+    /// @cond INTERNAL
+    static std::optional<unsigned> packInto(const TaskRows& rows, std::span<const size_t> slots,
+                                            std::vector<std::uint64_t>& keys, unsigned used) {
+        std::int64_t low = 0;
+        std::uint64_t range = 0;
+        unsigned width = Traits::bits;
+        if constexpr (Traits::bits == 0) {
+            std::int64_t high = 0;
+            for (size_t i = 0; i < slots.size(); ++i) {
+                std::int64_t value = fieldAt<F>(rows, slots[i]);
+                low = i == 0 ? value : std::min(low, value);
+                high = i == 0 ? value : std::max(high, value);
+            }
+            range = static_cast<std::uint64_t>(high) - static_cast<std::uint64_t>(low);
+            width = static_cast<unsigned>(std::bit_width(range));
+        } else {
+            range = (std::uint64_t{1} << width) - 1;
+        }
+        if (used + width > 64) {
+            return std::nullopt;
+        }
+        for (size_t i = 0; i < slots.size(); ++i) {
+            auto offset = static_cast<std::uint64_t>(fieldAt<F>(rows, slots[i])) - static_cast<std::uint64_t>(low);
+            std::uint64_t shifted = width == 64 ? 0 : keys[i] << width;
+            keys[i] = shifted | task_sort_detail::orderedBits<D>(offset, range);
+        }
+        if constexpr (Next::key_count == 0) {
+            return used + width;
+        } else {
+            return Next::packInto(rows, slots, keys, used + width);
+        }
+    }
+    /// @endcond
+};
+
+/**
+ * @brief Sort slots by an order through packed keys and radix sort
+ * @details Equal packed keys are put in id order afterwards, so the result
+ *          equals sorting with Order::slotOrder(rows)
+ * @tparam Order A packable SortBy
+ * @param rows Tasks and columns
+ * @param slots Slots to sort in place
+ * @return false (slots untouched) if the keys do not fit in 64 bits
+ */
+template<typename Order>
+requires Order::packable
+bool radixSortSlots(const TaskRows& rows, std::span<size_t> slots) {
+    std::vector<std::uint64_t> keys;
+    auto bits = Order::packKeys(rows, slots, keys);
+    if (!bits) {
+        return false;
+    }
+    task_sort_detail::radixSortPacked(slots, keys, *bits);
+
+    if constexpr (!Order::ends_with_id) {
+        auto by_id = [&](size_t a, size_t b) {
+            return fieldAt<TaskField::Id>(rows, a) < fieldAt<TaskField::Id>(rows, b);
+        };
+        for (size_t begin = 0; begin < slots.size();) {
+            size_t end = begin + 1;
+            while (end < slots.size() && keys[end] == keys[begin]) ++end;
+            if (end - begin > 1) {
+                std::sort(slots.begin() + begin, slots.begin() + end, by_id);
+            }
+            begin = end;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Predicate: a numeric field lies in [min, max]
+ * @details Equality is min == max; one-sided bounds use the limits of int64
+ */
+template<TaskField F>
+requires (F != TaskField::Title)
+struct FieldInRange {
+    std::int64_t min = std::numeric_limits<std::int64_t>::min();
+    std::int64_t max = std::numeric_limits<std::int64_t>::max();
+
+    bool operator()(const Task& task) const {
+        auto value = TaskFieldTraits<F>::value(task);
+        return value >= min && value <= max;
+    }
+
+    bool operator()(const TaskRows& rows, size_t slot) const {
+        auto value = fieldAt<F>(rows, slot);
+        return value >= min && value <= max;
+    }
+};
+
+/**
+ * @brief The SortBy type behind each TaskSortKey
+ */
+using PrioritySort = SortBy<TaskField::Priority, SortDir::Desc>;
+using CreatedSort = SortBy<TaskField::Created, SortDir::Desc>;
+using TitleSort = SortBy<TaskField::Title, SortDir::Asc>;
+using PriorityCreatedSort = SortBy<TaskField::Priority, SortDir::Desc, TaskField::Created, SortDir::Desc>;
+
+/**
+ * @brief Call fn with the SortBy object for a runtime sort key
+ * @details The one place a runtime key is turned into an order type; fn is
+ *          instantiated once per order, so comparisons inside it are static
+ * @param key Sort key
+ * @param fn Callable taking any SortBy by value
+ * @return What fn returns
+ */
+template<typename Fn>
+decltype(auto) withSortOrder(TaskSortKey key, Fn&& fn) {
+    switch (key) {
+        case TaskSortKey::Priority:        return fn(PrioritySort{});
+        case TaskSortKey::Created:         return fn(CreatedSort{});
+        case TaskSortKey::Title:           return fn(TitleSort{});
+        case TaskSortKey::PriorityCreated: break;
+    }
+    return fn(PriorityCreatedSort{});
+}
+
+/**
+ * @brief Parse a sort key name: priority, created, title or priority,created
+ */
+std::optional<TaskSortKey> stringToTaskSortKey(std::string_view text);
+
+#endif // TASK_SORT_H
@@ -0,0 +1,114 @@
+/**
+ * @file text_index.cpp
+ * @brief Implementation of TextIndex
+ */
+
+#include "text_index.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+bool isTokenByte(unsigned char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+}
+
+char foldByte(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : static_cast<char>(c);
+}
+
+} // namespace
+
+void TextIndex::tokenize(std::string_view text, std::vector<std::string>& out) {
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !isTokenByte(static_cast<unsigned char>(text[i]))) ++i;
+        if (i == text.size()) break;
+
+        std::string& token = out.emplace_back();
+        while (i < text.size() && isTokenByte(static_cast<unsigned char>(text[i]))) {
+            token += foldByte(static_cast<unsigned char>(text[i]));
+            ++i;
+        }
+    }
+}
+
+void TextIndex::collectTokens(std::string_view title, std::string_view description) {
+    _scratch.clear();
+    tokenize(title, _scratch);
+    tokenize(description, _scratch);
+    std::ranges::sort(_scratch);
+    auto [first, last] = std::ranges::unique(_scratch);
+    _scratch.erase(first, last);
+}
+
+void TextIndex::add(int id, std::string_view title, std::string_view description) {
+    collectTokens(title, description);
+    for (auto& token : _scratch) {
+        // Ids grow monotonically, so this is an append in the common case
+        auto& ids = _postings.try_emplace(std::move(token)).first->second;
+        if (ids.empty() || ids.back() < id) {
+            ids.push_back(id);
+        } else if (auto pos = std::ranges::lower_bound(ids, id); pos == ids.end() || *pos != id) {
+            ids.insert(pos, id);
+        }
+    }
+}
+
+void TextIndex::remove(int id, std::string_view title, std::string_view description) {
+    collectTokens(title, description);
+    for (const auto& token : _scratch) {
+        auto it = _postings.find(token);
+        if (it == _postings.end()) continue;
+
+        auto& ids = it->second;
+        if (auto pos = std::ranges::lower_bound(ids, id); pos != ids.end() && *pos == id) {
+            ids.erase(pos);
+        }
+        if (ids.empty()) {
+            _postings.erase(it);
+        }
+    }
+}
+
+std::vector<int> TextIndex::matchPrefix(std::string_view prefix) const {
+    auto first = _postings.lower_bound(prefix);
+    auto last = first;
+    size_t matched = 0;
+    while (last != _postings.end() && std::string_view(last->first).starts_with(prefix)) {
+        ++last;
+        ++matched;
+    }
+
+    if (matched == 1) {
+        return first->second;
+    }
+
+    std::vector<int> ids;
+    for (auto it = first; it != last; ++it) {
+        ids.insert(ids.end(), it->second.begin(), it->second.end());
+    }
+    std::ranges::sort(ids);
+    auto [dup_first, dup_last] = std::ranges::unique(ids);
+    ids.erase(dup_first, dup_last);
+    return ids;
+}
+
+std::vector<int> TextIndex::search(const std::vector<std::string>& terms) const {
+    std::vector<int> result;
+    bool first_term = true;
+    std::vector<int> intersection;
+    for (const auto& term : terms) {
+        auto ids = matchPrefix(term);
+        if (first_term) {
+            result = std::move(ids);
+            first_term = false;
+        } else {
+            intersection.clear();
+            std::ranges::set_intersection(result, ids, std::back_inserter(intersection));
+            result.swap(intersection);
+        }
+        if (result.empty()) break;
+    }
+    return result;
+}
@@ -0,0 +1,83 @@
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+
+/**
+ * @file text_index.h
+ * @brief Inverted token index over task titles and descriptions
+ * @details Text is split into tokens of ASCII letters/digits and non-ASCII bytes
+ *          (so UTF-8 words stay whole); ASCII letters are folded to lower case.
+ *          Each token maps to the sorted ids of the tasks containing it, and the
+ *          ordered map lets a query term match every token it is a prefix of.
+ */
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class TextIndex
+ * @brief Token -> sorted task id postings with prefix and multi-term AND queries
+ */
+class TextIndex {
+private:
+    std::map<std::string, std::vector<int>, std::less<>> _postings; ///< Sorted ids per token
+    std::vector<std::string> _scratch;  ///< Reused token buffer for add/remove
+
+    /**
+     * @brief Collect the distinct tokens of a task into _scratch
+     */
+    void collectTokens(std::string_view title, std::string_view description);
+
+    /**
+     * @brief Ids of all tasks with a token starting with prefix
+     * @param prefix Folded token prefix
+     * @return Sorted, duplicate-free ids
+     */
+    std::vector<int> matchPrefix(std::string_view prefix) const;
+
+public:
+    /**
+     * @brief Split text into folded tokens
+     * @param text Text to split
+     * @param out Receives the tokens (appended)
+     */
+    static void tokenize(std::string_view text, std::vector<std::string>& out);
+
+    /**
+     * @brief Index a task
+     * @param id Task ID
+     * @param title Task title
+     * @param description Task description
+     */
+    void add(int id, std::string_view title, std::string_view description);
+
+    /**
+     * @brief Remove a task that was indexed with exactly this text
+     * @param id Task ID
+     * @param title Title the task was indexed with
+     * @param description Description the task was indexed with
+     */
+    void remove(int id, std::string_view title, std::string_view description);
+
+    /**
+     * @brief Find tasks matching every term of a query
+     * @details Each search term matches tokens it is a prefix of; terms are ANDed.
+     *          Callers handle terms that have no tokens (pure punctuation).
+     * @param terms Folded token prefixes
+     * @return Sorted ids of matching tasks
+     */
+    std::vector<int> search(const std::vector<std::string>& terms) const;
+
+    /**
+     * @brief Remove every posting
+     */
+    void clear() { _postings.clear(); }
+
+    /**
+     * @brief Number of distinct tokens in the index
+     */
+    size_t tokenCount() const { return _postings.size(); }
+};
+
+#endif // TEXT_INDEX_H
@@ -0,0 +1,197 @@
+/**
+ * @file time_index.cpp
+ * @brief Implementation of TimeIndex
+ */
+
+#include "time_index.h"
+#include "task_snapshot.h"
+#include <algorithm>
+
+size_t TimeIndex::SortedRun::blockFor(const Entry& entry) const {
+    // First block starting after the entry; the one before it holds the entry's place
+    auto it = std::upper_bound(_blocks.begin(), _blocks.end(), entry,
+                               [](const Entry& value, const std::vector<Entry>& block) { return value < block.front(); });
+    return it == _blocks.begin() ? 0 : static_cast<size_t>(it - _blocks.begin()) - 1;
+}
+
+std::pair<size_t, size_t> TimeIndex::SortedRun::lowerBound(std::int64_t ticks) const {
+    if (_blocks.empty()) {
+        return {0, 0};
+    }
+    const Entry first{ticks, std::numeric_limits<int>::min()};
+    size_t block = blockFor(first);
+    const auto& entries = _blocks[block];
+    size_t offset = static_cast<size_t>(std::lower_bound(entries.begin(), entries.end(), first) - entries.begin());
+    if (offset == entries.size()) {
+        return {block + 1, 0};
+    }
+    return {block, offset};
+}
+
+void TimeIndex::SortedRun::insert(const Entry& entry) {
+    ++_size;
+    if (_blocks.empty()) {
+        _blocks.emplace_back().reserve(2 * BLOCK_SIZE);
+        _blocks.front().push_back(entry);
+        return;
+    }
+
+    size_t block = blockFor(entry);
+    auto& entries = _blocks[block];
+    entries.insert(std::upper_bound(entries.begin(), entries.end(), entry), entry);
+    if (entries.size() <= 2 * BLOCK_SIZE) {
+        return;
+    }
+
+    // Split a full block in two; the block list itself is small
+    std::vector<Entry> upper;
+    upper.reserve(2 * BLOCK_SIZE);
+    upper.assign(entries.begin() + BLOCK_SIZE, entries.end());
+    entries.resize(BLOCK_SIZE);
+    _blocks.insert(_blocks.begin() + static_cast<std::ptrdiff_t>(block) + 1, std::move(upper));
+}
+
+bool TimeIndex::SortedRun::erase(const Entry& entry) {
+    if (_blocks.empty()) {
+        return false;
+    }
+    size_t block = blockFor(entry);
+    auto& entries = _blocks[block];
+    auto it = std::lower_bound(entries.begin(), entries.end(), entry);
+    if (it == entries.end() || *it != entry) {
+        return false;
+    }
+
+    entries.erase(it);
+    --_size;
+    if (entries.empty()) {
+        _blocks.erase(_blocks.begin() + static_cast<std::ptrdiff_t>(block));
+    }
+    return true;
+}
+
+void TimeIndex::SortedRun::assign(std::span<const Entry> sorted) {
+    clear();
+    _blocks.reserve(sorted.size() / BLOCK_SIZE + 1);
+    for (size_t first = 0; first < sorted.size(); first += BLOCK_SIZE) {
+        auto& entries = _blocks.emplace_back();
+        entries.reserve(2 * BLOCK_SIZE);
+        auto chunk = sorted.subspan(first, std::min(BLOCK_SIZE, sorted.size() - first));
+        entries.assign(chunk.begin(), chunk.end());
+    }
+    _size = sorted.size();
+}
+
+size_t TimeIndex::SortedRun::count(std::int64_t from, std::int64_t to) const {
+    if (from >= to) {
+        return 0;
+    }
+    auto [first_block, first_offset] = lowerBound(from);
+    auto [last_block, last_offset] = lowerBound(to);
+    if (first_block == last_block) {
+        return last_offset - first_offset;
+    }
+
+    // Whole blocks in between are counted by size
+    size_t total = _blocks[first_block].size() - first_offset;
+    for (size_t block = first_block + 1; block < last_block; ++block) {
+        total += _blocks[block].size();
+    }
+    return total + last_offset;
+}
+
+TimeIndex::Stamps TimeIndex::stampsOf(const Task& task) {
+    const auto& metadata = task.getMetadata();
+    const TaskStatus status = task.getStatus();
+    const bool open = status == TaskStatus::Pending || status == TaskStatus::InProgress;
+
+    Stamps stamps;
+    stamps[static_cast<size_t>(TaskTime::Created)] = timePointToTicks(metadata.created_at);
+    stamps[static_cast<size_t>(TaskTime::Updated)] = timePointToTicks(metadata.updated_at);
+    stamps[static_cast<size_t>(TaskTime::Completed)] =
+        status == TaskStatus::Completed && metadata.completed_at ? timePointToTicks(*metadata.completed_at) : NOT_INDEXED;
+    stamps[static_cast<size_t>(TaskTime::OpenUpdated)] = open ? timePointToTicks(metadata.updated_at) : NOT_INDEXED;
+    return stamps;
+}
+
+void TimeIndex::update(const Task& task) {
+    const int id = task.getId();
+    if (id <= 0) {
+        return;
+    }
+    if (static_cast<size_t>(id) >= _stamps.size()) {
+        Stamps none;
+        none.fill(NOT_INDEXED);
+        _stamps.resize(static_cast<size_t>(id) + 1, none);
+    }
+
+    const Stamps stamps = stampsOf(task);
+    Stamps& filed = _stamps[static_cast<size_t>(id)];
+    for (size_t time = 0; time < TIME_COUNT; ++time) {
+        if (filed[time] == stamps[time]) {
+            continue;
+        }
+        if (filed[time] != NOT_INDEXED) {
+            _runs[time].erase({filed[time], id});
+        }
+        if (stamps[time] != NOT_INDEXED) {
+            _runs[time].insert({stamps[time], id});
+        }
+        filed[time] = stamps[time];
+    }
+}
+
+void TimeIndex::remove(int id) {
+    if (id <= 0 || static_cast<size_t>(id) >= _stamps.size()) {
+        return;
+    }
+    Stamps& filed = _stamps[static_cast<size_t>(id)];
+    for (size_t time = 0; time < TIME_COUNT; ++time) {
+        if (filed[time] != NOT_INDEXED) {
+            _runs[time].erase({filed[time], id});
+            filed[time] = NOT_INDEXED;
+        }
+    }
+}
+
+void TimeIndex::rebuild(std::span<const Task> tasks) {
+    clear();
+    int max_id = 0;
+    for (const Task& task : tasks) {
+        max_id = std::max(max_id, task.getId());
+    }
+    Stamps none;
+    none.fill(NOT_INDEXED);
+    _stamps.assign(static_cast<size_t>(max_id) + 1, none);
+
+    // One sort per run instead of n inserts
+    std::vector<Entry> entries;
+    entries.reserve(tasks.size());
+    for (const Task& task : tasks) {
+        if (task.getId() > 0) {
+            _stamps[static_cast<size_t>(task.getId())] = stampsOf(task);
+        }
+    }
+    for (size_t time = 0; time < TIME_COUNT; ++time) {
+        entries.clear();
+        for (const Task& task : tasks) {
+            if (task.getId() <= 0) continue;
+            std::int64_t ticks = _stamps[static_cast<size_t>(task.getId())][time];
+            if (ticks != NOT_INDEXED) {
+                entries.push_back({ticks, task.getId()});
+            }
+        }
+        // Loaded files are mostly in creation order already
+        if (!std::ranges::is_sorted(entries)) {
+            std::ranges::sort(entries);
+        }
+        _runs[time].assign(entries);
+    }
+}
+
+void TimeIndex::clear() {
+    for (auto& run : _runs) {
+        run.clear();
+    }
+    _stamps.clear();
+}
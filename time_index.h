@@ -0,0 +1,182 @@
+#ifndef TIME_INDEX_H
+#define TIME_INDEX_H
+
+/**
+ * @file time_index.h
+ * @brief Ordered index of task timestamps for age and range queries
+ * @details Each indexed timestamp is kept in a sorted run of (time, id) entries
+ *          split into blocks of at most a few hundred entries, a two-level
+ *          B-tree in effect. Moving an entry costs a binary search over the
+ *          block fronts plus a shift inside one block, and a range query finds
+ *          its first entry in O(log n) and then walks the blocks in order, so
+ *          "created since", "not updated for" and "completed per day" cost
+ *          O(log n + k) instead of a pass over every task. Updates usually
+ *          append: a changed task's updated_at is the newest time there is.
+ */
+
+#include "task.h"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @enum TaskTime
+ * @brief Timestamp a TimeIndex run orders tasks by
+ */
+enum class TaskTime {
+    Created,     ///< created_at of every task
+    Updated,     ///< updated_at of every task
+    Completed,   ///< completed_at of tasks whose status is Completed
+    OpenUpdated  ///< updated_at of tasks that are Pending or InProgress
+};
+
+/**
+ * @class TimeIndex
+ * @brief Tasks ordered by each TaskTime, maintained incrementally
+ * @details The index remembers the timestamps it filed each id under, so
+ *          update() needs only the task after a change
+ */
+class TimeIndex {
+public:
+    static constexpr auto TIME_COUNT = 4uz;  ///< Number of TaskTime values
+
+    /**
+     * @brief One indexed timestamp: ordered by time, then id
+     */
+    struct Entry {
+        std::int64_t ticks = 0;  ///< Nanoseconds since the epoch (timePointToTicks)
+        int id = 0;              ///< Task ID
+
+        friend auto operator<=>(const Entry&, const Entry&) = default;
+    };
+
+    static constexpr auto MIN_TICKS = std::numeric_limits<std::int64_t>::min();
+    static constexpr auto MAX_TICKS = std::numeric_limits<std::int64_t>::max();
+
+private:
+    /**
+     * @class SortedRun
+     * @brief Sorted entries in blocks of BLOCK_SIZE to 2 * BLOCK_SIZE
+     */
+    class SortedRun {
+    private:
+        static constexpr auto BLOCK_SIZE = 256uz;  ///< Block size after a split or rebuild
+
+        std::vector<std::vector<Entry>> _blocks;   ///< Non-empty, in order
+        size_t _size = 0;                          ///< Entries in all blocks
+
+        /**
+         * @brief Index of the block an entry belongs in (the last one starting at or before it)
+         */
+        size_t blockFor(const Entry& entry) const;
+
+        /**
+         * @brief Block and offset of the first entry at or after ticks
+         */
+        std::pair<size_t, size_t> lowerBound(std::int64_t ticks) const;
+
+    public:
+        void insert(const Entry& entry);
+        bool erase(const Entry& entry);
+
+        /**
+         * @brief Replace the contents with sorted entries
+         */
+        void assign(std::span<const Entry> sorted);
+
+        void clear() {
+            _blocks.clear();
+            _size = 0;
+        }
+
+        size_t size() const { return _size; }
+
+        /**
+         * @brief Number of entries with from <= ticks < to
+         * @details O(log n + blocks in the range)
+         */
+        size_t count(std::int64_t from, std::int64_t to) const;
+
+        /**
+         * @brief Call fn(entry) for entries with from <= ticks < to in order until it returns false
+         */
+        template<typename Fn>
+        void forEach(std::int64_t from, std::int64_t to, Fn&& fn) const {
+            for (auto [block, offset] = lowerBound(from); block < _blocks.size(); ++block, offset = 0) {
+                for (size_t i = offset; i < _blocks[block].size(); ++i) {
+                    const Entry& entry = _blocks[block][i];
+                    if (entry.ticks >= to || !fn(entry)) {
+                        return;
+                    }
+                }
+            }
+        }
+    };
+
+    /// Marker for a timestamp that is not indexed (no completion, or not open)
+    static constexpr auto NOT_INDEXED = MIN_TICKS;
+
+    using Stamps = std::array<std::int64_t, TIME_COUNT>;
+
+    std::array<SortedRun, TIME_COUNT> _runs;
+    std::vector<Stamps> _stamps;  ///< Per id: the ticks each run holds for it (NOT_INDEXED if none)
+
+    SortedRun& run(TaskTime time) { return _runs[static_cast<size_t>(time)]; }
+    const SortedRun& run(TaskTime time) const { return _runs[static_cast<size_t>(time)]; }
+
+    /**
+     * @brief Ticks a task is filed under in each run
+     */
+    static Stamps stampsOf(const Task& task);
+
+public:
+    /**
+     * @brief File a new task, or move a changed one to its new positions
+     * @param task Task after the change
+     */
+    void update(const Task& task);
+
+    /**
+     * @brief Drop a task from every run
+     * @param id Task ID
+     */
+    void remove(int id);
+
+    /**
+     * @brief Rebuild every run from scratch
+     * @param tasks All tasks
+     */
+    void rebuild(std::span<const Task> tasks);
+
+    /**
+     * @brief Remove every entry
+     */
+    void clear();
+
+    /**
+     * @brief Number of tasks with a timestamp in [from, to)
+     * @param time Timestamp to look at
+     * @param from First time included (ticks)
+     * @param to First time excluded (ticks)
+     */
+    size_t count(TaskTime time, std::int64_t from = MIN_TICKS, std::int64_t to = MAX_TICKS) const {
+        return run(time).count(from, to);
+    }
+
+    /**
+     * @brief Visit tasks with a timestamp in [from, to), oldest first
+     * @param time Timestamp to look at
+     * @param from First time included (ticks)
+     * @param to First time excluded (ticks)
+     * @param fn Called with each Entry; returning false stops the walk
+     */
+    template<typename Fn>
+    void forEach(TaskTime time, std::int64_t from, std::int64_t to, Fn&& fn) const {
+        run(time).forEach(from, to, fn);
+    }
+};
+
+#endif // TIME_INDEX_H
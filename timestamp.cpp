@@ -0,0 +1,198 @@
+/**
+ * @file timestamp.cpp
+ * @brief Implementation of the ISO 8601 timestamp codec
+ */
+
+#include "timestamp.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+using namespace std::chrono;
+
+/**
+ * @brief Write value as exactly `width` decimal digits
+ */
+char* writeDigits(char* out, unsigned value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return out + width;
+}
+
+/**
+ * @brief Read exactly `width` decimal digits starting at pos
+ * @return false if any of them is not a digit or the text is too short
+ */
+bool readDigits(std::string_view text, size_t& pos, int width, int& value) {
+    if (text.size() - pos < static_cast<size_t>(width)) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < width; ++i, ++pos) {
+        char c = text[pos];
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+bool consume(std::string_view text, size_t& pos, char c) {
+    if (pos < text.size() && text[pos] == c) {
+        ++pos;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Zone used for timestamps without a designator
+ * @details Looked up once; the tz database is immutable afterwards, so
+ *          converting through it needs no locking. Falls back to UTC when no
+ *          database is available.
+ */
+const time_zone* localZone() {
+    static const time_zone* const zone = []() -> const time_zone* {
+        try {
+            return current_zone();
+        } catch (const std::runtime_error&) {
+            return nullptr;
+        }
+    }();
+    return zone;
+}
+
+} // namespace
+
+char* formatIsoTimestamp(char* out, system_clock::time_point tp) {
+    static constexpr sys_days first_day = year{0} / January / 1;
+    static constexpr sys_days last_day = year{9999} / December / 31;
+    auto ms = floor<milliseconds>(tp);
+    ms = std::clamp(ms, time_point_cast<milliseconds>(first_day),
+                    time_point_cast<milliseconds>(last_day + days{1}) - milliseconds{1});
+
+    sys_days day = floor<days>(ms);
+    year_month_day date{day};
+    hh_mm_ss time{ms - day};
+
+    out = writeDigits(out, static_cast<unsigned>(static_cast<int>(date.year())), 4);
+    *out++ = '-';
+    out = writeDigits(out, static_cast<unsigned>(date.month()), 2);
+    *out++ = '-';
+    out = writeDigits(out, static_cast<unsigned>(date.day()), 2);
+    *out++ = 'T';
+    out = writeDigits(out, static_cast<unsigned>(time.hours().count()), 2);
+    *out++ = ':';
+    out = writeDigits(out, static_cast<unsigned>(time.minutes().count()), 2);
+    *out++ = ':';
+    out = writeDigits(out, static_cast<unsigned>(time.seconds().count()), 2);
+    *out++ = '.';
+    out = writeDigits(out, static_cast<unsigned>(time.subseconds().count()), 3);
+    *out++ = 'Z';
+    return out;
+}
+
+void appendIsoTimestamp(std::string& out, system_clock::time_point tp) {
+    size_t old_size = out.size();
+    out.resize(old_size + ISO_TIMESTAMP_SIZE);
+    formatIsoTimestamp(out.data() + old_size, tp);
+}
+
+std::optional<system_clock::time_point> parseIsoTimestamp(std::string_view text) {
+    size_t pos = 0;
+    int y, mo, d, h, mi, s;
+    if (!readDigits(text, pos, 4, y) || !consume(text, pos, '-') ||
+        !readDigits(text, pos, 2, mo) || !consume(text, pos, '-') ||
+        !readDigits(text, pos, 2, d)) {
+        return std::nullopt;
+    }
+    if (!consume(text, pos, 'T') && !consume(text, pos, 't') && !consume(text, pos, ' ')) {
+        return std::nullopt;
+    }
+    if (!readDigits(text, pos, 2, h) || !consume(text, pos, ':') ||
+        !readDigits(text, pos, 2, mi) || !consume(text, pos, ':') ||
+        !readDigits(text, pos, 2, s)) {
+        return std::nullopt;
+    }
+
+    year_month_day date{year{y}, month{static_cast<unsigned>(mo)}, day{static_cast<unsigned>(d)}};
+    if (!date.ok() || h > 23 || mi > 59 || s > 60) { // 60: leap second
+        return std::nullopt;
+    }
+
+    nanoseconds fraction{0};
+    if (consume(text, pos, '.') || consume(text, pos, ',')) {
+        int digits = 0;
+        int64_t value = 0;
+        for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++digits) {
+            if (digits < 9) value = value * 10 + (text[pos] - '0'); // Finer digits are dropped
+        }
+        if (digits == 0) return std::nullopt;
+        for (int i = std::min(digits, 9); i < 9; ++i) value *= 10;
+        fraction = nanoseconds{value};
+    }
+
+    auto since_midnight = hours{h} + minutes{mi} + seconds{s} + fraction;
+
+    if (pos == text.size()) {
+        // No designator: local time, as written by earlier versions
+        local_time<nanoseconds> local{local_days{date}.time_since_epoch() + since_midnight};
+        sys_time<nanoseconds> utc = localZone()
+            ? localZone()->to_sys(local, choose::earliest)
+            : sys_time<nanoseconds>{local.time_since_epoch()};
+        return time_point_cast<system_clock::duration>(utc);
+    }
+
+    minutes offset{0};
+    if (consume(text, pos, 'Z') || consume(text, pos, 'z')) {
+        // UTC
+    } else if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+        bool negative = text[pos++] == '-';
+        int oh, om = 0;
+        if (!readDigits(text, pos, 2, oh)) return std::nullopt;
+        if (pos < text.size()) {
+            consume(text, pos, ':');
+            if (!readDigits(text, pos, 2, om)) return std::nullopt;
+        }
+        if (oh > 23 || om > 59) return std::nullopt;
+        offset = hours{oh} + minutes{om};
+        if (negative) offset = -offset;
+    } else {
+        return std::nullopt;
+    }
+    if (pos != text.size()) {
+        return std::nullopt;
+    }
+
+    // The local wall time minus its offset from UTC
+    sys_time<nanoseconds> utc{sys_days{date}.time_since_epoch() + since_midnight - offset};
+    return time_point_cast<system_clock::duration>(utc);
+}
+
+std::optional<std::chrono::seconds> parseDuration(std::string_view text) {
+    if (text.size() < 2) {
+        return std::nullopt;
+    }
+    std::int64_t unit = 0;
+    switch (text.back()) {
+        case 's': unit = 1; break;
+        case 'm': unit = 60; break;
+        case 'h': unit = 3600; break;
+        case 'd': unit = 86400; break;
+        case 'w': unit = 7 * 86400; break;
+        default: return std::nullopt;
+    }
+    std::string_view digits = text.substr(0, text.size() - 1);
+    std::int64_t count = 0;
+    auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), count);
+    // Bounded to about 290 years so the result still fits a nanosecond time point
+    if (ec != std::errc{} || ptr != digits.data() + digits.size() || count < 0 ||
+        count > 9'000'000'000 / unit) {
+        return std::nullopt;
+    }
+    return std::chrono::seconds(count * unit);
+}
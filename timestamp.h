@@ -0,0 +1,61 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+/**
+ * @file timestamp.h
+ * @brief Fixed-format ISO 8601 timestamp codec
+ * @details Task documents carry three timestamps per task. Formatting and
+ *          parsing them by hand with chrono calendar arithmetic avoids
+ *          iostreams, the C locale and the global timezone state behind
+ *          localtime/mktime, so both directions are allocation-free and safe
+ *          to call from several threads at once. Timestamps are written in UTC
+ *          with a 'Z' suffix; parsing accepts 'Z', a numeric offset, or no
+ *          designator for files written by older versions in local time.
+ */
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Length of a formatted timestamp, "YYYY-MM-DDTHH:MM:SS.mmmZ"
+ */
+inline constexpr size_t ISO_TIMESTAMP_SIZE = 24uz;
+
+/**
+ * @brief Write a timestamp as UTC ISO 8601 with millisecond precision
+ * @details Times outside years 0000-9999 are clamped to that range
+ * @param out Destination with room for ISO_TIMESTAMP_SIZE characters
+ * @param tp Time point to format
+ * @return Pointer one past the last character written
+ */
+char* formatIsoTimestamp(char* out, std::chrono::system_clock::time_point tp);
+
+/**
+ * @brief Append a formatted timestamp to a buffer
+ * @param out Destination buffer
+ * @param tp Time point to format
+ */
+void appendIsoTimestamp(std::string& out, std::chrono::system_clock::time_point tp);
+
+/**
+ * @brief Parse an ISO 8601 timestamp
+ * @details Accepts "YYYY-MM-DD[T ]HH:MM:SS", an optional fraction of up to nine
+ *          digits after '.' or ',', and an optional zone: 'Z', "+hh:mm", "+hhmm"
+ *          or "+hh". Without a zone the time is taken as local time, which is
+ *          how timestamps were written before they carried one.
+ * @param text Timestamp text; nothing may follow it
+ * @return Time point, or std::nullopt if the text is malformed or out of range
+ */
+std::optional<std::chrono::system_clock::time_point> parseIsoTimestamp(std::string_view text);
+
+/**
+ * @brief Parse a duration written as a count and a unit, e.g. "72h"
+ * @details Units: s (seconds), m (minutes), h (hours), d (days), w (weeks)
+ * @param text Duration text; nothing may follow the unit
+ * @return Duration, or std::nullopt if the text is malformed or too large
+ */
+std::optional<std::chrono::seconds> parseDuration(std::string_view text);
+
+#endif // TIMESTAMP_H